@@ -0,0 +1,230 @@
+/**
+ * @brief A bounded lock-free multi-producer multi-consumer queue
+ *
+ * Dmitry Vyukov 的有界 MPMC 环形队列:
+ *  - 每个槽位带一个序号 seq，生产者 / 消费者各自 CAS 抢占位置后，
+ *    通过 seq 判断槽位是否可写 / 可读，无锁且 FIFO
+ *  - 槽位按缓存行对齐，相邻槽位的读写不会互相伪共享
+ *  - 生产位置与消费位置位于不同缓存行
+ *  - 阻塞版本 push / pop 先自旋，仍未成功再通过 EventCount 在 futex 上休眠，
+ *    无等待者时不会进入内核
+ *
+ * @usage
+    Lute::MPMCQueue<int> que(1024);
+    std::thread tproducer([&]() {
+        for (int i = 0; i < 100; ++i) {
+            que.push(i);
+        }
+    });
+    std::thread tconsumer([&]() {
+        for (int i = 0; i < 100; ++i) {
+            que.pop();
+        }
+    });
+
+    tproducer.join();
+    tconsumer.join();
+ */
+
+#pragma once
+
+#include <Base/atomic.h>  // LUTE_CACHELINE_SIZE, cpuRelax
+#include <Base/futex.h>   // EventCount
+
+#include <atomic>       // atomic
+#include <cstddef>      // size_t
+#include <cstdint>      // intptr_t
+#include <memory>       // unique_ptr
+#include <new>          // placement new
+#include <type_traits>  // aligned_storage
+#include <utility>      // move, forward
+
+namespace Lute {
+/**
+ * @brief A bounded lock-free MPMC queue
+ *
+ * @tparam T The type of the elements
+ * @note T 的构造函数不应抛出异常: 槽位在构造元素之前已经被占用
+ */
+template <typename T>
+class MPMCQueue {
+public:
+    ///
+    /// @param capacity 队列容量，向上取整为 2 的幂 (至少为 2)
+    ///
+    explicit MPMCQueue(size_t capacity)
+        : mask_(roundUpPowerOfTwo(capacity) - 1),
+          slots_(new Slot[mask_ + 1]),
+          enqueuePos_(0),
+          dequeuePos_(0) {
+        for (size_t i = 0; i <= mask_; ++i) {
+            slots_[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~MPMCQueue() {
+        size_t deq = dequeuePos_.load(std::memory_order_relaxed);
+        size_t enq = enqueuePos_.load(std::memory_order_relaxed);
+        for (size_t pos = deq; pos != enq; ++pos) {
+            slots_[pos & mask_].elem()->~T();
+        }
+    }
+
+    /// non-copyable
+    MPMCQueue(const MPMCQueue&) = delete;
+    MPMCQueue& operator=(const MPMCQueue&) = delete;
+
+    ///
+    /// @brief 非阻塞入队
+    /// @return 队列已满时返回 false
+    ///
+    template <typename... Args>
+    bool tryEmplace(Args&&... args) {
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots_[pos & mask_];
+            size_t seq = slot->seq.load(std::memory_order_acquire);
+            auto diff =
+                static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                // 槽位空闲，尝试占用
+                if (enqueuePos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // 槽位上一轮的元素尚未被取走: 队列已满
+                return false;
+            } else {
+                // 其他生产者已经占用了该位置
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        new (&slot->storage) T(std::forward<Args>(args)...);
+        slot->seq.store(pos + 1, std::memory_order_release);
+        notEmpty_.notify();
+        return true;
+    }
+
+    bool tryPush(const T& val) { return tryEmplace(val); }
+    bool tryPush(T&& val) { return tryEmplace(std::move(val)); }
+
+    ///
+    /// @brief 非阻塞出队
+    /// @return 队列为空时返回 false
+    ///
+    bool tryPop(T& val) {
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots_[pos & mask_];
+            size_t seq = slot->seq.load(std::memory_order_acquire);
+            auto diff =
+                static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // 槽位尚未写入: 队列为空
+                return false;
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+        T* elem = slot->elem();
+        val = std::move(*elem);
+        elem->~T();
+        // 槽位留给下一轮 (pos + capacity) 的生产者
+        slot->seq.store(pos + mask_ + 1, std::memory_order_release);
+        notFull_.notify();
+        return true;
+    }
+
+    ///
+    /// @brief 阻塞入队，队列满时先自旋，再休眠等待
+    ///
+    void push(const T& val) { blockingPush(val); }
+    void push(T&& val) { blockingPush(std::move(val)); }
+
+    ///
+    /// @brief 阻塞出队，队列空时先自旋，再休眠等待
+    ///
+    void pop(T& val) {
+        for (int i = 0; i < kSpinCount; ++i) {
+            if (tryPop(val)) return;
+            cpuRelax();
+        }
+        for (;;) {
+            uint32_t key = notEmpty_.prepareWait();
+            if (tryPop(val)) {
+                notEmpty_.cancelWait();
+                return;
+            }
+            notEmpty_.wait(key);
+        }
+    }
+
+    T pop() {
+        T val;
+        pop(val);
+        return val;
+    }
+
+    size_t capacity() const { return mask_ + 1; }
+
+    ///
+    /// @brief 当前元素个数的近似值，并发修改时仅供参考
+    ///
+    size_t sizeGuess() const {
+        size_t enq = enqueuePos_.load(std::memory_order_relaxed);
+        size_t deq = dequeuePos_.load(std::memory_order_relaxed);
+        return enq > deq ? enq - deq : 0;
+    }
+
+    bool empty() const { return sizeGuess() == 0; }
+
+private:
+    /// 自旋次数，超过后在 futex 上休眠
+    static constexpr int kSpinCount = 128;
+
+    struct alignas(LUTE_CACHELINE_SIZE) Slot {
+        std::atomic<size_t> seq;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+        T* elem() { return reinterpret_cast<T*>(&storage); }
+    };
+
+    static size_t roundUpPowerOfTwo(size_t n) {
+        size_t cap = 2;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+
+    template <typename U>
+    void blockingPush(U&& val) {
+        for (int i = 0; i < kSpinCount; ++i) {
+            if (tryEmplace(std::forward<U>(val))) return;
+            cpuRelax();
+        }
+        for (;;) {
+            uint32_t key = notFull_.prepareWait();
+            if (tryEmplace(std::forward<U>(val))) {
+                notFull_.cancelWait();
+                return;
+            }
+            notFull_.wait(key);
+        }
+    }
+
+    const size_t mask_;
+    const std::unique_ptr<Slot[]> slots_;
+    /// 生产者与消费者的位置分别独占缓存行
+    alignas(LUTE_CACHELINE_SIZE) std::atomic<size_t> enqueuePos_;
+    alignas(LUTE_CACHELINE_SIZE) std::atomic<size_t> dequeuePos_;
+    alignas(LUTE_CACHELINE_SIZE) EventCount notEmpty_;
+    alignas(LUTE_CACHELINE_SIZE) EventCount notFull_;
+};
+}  // namespace Lute
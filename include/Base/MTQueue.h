@@ -1,5 +1,14 @@
 /**
  * @brief A thread-safe queue
+ *
+ *  - pop() / popHead() 从尾部取出元素 (后进先出)
+ *  - popAll() / popUpTo(n) 在一次加锁中按入队顺序批量取出，摊薄加锁开销；
+ *    popUpTo 只移动被取出的 n 个元素，队首已取出的空位在超过剩余元素数
+ *    时才统一压缩，均摊 O(n)
+ *  - tryPop() 不阻塞，popFor() 限时等待
+ *  - close() 之后拒绝入队并唤醒全部等待者，消费者可以继续取完剩余元素，
+ *    队列为空后 pop(T&) 返回 false
+ *
  * @usage
     Lute::MTQueue<int> que;
     std::thread tproducer([]() {
@@ -19,8 +28,13 @@
 
 #pragma once
 
+#include <algorithm>  // min
+#include <chrono>     // duration
 #include <condition_variable>
+#include <cstddef>    // ptrdiff_t
+#include <iterator>   // make_move_iterator
 #include <mutex>
+#include <stdexcept>  // runtime_error
 #include <vector>
 
 namespace Lute {
@@ -32,22 +46,149 @@ namespace Lute {
 template <typename T>
 class MTQueue {
     std::condition_variable cv_;
-    std::mutex mtx_;
+    mutable std::mutex mtx_;
+    /// 有效元素为 [head_, queue_.size())，之前是 popUpTo 取走后留下的空位
     std::vector<T> queue_;
+    size_t head_ = 0;
+    bool closed_ = false;
+
+    bool hasItems() const { return queue_.size() > head_; }
+
+    /// @brief 取出最后一个元素，队列变空时回收队首空位
+    T takeBack() {
+        T ret = std::move(queue_.back());
+        queue_.pop_back();
+        if (queue_.size() == head_) {
+            queue_.clear();
+            head_ = 0;
+        }
+        return ret;
+    }
+
+    /// @brief 按入队顺序取出全部元素，没有空位时直接交换
+    std::vector<T> takeAll() {
+        std::vector<T> ret;
+        if (head_ == 0) {
+            ret.swap(queue_);
+        } else {
+            auto first = queue_.begin() + static_cast<std::ptrdiff_t>(head_);
+            ret.assign(std::make_move_iterator(first),
+                       std::make_move_iterator(queue_.end()));
+            queue_.clear();
+            head_ = 0;
+        }
+        return ret;
+    }
 
 public:
+    ///
+    /// @brief 阻塞取出一个元素
+    /// @exception std::runtime_error when 队列已关闭且为空
+    ///
     T pop() {
-#if __plusplus >= 201703L
-        std::unique_lock lock(mtx_);
-#else
         std::unique_lock<std::mutex> lock(mtx_);
-#endif
-        cv_.wait(lock, [this] { return !queue_.empty(); });
-        T ret = std::move(queue_.back());
-        queue_.pop_back();
+        cv_.wait(lock, [this] { return hasItems() || closed_; });
+        if (!hasItems()) throw std::runtime_error("pop from closed MTQueue");
+        return takeBack();
+    }
+
+    ///
+    /// @brief 阻塞取出一个元素
+    /// @return 队列已关闭且为空时返回 false
+    ///
+    bool pop(T& val) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        cv_.wait(lock, [this] { return hasItems() || closed_; });
+        if (!hasItems()) return false;
+        val = takeBack();
+        return true;
+    }
+
+    ///
+    /// @brief 非阻塞取出一个元素
+    /// @return 队列为空时返回 false
+    ///
+    bool tryPop(T& val) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (!hasItems()) return false;
+        val = takeBack();
+        return true;
+    }
+
+    ///
+    /// @brief 最多等待 timeout 取出一个元素
+    /// @return 超时或队列已关闭且为空时返回 false
+    ///
+    template <typename Rep, typename Period>
+    bool popFor(T& val, const std::chrono::duration<Rep, Period>& timeout) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (!cv_.wait_for(lock, timeout,
+                          [this] { return hasItems() || closed_; })) {
+            return false;
+        }
+        if (!hasItems()) return false;
+        val = takeBack();
+        return true;
+    }
+
+    ///
+    /// @brief 阻塞直到队列非空 (或已关闭)，一次取出全部元素 (按入队顺序)
+    /// @return 队列已关闭且为空时返回空数组
+    ///
+    std::vector<T> popAll() {
+        std::unique_lock<std::mutex> lock(mtx_);
+        cv_.wait(lock, [this] { return hasItems() || closed_; });
+        return takeAll();
+    }
+
+    ///
+    /// @brief 阻塞直到队列非空 (或已关闭)，一次取出最早入队的至多 n 个元素
+    /// @return 队列已关闭且为空时返回空数组
+    ///
+    std::vector<T> popUpTo(size_t n) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        cv_.wait(lock, [this] { return hasItems() || closed_; });
+        if (n >= queue_.size() - head_) return takeAll();
+
+        auto first = queue_.begin() + static_cast<std::ptrdiff_t>(head_);
+        std::vector<T> ret(std::make_move_iterator(first),
+                           std::make_move_iterator(first + n));
+        head_ += n;
+        if (head_ > queue_.size() - head_) {
+            queue_.erase(queue_.begin(),
+                         queue_.begin() + static_cast<std::ptrdiff_t>(head_));
+            head_ = 0;
+        }
         return ret;
     }
 
+    ///
+    /// @brief 关闭队列: 之后的 push 返回 false，唤醒全部等待中的消费者
+    ///
+    void close() {
+        {
+            std::unique_lock<std::mutex> lock(mtx_);
+            closed_ = true;
+        }
+        cv_.notify_all();
+    }
+
+    bool closed() const {
+        std::unique_lock<std::mutex> lock(mtx_);
+        return closed_;
+    }
+
+    size_t size() const {
+        std::unique_lock<std::mutex> lock(mtx_);
+        return queue_.size() - head_;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    ///
+    /// @brief 阻塞取出一个元素，同时返回仍持有的锁
+    /// @exception std::runtime_error when 队列已关闭且为空
+    ///
 #if __cplusplus >= 201703L
     auto popHead() {
         std::unique_lock lock(mtx_);
@@ -55,9 +196,9 @@ public:
     auto popHead() -> std::pair<T, std::unique_lock<std::mutex> > {
         std::unique_lock<std::mutex> lock(mtx_);
 #endif
-        cv_.wait(lock, [this] { return !queue_.empty(); });
-        T ret = std::move(queue_.back());
-        queue_.pop_back();
+        cv_.wait(lock, [this] { return hasItems() || closed_; });
+        if (!hasItems()) throw std::runtime_error("pop from closed MTQueue");
+        T ret = takeBack();
 #if __cplusplus >= 201703L
         return std::pair(std::move(ret), std::move(lock));
 #else
@@ -66,28 +207,39 @@ public:
 #endif
     }
 
-    void push(T val) {
+    ///
+    /// @return 队列已关闭时返回 false
+    ///
+    bool push(T val) {
 #if __cplusplus >= 201703L
         std::unique_lock lock(mtx_);
 #else
         std::unique_lock<std::mutex> lock(mtx_);
 #endif
+        if (closed_) return false;
         queue_.push_back(std::move(val));
         cv_.notify_one();
+        return true;
     }
 
-    void pushMany(std::initializer_list<T> vals) {
+    ///
+    /// @return 队列已关闭时返回 false
+    ///
+    bool pushMany(std::initializer_list<T> vals) {
 #if __cplusplus >= 201703L
         std::unique_lock lock(mtx_);
+        if (closed_) return false;
         std::copy(std::move_iterator(vals.begin()),
                   std::move_iterator(vals.end()), std::back_inserter(queue_));
 #else
         std::unique_lock<std::mutex> lock(mtx_);
+        if (closed_) return false;
         std::copy(std::move_iterator<decltype(vals.begin())>(vals.begin()),
                   std::move_iterator<decltype(vals.end())>(vals.end()),
                   std::back_inserter(queue_));
 #endif
         cv_.notify_all();
+        return true;
     }
 };
 }  // namespace Lute
@@ -0,0 +1,264 @@
+/**
+ * @brief A bounded wait-free single-producer single-consumer queue
+ *
+ *  - 只有一个生产者线程调用 push 系列接口，一个消费者线程调用 pop 系列接口
+ *  - 生产者 / 消费者各自维护对方位置的缓存副本，只有缓存显示队列满 / 空时
+ *    才去读取对方的位置，减少缓存行在两个核之间的来回迁移
+ *  - 生产者的位置与消费者的位置位于不同缓存行
+ *  - pushMany / popMany 一次发布一批元素，只需一次 release store
+ *  - Blocking = true 时提供阻塞的 push / pop: 先自旋，再通过 EventCount 在
+ *    futex 上休眠；Blocking = false 时快路径上没有任何通知开销
+ *
+ * @usage
+    Lute::SPSCQueue<int, true> que(1024);
+    std::thread tproducer([&]() {
+        for (int i = 0; i < 100; ++i) {
+            que.push(i);
+        }
+    });
+    std::thread tconsumer([&]() {
+        int buf[16];
+        for (int n = 0; n < 100;) {
+            n += que.popMany(buf, 16);
+        }
+    });
+
+    tproducer.join();
+    tconsumer.join();
+ */
+
+#pragma once
+
+#include <Base/atomic.h>  // LUTE_CACHELINE_SIZE, cpuRelax
+#include <Base/futex.h>   // EventCount
+
+#include <algorithm>    // min
+#include <atomic>       // atomic
+#include <cstddef>      // size_t
+#include <memory>       // unique_ptr
+#include <new>          // placement new
+#include <type_traits>  // aligned_storage
+#include <utility>      // move, forward
+
+namespace Lute {
+/**
+ * @brief A bounded wait-free SPSC queue
+ *
+ * @tparam T The type of the elements
+ * @tparam Blocking 是否提供阻塞的 push / pop
+ */
+template <typename T, bool Blocking = false>
+class SPSCQueue {
+public:
+    ///
+    /// @param capacity 队列容量，向上取整为 2 的幂 (至少为 2)
+    ///
+    explicit SPSCQueue(size_t capacity)
+        : mask_(roundUpPowerOfTwo(capacity) - 1),
+          buffer_(new Storage[mask_ + 1]),
+          tail_(0),
+          cachedHead_(0),
+          head_(0),
+          cachedTail_(0) {}
+
+    ~SPSCQueue() {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        for (; head != tail; ++head) elem(head)->~T();
+    }
+
+    /// non-copyable
+    SPSCQueue(const SPSCQueue&) = delete;
+    SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+    /// NOTE ----------- 生产者接口 -----------
+
+    ///
+    /// @brief 非阻塞入队
+    /// @return 队列已满时返回 false
+    ///
+    template <typename... Args>
+    bool tryEmplace(Args&&... args) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (writable(tail) == 0) return false;
+        new (elem(tail)) T(std::forward<Args>(args)...);
+        publish(tail + 1);
+        return true;
+    }
+
+    bool tryPush(const T& val) { return tryEmplace(val); }
+    bool tryPush(T&& val) { return tryEmplace(std::move(val)); }
+
+    ///
+    /// @brief 从 first 开始最多入队 count 个元素，整批只发布一次
+    /// @return 实际入队的元素个数，队列满时可能小于 count
+    /// @note 需要移动元素时传入 std::make_move_iterator
+    ///
+    template <typename InputIt>
+    size_t pushMany(InputIt first, size_t count) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        size_t n = std::min(count, writable(tail));
+        for (size_t i = 0; i < n; ++i, ++first) {
+            new (elem(tail + i)) T(*first);
+        }
+        if (n > 0) publish(tail + n);
+        return n;
+    }
+
+    ///
+    /// @brief 阻塞入队，队列满时先自旋，再休眠等待
+    ///
+    void push(const T& val) { blockingPush(val); }
+    void push(T&& val) { blockingPush(std::move(val)); }
+
+    /// NOTE ----------- 消费者接口 -----------
+
+    ///
+    /// @brief 非阻塞出队
+    /// @return 队列为空时返回 false
+    ///
+    bool tryPop(T& val) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (readable(head) == 0) return false;
+        T* e = elem(head);
+        val = std::move(*e);
+        e->~T();
+        consume(head + 1);
+        return true;
+    }
+
+    ///
+    /// @brief 最多出队 maxCount 个元素，依次移动到 out，整批只释放一次
+    /// @return 实际出队的元素个数
+    ///
+    template <typename OutputIt>
+    size_t popMany(OutputIt out, size_t maxCount) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        size_t n = std::min(maxCount, readable(head));
+        for (size_t i = 0; i < n; ++i, ++out) {
+            T* e = elem(head + i);
+            *out = std::move(*e);
+            e->~T();
+        }
+        if (n > 0) consume(head + n);
+        return n;
+    }
+
+    ///
+    /// @brief 阻塞出队，队列空时先自旋，再休眠等待
+    ///
+    void pop(T& val) {
+        static_assert(Blocking, "use SPSCQueue<T, true> for blocking pop");
+        for (int i = 0; i < kSpinCount; ++i) {
+            if (tryPop(val)) return;
+            cpuRelax();
+        }
+        for (;;) {
+            uint32_t key = notEmpty_.prepareWait();
+            if (tryPop(val)) {
+                notEmpty_.cancelWait();
+                return;
+            }
+            notEmpty_.wait(key);
+        }
+    }
+
+    T pop() {
+        T val;
+        pop(val);
+        return val;
+    }
+
+    /// NOTE ----------- 任意线程 -----------
+
+    size_t capacity() const { return mask_ + 1; }
+
+    ///
+    /// @brief 当前元素个数的近似值，并发修改时仅供参考
+    ///
+    size_t sizeGuess() const {
+        size_t head = head_.load(std::memory_order_acquire);
+        size_t tail = tail_.load(std::memory_order_acquire);
+        return tail - head;
+    }
+
+    bool empty() const { return sizeGuess() == 0; }
+
+private:
+    /// 自旋次数，超过后在 futex 上休眠
+    static constexpr int kSpinCount = 128;
+
+    using Storage = typename std::aligned_storage<sizeof(T), alignof(T)>::type;
+
+    static size_t roundUpPowerOfTwo(size_t n) {
+        size_t cap = 2;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+
+    T* elem(size_t pos) {
+        return reinterpret_cast<T*>(&buffer_[pos & mask_]);
+    }
+
+    /// @brief 生产者: 可写的槽位数，缓存显示已满时才读取 head_
+    size_t writable(size_t tail) {
+        size_t free = capacity() - (tail - cachedHead_);
+        if (free == 0) {
+            cachedHead_ = head_.load(std::memory_order_acquire);
+            free = capacity() - (tail - cachedHead_);
+        }
+        return free;
+    }
+
+    /// @brief 消费者: 可读的元素数，缓存显示为空时才读取 tail_
+    size_t readable(size_t head) {
+        size_t avail = cachedTail_ - head;
+        if (avail == 0) {
+            cachedTail_ = tail_.load(std::memory_order_acquire);
+            avail = cachedTail_ - head;
+        }
+        return avail;
+    }
+
+    void publish(size_t tail) {
+        tail_.store(tail, std::memory_order_release);
+        if constexpr (Blocking) notEmpty_.notify();
+    }
+
+    void consume(size_t head) {
+        head_.store(head, std::memory_order_release);
+        if constexpr (Blocking) notFull_.notify();
+    }
+
+    template <typename U>
+    void blockingPush(U&& val) {
+        static_assert(Blocking, "use SPSCQueue<T, true> for blocking push");
+        for (int i = 0; i < kSpinCount; ++i) {
+            if (tryEmplace(std::forward<U>(val))) return;
+            cpuRelax();
+        }
+        for (;;) {
+            uint32_t key = notFull_.prepareWait();
+            if (tryEmplace(std::forward<U>(val))) {
+                notFull_.cancelWait();
+                return;
+            }
+            notFull_.wait(key);
+        }
+    }
+
+    const size_t mask_;
+    const std::unique_ptr<Storage[]> buffer_;
+
+    /// 生产者独占的缓存行
+    alignas(LUTE_CACHELINE_SIZE) std::atomic<size_t> tail_;
+    size_t cachedHead_;
+
+    /// 消费者独占的缓存行
+    alignas(LUTE_CACHELINE_SIZE) std::atomic<size_t> head_;
+    size_t cachedTail_;
+
+    alignas(LUTE_CACHELINE_SIZE) EventCount notEmpty_;
+    alignas(LUTE_CACHELINE_SIZE) EventCount notFull_;
+};
+}  // namespace Lute
@@ -8,7 +8,17 @@
 
 #pragma once
 
+#include <atomic>   // atomic, memory_order
+#include <cstddef>  // size_t
 #include <cstdint>  // int32_t int64_t
+#include <memory>   // unique_ptr
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>  // _mm_pause
+#endif
+
+/// @brief 缓存行大小，用于避免不同线程频繁写入的变量之间的伪共享 (false sharing)
+#define LUTE_CACHELINE_SIZE 64
 
 /**
   GCC 4.1.2版本之后，对X86或X86_64支持内置原子操作。
@@ -55,57 +65,98 @@
   后面的可扩展参数(…)用来指出哪些变量需要memory barrier，
   因为目前gcc实现的是full barrier(类似Linuxkernel中的mb()，
   表示这个操作之前的所有内存操作不会被重排到这个操作之后)，所以可以忽略掉这个参数。
+
+  __sync 系列没有单纯的读操作，读取也只能用一次带 lock 前缀的 CAS，
+  且每个操作都是 full barrier。AtomicIntegerT 因此基于 std::atomic 实现，
+  由调用者按需指定内存序。
  */
 
 namespace Lute {
+///
+/// @brief 自旋等待时调用，提示 CPU 当前处于忙等 (x86 pause 指令)，
+///        降低功耗并让出超线程的执行资源
+///
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#endif
+}
+
 namespace detail {
+    ///
+    /// @brief 整数原子变量，每个操作都可以指定内存序
+    ///
+    /// 默认内存序: get() 为 acquire，set() 为 release，读-改-写操作为
+    /// seq_cst。统计计数等不需要同步其他内存的场景传入
+    /// std::memory_order_relaxed，x86 上读操作只是一条普通的 mov。
+    ///
     template <typename T>
     class AtomicIntegerT {
     private:
-        volatile T value_;
+        std::atomic<T> value_;
 
         AtomicIntegerT(const AtomicIntegerT&) = delete;
         AtomicIntegerT& operator=(AtomicIntegerT&) = delete;
 
     public:
-        AtomicIntegerT() : value_(0) {}
-
-        /// uncomment if you need copying and assignment
-        // AtomicIntegerT(const AtomicIntegerT& that) : value_(that.get()) {}
-        // AtomicIntegerT& operator=(const AtomicIntegerT& that) {
-        //     getAndSet(that.get());
-        //     return *this;
-        // }
-
-        /// @brief CAS compare and swap
-        /// @return
-        T get() {
-            // in gcc >= 4.7: __atomic_load_n(&value_, __ATOMIC_SEQ_CST)
-            return __sync_val_compare_and_swap(&value_, 0, 0);
+        explicit AtomicIntegerT(T value = 0) : value_(value) {}
+
+        T get(std::memory_order order = std::memory_order_acquire) const {
+            return value_.load(order);
+        }
+
+        void set(T newValue,
+                 std::memory_order order = std::memory_order_release) {
+            value_.store(newValue, order);
+        }
+
+        T getAndAdd(T x,
+                    std::memory_order order = std::memory_order_seq_cst) {
+            return value_.fetch_add(x, order);
         }
 
-        T getAndAdd(T x) {
-            // in gcc >= 4.7: __atomic_fetch_add(&value_, x,
-            // __ATOMIC_SEQ_CST)
-            return __sync_fetch_and_add(&value_, x);
+        T addAndGet(T x,
+                    std::memory_order order = std::memory_order_seq_cst) {
+            return getAndAdd(x, order) + x;
         }
 
-        T addAndGet(T x) { return getAndAdd(x) + x; }
+        T incrementAndGet(
+            std::memory_order order = std::memory_order_seq_cst) {
+            return addAndGet(1, order);
+        }
 
-        T incrementAndGet() { return addAndGet(1); }
+        T decrementAndGet(
+            std::memory_order order = std::memory_order_seq_cst) {
+            return addAndGet(-1, order);
+        }
 
-        T decrementAndGet() { return addAndGet(-1); }
+        void add(T x, std::memory_order order = std::memory_order_seq_cst) {
+            getAndAdd(x, order);
+        }
 
-        void add(T x) { getAndAdd(x); }
+        void increment(std::memory_order order = std::memory_order_seq_cst) {
+            add(1, order);
+        }
 
-        void increment() { incrementAndGet(); }
+        void decrement(std::memory_order order = std::memory_order_seq_cst) {
+            add(-1, order);
+        }
 
-        void decrement() { decrementAndGet(); }
+        T getAndSet(T newValue,
+                    std::memory_order order = std::memory_order_seq_cst) {
+            return value_.exchange(newValue, order);
+        }
 
-        T getAndSet(T newValue) {
-            // in gcc >= 4.7: __atomic_exchange_n(&value_, newValue,
-            // __ATOMIC_SEQ_CST)
-            return __sync_lock_test_and_set(&value_, newValue);
+        ///
+        /// @brief value_ == expected 时更新为 newValue 并返回 true；
+        ///        否则将 expected 更新为当前值并返回 false
+        ///
+        bool compareAndSet(
+            T& expected, T newValue,
+            std::memory_order order = std::memory_order_seq_cst) {
+            return value_.compare_exchange_strong(expected, newValue, order);
         }
     };
 }  // namespace detail
@@ -113,4 +164,60 @@ namespace detail {
 typedef detail::AtomicIntegerT<int32_t> AtomicInt32;
 typedef detail::AtomicIntegerT<int64_t> AtomicInt64;
 
+///
+/// @brief 独占一个缓存行的 std::atomic<T>，用于被不同线程频繁写入的
+///        相邻变量 (如每个线程一个的计数器)，避免伪共享
+///
+template <typename T>
+struct alignas(LUTE_CACHELINE_SIZE) PaddedAtomic : public std::atomic<T> {
+    static_assert(sizeof(std::atomic<T>) <= LUTE_CACHELINE_SIZE,
+                  "PaddedAtomic<T> must fit in a cache line");
+
+    PaddedAtomic() noexcept : std::atomic<T>(T()) {}
+    constexpr PaddedAtomic(T value) noexcept : std::atomic<T>(value) {}
+
+    using std::atomic<T>::operator=;
+};
+
+///
+/// @brief 按 CPU 分片的计数器
+///
+/// add() 只修改当前 CPU 对应的槽位 (relaxed fetch_add)，不同 CPU 上的线程
+/// 互不争抢缓存行；value() 遍历全部槽位求和，适合写多读少的统计计数。
+/// 并发 add() 时 value() 不是某一时刻的精确快照。
+///
+class StripedCounter {
+public:
+    ///
+    /// @param stripes 槽位数，向上取整为 2 的幂；0 表示按 CPU 核数
+    ///
+    explicit StripedCounter(size_t stripes = 0);
+
+    /// non-copyable
+    StripedCounter(const StripedCounter&) = delete;
+    StripedCounter& operator=(const StripedCounter&) = delete;
+
+    void add(int64_t x) {
+        slots_[stripe() & mask_].fetch_add(x, std::memory_order_relaxed);
+    }
+
+    void increment() { add(1); }
+    void decrement() { add(-1); }
+
+    /// @brief 全部槽位之和
+    int64_t value() const;
+
+    /// @brief 清零，与并发的 add() 之间没有原子性保证
+    void reset();
+
+    size_t stripes() const { return mask_ + 1; }
+
+private:
+    /// @brief 当前线程所在的 CPU，获取失败时按线程 ID 分片
+    static size_t stripe();
+
+    size_t mask_;
+    std::unique_ptr<PaddedAtomic<int64_t>[]> slots_;
+};
+
 }  // namespace Lute
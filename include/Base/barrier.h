@@ -0,0 +1,113 @@
+/**
+ * @brief 基于 futex 的一次性事件 Event 与可重用屏障 CyclicBarrier
+ *
+ *  - Event: 手动复位事件，set() 之后所有 wait() 立即返回，直到 reset()。
+ *    一个 32 位 futex 字保存 "未触发 / 已触发 / 有等待者" 三种状态，
+ *    没有等待者时 set() 只有一次原子交换
+ *  - CyclicBarrier: parties 个线程在每个阶段汇合，最后到达的线程执行可选的
+ *    完成回调并开启下一阶段。等待者先短暂自旋，再在阶段序号上休眠，
+ *    只有确实有线程休眠时最后到达者才进入内核唤醒
+ *
+ * @usage
+    Lute::Event ready;
+    std::thread t([&]() { ready.wait(); consume(); });
+    prepare();
+    ready.set();
+
+    Lute::CyclicBarrier barrier(kThreads, []() { swapBuffers(); });
+    // 每个工作线程:
+    for (int step = 0; step < kSteps; ++step) {
+        compute(step);
+        barrier.arriveAndWait();  // 所有线程完成本阶段后才进入下一阶段
+    }
+ */
+
+#pragma once
+
+#include <atomic>      // atomic
+#include <cstdint>     // uint32_t, int64_t
+#include <functional>  // function
+
+namespace Lute {
+///
+/// @brief 手动复位事件
+///
+class Event {
+public:
+    explicit Event(bool set = false) : state_(set ? kSet : kUnset) {}
+
+    /// non-copyable
+    Event(const Event&) = delete;
+    Event& operator=(const Event&) = delete;
+
+    ///
+    /// @brief 触发事件，唤醒全部等待者
+    ///
+    void set();
+
+    ///
+    /// @brief 复位为未触发状态，不能与 wait 并发调用
+    ///
+    void reset() { state_.store(kUnset, std::memory_order_relaxed); }
+
+    bool isSet() const {
+        return state_.load(std::memory_order_acquire) == kSet;
+    }
+
+    void wait() { waitFor(-1); }
+
+    ///
+    /// @brief 限时等待事件触发
+    /// @return 超时返回 false
+    ///
+    bool waitFor(int64_t timeoutNs);
+
+private:
+    static constexpr uint32_t kUnset = 0;
+    static constexpr uint32_t kSet = 1;
+    static constexpr uint32_t kWaiting = 2;
+
+    std::atomic<uint32_t> state_;
+};
+
+///
+/// @brief 可重用屏障
+///
+class CyclicBarrier {
+public:
+    using CompletionFunc = std::function<void()>;
+
+    ///
+    /// @param parties 每个阶段需要到达的线程数
+    /// @param completion 每个阶段最后到达的线程在唤醒其他线程之前调用
+    ///
+    explicit CyclicBarrier(int parties,
+                           CompletionFunc completion = CompletionFunc());
+
+    /// non-copyable
+    CyclicBarrier(const CyclicBarrier&) = delete;
+    CyclicBarrier& operator=(const CyclicBarrier&) = delete;
+
+    ///
+    /// @brief 到达屏障并等待本阶段的其他线程
+    /// @return 最后到达 (执行完成回调) 的线程返回 true
+    ///
+    bool arriveAndWait();
+
+    int parties() const { return parties_; }
+
+    /// @brief 已完成的阶段数
+    uint32_t generation() const {
+        return generation_.load(std::memory_order_acquire);
+    }
+
+private:
+    const uint32_t parties_;
+    const CompletionFunc completion_;
+    std::atomic<uint32_t> arrived_;
+    /// 阶段序号，等待者在其上休眠
+    std::atomic<uint32_t> generation_;
+    /// 正在 (或即将) 休眠的线程数
+    std::atomic<uint32_t> sleepers_;
+};
+}  // namespace Lute
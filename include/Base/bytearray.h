@@ -27,24 +27,36 @@
 ///     assert(ba->readableSize() == 0);
 ///     ba->clear();
 ///
+///     // 字节序在编译期确定，定长读写不再有运行时判断
+///     Lute::BasicByteArray<Lute::LittleEndian> le;
+///     le.writeFuint32(0x12345678);
+///     le.writeArray(values.data(), values.size());  // 批量 byteswap (SIMD)
+///
 
 #pragma once
 
-#include <Base/endian.h>  // LUTE_BYTE_ORDER, LUTE_BIG_ENDIAN, LUTE_LITTLE_ENDIAN
+#include <Base/endian.h>       // RuntimeEndian, LittleEndian, byteswapArray
+#include <Base/objectPool.h>   // ObjectPool
 #include <Base/string_view.h>  // string_view
 #include <sys/socket.h>        // iovec
 
-#include <cstdint>  // int32_t, int64_t, uint32_t, uint64_t
-#include <memory>   // shared_ptr
-#include <vector>   // vector
+#include <algorithm>    // min
+#include <cstdint>      // int32_t, int64_t, uint32_t, uint64_t
+#include <cstring>      // memcpy
+#include <memory>       // shared_ptr
+#include <type_traits>  // is_arithmetic
+#include <vector>       // vector
 
 namespace Lute {
 ///
 /// @brief 二进制数组 - 提供基础类型的序列化 / 反序列化
+/// @tparam EndianPolicy 字节序策略: RuntimeEndian (可通过 setLittleEndian
+///         切换) / LittleEndian / BigEndian (编译期固定)
 ///
-class ByteArray {
+template <class EndianPolicy>
+class BasicByteArray : public EndianPolicy {
 public:
-    using ptr = std::shared_ptr<ByteArray>;
+    using ptr = std::shared_ptr<BasicByteArray>;
 
     ///
     /// @brief ByteArray 存储节点
@@ -54,7 +66,9 @@ public:
         Node();
         /// @brief 构造函数 - 构造指定大小为 s 字节的内存块
         explicit Node(size_t size = 4096);
-        /// @brief 析构函数 - 释放内存
+        /// @brief 构造函数 - 引用外部内存块 (如 mmap 区域)，析构时不释放
+        Node(char* ptr, size_t size);
+        /// @brief 析构函数 - 释放内存 (池化的内存块归还给对象池)
         ~Node();
 
         /// 内存块指针
@@ -63,14 +77,27 @@ public:
         Node* next_;
         /// 内存块大小
         size_t size_;
+        /// 是否拥有 ptr_ 指向的内存
+        bool owned_;
+    };
+
+    ///
+    /// @brief mmap 只读模式下的访问模式提示, 对应 madvise(2)
+    ///
+    enum class Advice {
+        NORMAL,
+        SEQUENTIAL,
+        RANDOM,
+        WILLNEED,
+        DONTNEED,
     };
 
     ///
     /// @brief 使用指定长度的内存块构造 ByteArray
     /// @param[in] base_size 内存块大小
     ///
-    explicit ByteArray(size_t base_size = 4096);
-    ~ByteArray();
+    explicit BasicByteArray(size_t base_size = 4096);
+    ~BasicByteArray();
 
     ///
     /// @brief Write fixed-length int8_t type data
@@ -223,6 +250,33 @@ public:
      */
     void write(const void* buf, size_t size);
 
+    ///
+    /// @brief 写入 count 个定长算术类型元素，按 ByteArray 的字节序
+    /// @note 需要 byteswap 时按块拷贝后使用 SIMD 批量转换
+    /// @post position_ += count * sizeof(T)
+    ///
+    template <typename T>
+    void writeArray(const T* data, size_t count) {
+        static_assert(std::is_arithmetic<T>::value, "T must be arithmetic");
+        if constexpr (sizeof(T) == 1) {
+            write(data, count);
+        } else {
+            if (!this->needSwap()) {
+                write(data, count * sizeof(T));
+                return;
+            }
+            char buf[4096];
+            while (count > 0) {
+                size_t n = std::min(count, sizeof(buf) / sizeof(T));
+                ::memcpy(buf, data, n * sizeof(T));
+                byteswapBuffer(buf, sizeof(T), n);
+                write(buf, n * sizeof(T));
+                data += n;
+                count -= n;
+            }
+        }
+    }
+
     /**
      * @brief Read fixed-length int8_t type data
      * @pre readableSize() >= sizeof(int8_t)
@@ -364,20 +418,42 @@ public:
      */
     void read(void* buf, size_t size, size_t position) const;
 
+    ///
+    /// @brief 读取 count 个定长算术类型元素，读取后原地 SIMD 批量 byteswap
+    /// @exception std::out_of_range when readableSize() < count * sizeof(T)
+    ///
+    template <typename T>
+    void readArray(T* data, size_t count) {
+        static_assert(std::is_arithmetic<T>::value, "T must be arithmetic");
+        read(data, count * sizeof(T));
+        if constexpr (sizeof(T) > 1) {
+            if (this->needSwap()) byteswapArray(data, count);
+        }
+    }
+
     size_t position() const { return position_; }
     void setPosition(size_t v);
     size_t baseSize() const { return baseSize_; }
+    size_t capacity() const { return capacity_; }
     size_t size() const { return size_; }
     size_t readableSize() const { return size_ - position_; }
 
-    bool isLittleEndian() const { return endian_ == LUTE_LITTLE_ENDIAN; }
-    void setLittleEndian(bool val) {
-        endian_ = val ? LUTE_LITTLE_ENDIAN : LUTE_BIG_ENDIAN;
-    }
-
     std::string toString() const;
+    ///
+    /// @brief 可读数据的十六进制表示，每字节 "xx "，每 32 字节换行
+    ///
     std::string toHexString() const;
 
+    ///
+    /// @brief 直接沿内存块链表计算可读数据的 CRC32C，不拷贝数据
+    ///
+    uint32_t crc32c() const;
+
+    ///
+    /// @brief 直接沿内存块链表计算可读数据的 xxHash64，不拷贝数据
+    ///
+    uint64_t xxhash64(uint64_t seed = 0) const;
+
     ///
     /// @brief Get the Readable Buffers, it will be save into iovec
     ///
@@ -392,19 +468,75 @@ public:
                              uint64_t position) const;
 
     uint64_t writableBuffers(std::vector<iovec>& buffers, uint64_t len);
+
+    ///
+    /// @brief 预留从 position_ 开始至少 size 字节的可写容量，
+    ///        后续写入 size 字节以内不再分配内存块
+    /// @exception std::logic_error when isMapped()
+    ///
+    void reserve(size_t size);
+
     ///
     /// @brief 从文件中读取数据到 ByteArray
     ///
     bool readFromFile(const std::string_view& name);
     bool writeToFile(const std::string_view& name) const;
 
+    ///
+    /// @brief 以只读方式将文件 mmap 到 ByteArray，读取时直接访问映射内存，
+    ///        无需先把整个文件拷贝到堆上的内存块中
+    /// @post position_ = 0, size_ = 文件大小
+    /// @note 映射期间 ByteArray 只读，写操作抛出 std::logic_error;
+    ///       clear() 解除映射并恢复为普通 ByteArray
+    ///
+    bool mmapFromFile(const std::string_view& name);
+
+    ///
+    /// @brief 是否处于 mmap 只读模式
+    ///
+    bool isMapped() const { return mapped_ != nullptr; }
+
+    ///
+    /// @brief 对映射区间 [position, position + len) 调用 madvise
+    /// @note 非 mmap 模式下直接返回 false
+    ///
+    bool advise(Advice advice, size_t position = 0,
+                size_t len = ~static_cast<size_t>(0)) const;
+
     /**
      * @brief Clear the ByteArray
      * @post position_ = 0, size_ = 0
+     * @note 环形模式下保留全部内存块，否则只保留第一个内存块
      */
     void clear();
 
+    ///
+    /// @brief 丢弃 position_ 之前已经完整读完的内存块，并将位置整体前移
+    /// @post position_ -= 返回值, size_ -= 返回值
+    /// @return 丢弃的字节数 (baseSize 的整数倍)，调用方保存的位置需同步减去
+    /// @note 普通模式下释放这些内存块 (至少保留一个)；
+    ///       环形模式下将其挂到链表尾部，作为后续写入的容量，不再分配内存
+    ///
+    size_t discardRead();
+
+    ///
+    /// @brief 设置环形模式: discardRead() / clear() 回收而不是释放内存块，
+    ///        长连接缓冲的内存占用稳定在未读数据的峰值
+    ///
+    void setRingBuffer(bool val) { ring_ = val; }
+    bool isRingBuffer() const { return ring_; }
+
 private:
+    ///
+    /// @brief 定长写入，按策略 byteswap；当前内存块空间足够时直接 memcpy
+    ///
+    template <typename T>
+    void writeFixed(T val);
+    ///
+    /// @brief 定长读取，按策略 byteswap；当前内存块数据足够时直接 memcpy
+    ///
+    template <typename T>
+    T readFixed();
     ///
     /// @brief 扩容 ByteArray，扩容后的容量为 size
     ///
@@ -413,6 +545,20 @@ private:
     /// @brief 当前剩余可写容量
     ///
     size_t writableCapacity() const { return capacity_ - position_; }
+    ///
+    /// @brief 按内存块依次以 (ptr, len) 访问 [position_, size_) 的可读数据
+    ///
+    template <typename Func>
+    void forEachReadable(Func&& func) const;
+    ///
+    /// @brief 解除 mmap 映射，恢复为一个 heapBaseSize_ 大小的内存块
+    ///
+    void unmap();
+    ///
+    /// @brief 节点从对象池中分配，默认大小 (4096) 的内存块同样来自对象池，
+    ///        稳态读写不再申请内存
+    ///
+    static ObjectPool<Node>& nodePool();
 
     /// 内存块大小
     size_t baseSize_;
@@ -422,11 +568,25 @@ private:
     size_t capacity_;
     /// 当前数据大小
     size_t size_;
-    /// 字节序
-    int8_t endian_;
     /// 第一个内存块
     Node* root_;
     /// 当前操作的内存块指针
     Node* curr_;
+    /// mmap 映射的起始地址，非 mmap 模式下为 nullptr
+    char* mapped_;
+    /// mmap 之前的内存块大小，解除映射时恢复
+    size_t heapBaseSize_;
+    /// 环形模式
+    bool ring_;
 };
+
+/// 实现位于 bytearray.cc，只实例化以下三种字节序
+extern template class BasicByteArray<RuntimeEndian>;
+extern template class BasicByteArray<LittleEndian>;
+extern template class BasicByteArray<BigEndian>;
+
+/// 默认: 运行时可切换字节序
+using ByteArray = BasicByteArray<RuntimeEndian>;
+using LittleEndianByteArray = BasicByteArray<LittleEndian>;
+using BigEndianByteArray = BasicByteArray<BigEndian>;
 }  // namespace Lute
\ No newline at end of file
@@ -0,0 +1,59 @@
+///
+/// @brief 校验和 / 哈希 - CRC32C (Castagnoli) 与 xxHash64
+///
+/// 两者均支持流式计算，可以直接沿 ByteArray 的内存块链表逐块累加，
+/// 无需先把数据拷贝成连续内存。
+///     - crc32c: 支持 SSE4.2 时使用 crc32 指令 (运行时检测)，
+///               否则使用 slicing-by-8 查表实现
+///     - XXHash64: 与 xxHash 官方 XXH64 结果一致
+///
+/// @example
+///     uint32_t crc = Lute::crc32c(part1, len1);
+///     crc = Lute::crc32c(part2, len2, crc);  // == crc32c(part1 + part2)
+///
+///     Lute::XXHash64 hasher;
+///     hasher.update(part1, len1);
+///     hasher.update(part2, len2);
+///     uint64_t h = hasher.digest();
+///
+
+#pragma once
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint32_t, uint64_t
+
+namespace Lute {
+///
+/// @brief 计算 CRC32C
+/// @param crc 上一段数据的结果，用于流式计算；首段为 0
+///
+uint32_t crc32c(const void* data, size_t len, uint32_t crc = 0);
+
+///
+/// @brief 流式 xxHash64
+///
+class XXHash64 {
+public:
+    explicit XXHash64(uint64_t seed = 0);
+
+    /// @brief 重新开始计算
+    void reset(uint64_t seed = 0);
+
+    /// @brief 追加数据
+    void update(const void* data, size_t len);
+
+    /// @brief 当前已追加数据的哈希值，不影响后续 update
+    uint64_t digest() const;
+
+    /// @brief 一次性计算
+    static uint64_t hash(const void* data, size_t len, uint64_t seed = 0);
+
+private:
+    uint64_t seed_;
+    uint64_t acc_[4];
+    /// 不足 32 字节的剩余数据
+    unsigned char buf_[32];
+    size_t bufLen_;
+    uint64_t totalLen_;
+};
+}  // namespace Lute
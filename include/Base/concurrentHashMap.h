@@ -0,0 +1,360 @@
+/**
+ * @brief 分片并发哈希表 ConcurrentHashMap<K, V>
+ *
+ *  - 按哈希值的高位分成 N 个分片 (2 的幂)，每个分片是一张线性探测的开放
+ *    寻址表，写操作 (insertOrAssign / erase / clear) 持有该分片的 FastMutex，
+ *    不同分片的写互不影响
+ *  - 槽位只保存 (哈希值, 节点指针)，键值对放在不可变节点中: 赋值时换上新
+ *    节点，旧节点与扩容后的旧表交给 EpochDomain 延迟释放
+ *  - find / contains 不加锁: 在纪元临界区内直接探测当前表，
+ *    读到的节点在临界区结束之前不会被释放；读与写并发时读到写之前或之后的
+ *    值。对 K / V 没有可平凡复制的要求
+ *  - 删除留下墓碑 (哈希值非零、节点为空)，插入时复用；有效元素与墓碑超过
+ *    容量的 3/4 时重建: 元素多时容量加倍，否则原大小重建以清除墓碑
+ *  - forEach 逐个分片在锁内取得节点快照，在锁外调用回调，回调中可以读写
+ *    本表
+ *
+ * @usage
+    Lute::ConcurrentHashMap<std::string, int> sessions;
+    sessions.insertOrAssign("alice", 1);
+    int id;
+    if (sessions.find("alice", &id)) use(id);
+    sessions.erase("alice");
+    sessions.forEach([](const std::string& key, const int& value) {
+        LOG_INFO << key << " = " << value;
+    });
+ */
+
+#pragma once
+
+#include <Base/atomic.h>       // LUTE_CACHELINE_SIZE
+#include <Base/fastMutex.h>    // FastMutex
+#include <Base/reclamation.h>  // EpochDomain
+
+#include <algorithm>   // max
+#include <atomic>      // atomic
+#include <cstddef>     // size_t
+#include <cstdint>     // uint64_t
+#include <functional>  // hash, equal_to
+#include <memory>      // unique_ptr
+#include <utility>     // move
+#include <vector>      // vector
+
+namespace Lute {
+namespace detail {
+    ///
+    /// @brief 所有 ConcurrentHashMap 共用的回收域，只需要一个 pthread key
+    ///
+    inline EpochDomain& hashMapDomain() {
+        static EpochDomain* domain = new EpochDomain;
+        return *domain;
+    }
+}  // namespace detail
+
+template <typename K, typename V, typename Hash = std::hash<K>,
+          typename KeyEqual = std::equal_to<K>>
+class ConcurrentHashMap {
+public:
+    ///
+    /// @param shards 分片数，向上取整为 2 的幂
+    /// @param initialCapacity 每个分片的初始容量，向上取整为 2 的幂 (至少为 8)
+    ///
+    explicit ConcurrentHashMap(size_t shards = 16,
+                               size_t initialCapacity = 16)
+        : shardShift_(64 - log2(roundUpPowerOfTwo(shards))),
+          shards_(new Shard[roundUpPowerOfTwo(shards)]),
+          numShards_(roundUpPowerOfTwo(shards)),
+          initialCapacity_(
+              roundUpPowerOfTwo(std::max<size_t>(initialCapacity, 8))),
+          domain_(detail::hashMapDomain()) {
+        for (size_t i = 0; i < numShards_; ++i) {
+            shards_[i].table.store(new Table(initialCapacity_),
+                                   std::memory_order_relaxed);
+        }
+    }
+
+    /// 析构时不能有其他线程访问
+    ~ConcurrentHashMap() {
+        for (size_t i = 0; i < numShards_; ++i) {
+            Table* table = shards_[i].table.load(std::memory_order_relaxed);
+            for (size_t j = 0; j <= table->mask; ++j) {
+                delete table->slots[j].node.load(std::memory_order_relaxed);
+            }
+            delete table;
+        }
+    }
+
+    /// non-copyable
+    ConcurrentHashMap(const ConcurrentHashMap&) = delete;
+    ConcurrentHashMap& operator=(const ConcurrentHashMap&) = delete;
+
+    ///
+    /// @brief 插入或覆盖
+    /// @return 新插入返回 true，覆盖已有的值返回 false
+    ///
+    bool insertOrAssign(const K& key, V value) {
+        const uint64_t h = hashOf(key);
+        Shard& shard = shardOf(h);
+        Node* node = new Node(key, std::move(value));
+
+        FastMutexGuard lock(shard.mutex);
+        Table* table = shard.table.load(std::memory_order_relaxed);
+        size_t insertAt = kNotFound;
+        size_t index = probe(table, h, key, &insertAt);
+        if (index != kNotFound) {
+            Slot& slot = table->slots[index];
+            Node* old = slot.node.load(std::memory_order_relaxed);
+            slot.node.store(node, std::memory_order_release);
+            domain_.retire(old);
+            return false;
+        }
+
+        if (table->slots[insertAt].hash.load(std::memory_order_relaxed) == 0) {
+            // 占用空槽，必要时先重建
+            if (shard.used + 1 > (table->mask + 1) / 4 * 3) {
+                table = rehash(shard);
+                probe(table, h, key, &insertAt);
+            }
+            ++shard.used;
+        } else {
+            --shard.tombstones;
+        }
+        // 先发布节点再发布哈希值: 读者看到哈希值时一定能看到节点
+        Slot& slot = table->slots[insertAt];
+        slot.node.store(node, std::memory_order_release);
+        slot.hash.store(h, std::memory_order_release);
+        shard.size.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    ///
+    /// @brief 查找 key，找到时将值复制到 *value
+    ///
+    bool find(const K& key, V* value) const {
+        const uint64_t h = hashOf(key);
+        EpochDomain::Guard guard(domain_);
+        const Node* node = lookup(shardOf(h), h, key);
+        if (node == nullptr) return false;
+        *value = node->value;
+        return true;
+    }
+
+    bool contains(const K& key) const {
+        const uint64_t h = hashOf(key);
+        EpochDomain::Guard guard(domain_);
+        return lookup(shardOf(h), h, key) != nullptr;
+    }
+
+    ///
+    /// @return key 存在并被删除时返回 true
+    ///
+    bool erase(const K& key) {
+        const uint64_t h = hashOf(key);
+        Shard& shard = shardOf(h);
+        FastMutexGuard lock(shard.mutex);
+        Table* table = shard.table.load(std::memory_order_relaxed);
+        size_t insertAt = kNotFound;
+        size_t index = probe(table, h, key, &insertAt);
+        if (index == kNotFound) return false;
+
+        // 先从表中摘除再退休，之后进入临界区的读者不会再看到它
+        Slot& slot = table->slots[index];
+        Node* old = slot.node.load(std::memory_order_relaxed);
+        slot.node.store(nullptr, std::memory_order_release);
+        domain_.retire(old);
+        ++shard.tombstones;
+        shard.size.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    ///
+    /// @brief 对每个键值对调用 f(const K&, const V&)；每个分片取一次快照，
+    ///        回调在锁外执行
+    ///
+    template <typename F>
+    void forEach(F f) const {
+        std::vector<const Node*> snapshot;
+        EpochDomain::Guard guard(domain_);
+        for (size_t i = 0; i < numShards_; ++i) {
+            Shard& shard = shards_[i];
+            snapshot.clear();
+            {
+                FastMutexGuard lock(shard.mutex);
+                Table* table = shard.table.load(std::memory_order_relaxed);
+                for (size_t j = 0; j <= table->mask; ++j) {
+                    const Node* node =
+                        table->slots[j].node.load(std::memory_order_relaxed);
+                    if (node != nullptr) snapshot.push_back(node);
+                }
+            }
+            for (const Node* node : snapshot) f(node->key, node->value);
+        }
+    }
+
+    /// @brief 删除全部元素，各分片恢复初始容量
+    void clear() {
+        for (size_t i = 0; i < numShards_; ++i) {
+            Shard& shard = shards_[i];
+            FastMutexGuard lock(shard.mutex);
+            Table* old = shard.table.load(std::memory_order_relaxed);
+            shard.table.store(new Table(initialCapacity_),
+                              std::memory_order_release);
+            for (size_t j = 0; j <= old->mask; ++j) {
+                Node* node = old->slots[j].node.load(std::memory_order_relaxed);
+                if (node != nullptr) domain_.retire(node);
+            }
+            domain_.retire(old);
+            shard.used = 0;
+            shard.tombstones = 0;
+            shard.size.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief 各分片元素数之和，并发修改时只是近似值
+    size_t size() const {
+        size_t n = 0;
+        for (size_t i = 0; i < numShards_; ++i) {
+            n += shards_[i].size.load(std::memory_order_relaxed);
+        }
+        return n;
+    }
+
+    bool empty() const { return size() == 0; }
+
+    size_t shardCount() const { return numShards_; }
+
+private:
+    static constexpr size_t kNotFound = static_cast<size_t>(-1);
+
+    struct Node {
+        Node(const K& k, V v) : key(k), value(std::move(v)) {}
+
+        const K key;
+        const V value;
+    };
+
+    struct Slot {
+        /// 0 表示空槽；非零且 node 为空表示墓碑
+        std::atomic<uint64_t> hash{0};
+        std::atomic<Node*> node{nullptr};
+    };
+
+    struct Table {
+        explicit Table(size_t capacity)
+            : mask(capacity - 1), slots(new Slot[capacity]) {}
+
+        const size_t mask;
+        const std::unique_ptr<Slot[]> slots;
+    };
+
+    struct alignas(LUTE_CACHELINE_SIZE) Shard {
+        mutable FastMutex mutex;
+        std::atomic<Table*> table{nullptr};
+        /// 非空槽位数 (有效元素 + 墓碑)
+        size_t used GUARDED_BY(mutex) = 0;
+        size_t tombstones GUARDED_BY(mutex) = 0;
+        std::atomic<size_t> size{0};
+    };
+
+    static size_t roundUpPowerOfTwo(size_t n) {
+        size_t cap = 2;
+        while (cap < n) cap <<= 1;
+        return cap;
+    }
+
+    static int log2(size_t n) {
+        int bits = 0;
+        while ((static_cast<size_t>(1) << bits) < n) ++bits;
+        return bits;
+    }
+
+    /// @brief 混合哈希值 (std::hash 对整数是恒等映射)，结果不为 0
+    uint64_t hashOf(const K& key) const {
+        uint64_t h = static_cast<uint64_t>(hasher_(key));
+        h ^= h >> 33;
+        h *= 0xff51afd7ed558ccdULL;
+        h ^= h >> 33;
+        h *= 0xc4ceb9fe1a85ec53ULL;
+        h ^= h >> 33;
+        return h == 0 ? 1 : h;
+    }
+
+    /// @brief 高位选分片，低位选槽位
+    Shard& shardOf(uint64_t h) const {
+        return shards_[h >> shardShift_];
+    }
+
+    ///
+    /// @brief 在持有分片锁时查找 key
+    /// @return key 所在的槽位，不存在时返回 kNotFound，并在 *insertAt 中给出
+    ///         可插入的位置 (第一个墓碑或空槽)；存在时 *insertAt 不变
+    ///
+    size_t probe(Table* table, uint64_t h, const K& key,
+                 size_t* insertAt) const {
+        size_t firstTombstone = kNotFound;
+        for (size_t i = h & table->mask;; i = (i + 1) & table->mask) {
+            Slot& slot = table->slots[i];
+            uint64_t sh = slot.hash.load(std::memory_order_relaxed);
+            if (sh == 0) {
+                *insertAt = firstTombstone != kNotFound ? firstTombstone : i;
+                return kNotFound;
+            }
+            Node* node = slot.node.load(std::memory_order_relaxed);
+            if (node == nullptr) {
+                if (firstTombstone == kNotFound) firstTombstone = i;
+            } else if (sh == h && equal_(node->key, key)) {
+                return i;
+            }
+        }
+    }
+
+    /// @brief 不加锁查找，调用方须处于纪元临界区
+    const Node* lookup(const Shard& shard, uint64_t h, const K& key) const {
+        const Table* table = shard.table.load(std::memory_order_acquire);
+        for (size_t i = h & table->mask;; i = (i + 1) & table->mask) {
+            const Slot& slot = table->slots[i];
+            uint64_t sh = slot.hash.load(std::memory_order_acquire);
+            if (sh == 0) return nullptr;
+            if (sh == h) {
+                const Node* node = slot.node.load(std::memory_order_acquire);
+                if (node != nullptr && equal_(node->key, key)) return node;
+            }
+        }
+    }
+
+    /// @brief 重建分片的表，旧表延迟释放；节点直接移入新表
+    Table* rehash(Shard& shard) NO_THREAD_SAFETY_ANALYSIS {
+        Table* old = shard.table.load(std::memory_order_relaxed);
+        const size_t live = shard.used - shard.tombstones;
+        size_t capacity = old->mask + 1;
+        // 有效元素超过一半时加倍，否则只清除墓碑
+        if (live + 1 > capacity / 2) capacity <<= 1;
+
+        auto* table = new Table(capacity);
+        for (size_t i = 0; i <= old->mask; ++i) {
+            Node* node = old->slots[i].node.load(std::memory_order_relaxed);
+            if (node == nullptr) continue;
+            uint64_t h = old->slots[i].hash.load(std::memory_order_relaxed);
+            size_t j = h & table->mask;
+            while (table->slots[j].hash.load(std::memory_order_relaxed) != 0) {
+                j = (j + 1) & table->mask;
+            }
+            table->slots[j].node.store(node, std::memory_order_relaxed);
+            table->slots[j].hash.store(h, std::memory_order_relaxed);
+        }
+        shard.table.store(table, std::memory_order_release);
+        shard.used = live;
+        shard.tombstones = 0;
+        domain_.retire(old);
+        return table;
+    }
+
+    const int shardShift_;
+    const std::unique_ptr<Shard[]> shards_;
+    const size_t numShards_;
+    const size_t initialCapacity_;
+    EpochDomain& domain_;
+    Hash hasher_;
+    KeyEqual equal_;
+};
+}  // namespace Lute
@@ -11,12 +11,24 @@
  * 等待条件变量变为真，如果在给定的时间内条件不能满足，则会生成一个返回错误码的变量
  *  pthread_cond_signal 至少唤醒一个等待该条件的线程
  *  pthread_cond_broadcast 唤醒等待该条件的所有线程
+ *
+ * 条件变量以 pthread_condattr_setclock(CLOCK_MONOTONIC) 初始化，限时等待的
+ * 截止时间同样取自 CLOCK_MONOTONIC (即 std::chrono::steady_clock)，不受
+ * 系统时间调整影响；waitUntil / waitFor 精确到纳秒，并提供谓词形式:
+ *
+ *      MutexLockGuard lock(mutex);
+ *      if (!cond.waitFor(100 * 1000 * 1000, [&]() { return !queue.empty(); }))
+ *          return;  // 100ms 内条件仍不满足
  */
 
 #pragma once
 
 #include <Base/mutex.h>
 
+#include <chrono>   // steady_clock
+#include <cstdint>  // int64_t
+#include <utility>  // move
+
 namespace Lute {
 /**
  * pthread 中 condition 的核心函数：创建、销毁、等待、通知、广播
@@ -32,11 +44,11 @@ public:
     Condition(const Condition&) = delete;
     Condition& operator=(Condition&) = delete;
 
-    /// @brief 对动态分配的条件变量进行初始化，使用默认属性
+    using Clock = std::chrono::steady_clock;
+
+    /// @brief 对动态分配的条件变量进行初始化，使用 CLOCK_MONOTONIC 计时
     /// @param mutex
-    explicit Condition(MutexLock& mutex) : mutex_(mutex) {
-        MCHECK(pthread_cond_init(&pcond_, nullptr));
-    }
+    explicit Condition(MutexLock& mutex);
 
     /// 对条件变量进行反初始化
     ~Condition() { MCHECK(pthread_cond_destroy(&pcond_)); }
@@ -47,8 +59,46 @@ public:
         MCHECK(pthread_cond_wait(&pcond_, mutex_.getPthreadMutex()));
     }
 
+    /// @brief 等待直到 pred() 为真
+    template <typename Predicate>
+    void wait(Predicate pred) {
+        while (!pred()) wait();
+    }
+
+    /// @brief 等待到 deadline 为止 (steady_clock)
+    /// @return returns true if time out, false otherwise.
+    bool waitUntil(Clock::time_point deadline);
+
+    /// @brief 最多等待 nanoseconds 纳秒
+    /// @return returns true if time out, false otherwise.
+    bool waitFor(int64_t nanoseconds);
+
     /// @brief returns true if time out, false otherwise.
-    bool waitForSeconds(double seconds);
+    bool waitForSeconds(double seconds) {
+        return waitFor(static_cast<int64_t>(seconds * 1e9));
+    }
+
+    ///
+    /// @brief 等待直到 pred() 为真或到达 deadline
+    /// @return 返回时 pred() 的值
+    ///
+    template <typename Predicate>
+    bool waitUntil(Clock::time_point deadline, Predicate pred) {
+        while (!pred()) {
+            if (waitUntil(deadline)) return pred();
+        }
+        return true;
+    }
+
+    ///
+    /// @brief 等待直到 pred() 为真，最多等待 nanoseconds 纳秒
+    /// @return 返回时 pred() 的值
+    ///
+    template <typename Predicate>
+    bool waitFor(int64_t nanoseconds, Predicate pred) {
+        return waitUntil(Clock::now() + std::chrono::nanoseconds(nanoseconds),
+                         std::move(pred));
+    }
 
     /// @brief 至少唤醒一个等待该条件的线程
     inline void notify() { MCHECK(pthread_cond_signal(&pcond_)); }
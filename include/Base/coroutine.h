@@ -0,0 +1,619 @@
+/**
+ * @brief C++20 协程: Task<T> 与 Base 组件的 awaitable
+ *
+ *  - Task<T>: 惰性启动，co_await 时才开始执行，结束时通过对称转移恢复
+ *    等待者 (开启优化时为尾调用，不增加调用栈深度)；异常在 co_await 处
+ *    重新抛出
+ *  - syncWait(task): 在当前线程阻塞等待 task 完成 (futex)，用于 main 或
+ *    非协程代码的入口；spawn(task) / spawn(executor, task): 分离执行，
+ *    未捕获的异常调用 std::terminate
+ *  - 调度: co_await schedule(pool) / schedule(loop) 切换到 ThreadPool 的
+ *    工作线程或 EventLoop 的循环线程继续执行
+ *  - 定时器: co_await sleepFor(loop / scheduler, seconds)，在循环线程 /
+ *    调度线程中恢复
+ *  - fd 就绪: co_await waitReadable(loop, fd) / waitWritable(loop, fd)，
+ *    一次性注册 (边沿触发)，在循环线程中恢复，返回 epoll 事件掩码
+ *  - AsyncEvent / AsyncLatch: 无锁的一次性事件与倒计数器，set() / 计数到零
+ *    时在调用线程中依次恢复全部等待者
+ *  - AsyncQueue<T>: 无界队列，co_await queue.pop() 在队列为空时挂起；
+ *    push 把元素直接交给等待最久的消费者并在 push 的线程中恢复它
+ *
+ * 等待期间不占用线程，上万个并发等待只占用各自的协程帧。
+ * 本头文件只在以 C++20 (-std=c++20) 编译的翻译单元中生效，库本身仍以
+ * C++17 编译。
+ *
+ * @usage
+    Lute::Task<std::string> fetch(Lute::EventLoop& loop, int fd) {
+        co_await Lute::waitReadable(loop, fd);
+        co_return readAll(fd);
+    }
+
+    Lute::Task<void> handle(Lute::ThreadPool& pool, Lute::EventLoop& loop,
+                            int fd) {
+        std::string request = co_await fetch(loop, fd);
+        co_await Lute::schedule(pool);  // 切换到工作线程处理
+        process(request);
+    }
+
+    Lute::spawn(handle(pool, loop, fd));
+ */
+
+#pragma once
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+
+#include <Base/eventLoop.h>   // EventLoop
+#include <Base/fastMutex.h>   // FastMutex
+#include <Base/futex.h>       // Futex
+#include <Base/threadPool.h>  // ThreadPool
+#include <Base/timerWheel.h>  // TimerScheduler
+
+#include <atomic>     // atomic
+#include <coroutine>  // coroutine_handle, suspend_always
+#include <cstdint>    // uint32_t, int64_t
+#include <deque>      // deque
+#include <exception>  // exception_ptr, terminate
+#include <optional>   // optional
+#include <utility>    // exchange, move
+
+#define LUTE_HAS_COROUTINE 1
+
+namespace Lute {
+template <typename T = void>
+class Task;
+
+template <typename T>
+T syncWait(Task<T> task);
+
+namespace detail {
+    ///
+    /// @brief Task 结束时恢复等待者，没有等待者时停在 final_suspend
+    ///
+    struct FinalAwaiter {
+        bool await_ready() const noexcept { return false; }
+
+        template <typename P>
+        std::coroutine_handle<> await_suspend(
+            std::coroutine_handle<P> h) noexcept {
+            std::coroutine_handle<> continuation = h.promise().continuation_;
+            if (continuation) return continuation;
+            return std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    class PromiseBase {
+    public:
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+
+        void unhandled_exception() noexcept {
+            exception_ = std::current_exception();
+        }
+
+        std::coroutine_handle<> continuation_;
+
+    protected:
+        std::exception_ptr exception_;
+    };
+
+    template <typename T>
+    class Promise : public PromiseBase {
+    public:
+        Task<T> get_return_object() noexcept;
+
+        template <typename U>
+        void return_value(U&& value) {
+            value_.emplace(std::forward<U>(value));
+        }
+
+        T result() {
+            if (exception_) std::rethrow_exception(exception_);
+            return std::move(*value_);
+        }
+
+    private:
+        std::optional<T> value_;
+    };
+
+    template <>
+    class Promise<void> : public PromiseBase {
+    public:
+        Task<void> get_return_object() noexcept;
+
+        void return_void() const noexcept {}
+
+        void result() {
+            if (exception_) std::rethrow_exception(exception_);
+        }
+    };
+}  // namespace detail
+
+///
+/// @brief 惰性启动的协程任务，只能被 co_await 一次
+///
+template <typename T>
+class Task {
+public:
+    using promise_type = detail::Promise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    Task() noexcept : handle_(nullptr) {}
+    explicit Task(Handle h) noexcept : handle_(h) {}
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_) handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    ~Task() {
+        if (handle_) handle_.destroy();
+    }
+
+    /// non-copyable
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    bool valid() const noexcept { return static_cast<bool>(handle_); }
+    bool done() const noexcept { return !handle_ || handle_.done(); }
+
+    ///
+    /// @brief 启动 (或等待) 任务，返回结果或重新抛出异常
+    ///
+    auto operator co_await() const noexcept {
+        struct Awaiter {
+            Handle handle;
+
+            bool await_ready() const noexcept { return handle.done(); }
+
+            std::coroutine_handle<> await_suspend(
+                std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation_ = awaiting;
+                return handle;
+            }
+
+            T await_resume() { return handle.promise().result(); }
+        };
+        return Awaiter{handle_};
+    }
+
+    ///
+    /// @brief 等待任务完成但不取结果，也不抛出异常
+    ///
+    auto whenReady() const noexcept {
+        struct Awaiter {
+            Handle handle;
+
+            bool await_ready() const noexcept { return handle.done(); }
+
+            std::coroutine_handle<> await_suspend(
+                std::coroutine_handle<> awaiting) noexcept {
+                handle.promise().continuation_ = awaiting;
+                return handle;
+            }
+
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{handle_};
+    }
+
+private:
+    template <typename U>
+    friend U syncWait(Task<U> task);
+
+    Handle handle_;
+};
+
+namespace detail {
+    template <typename T>
+    Task<T> Promise<T>::get_return_object() noexcept {
+        return Task<T>(std::coroutine_handle<Promise<T>>::from_promise(*this));
+    }
+
+    inline Task<void> Promise<void>::get_return_object() noexcept {
+        return Task<void>(
+            std::coroutine_handle<Promise<void>>::from_promise(*this));
+    }
+
+    ///
+    /// @brief syncWait 的包装协程，结束时停在 final_suspend 并通过 futex
+    ///        通知等待线程，协程帧由等待线程销毁
+    ///
+    class SyncWaitTask {
+    public:
+        struct promise_type {
+            std::atomic<uint32_t> done{0};
+
+            SyncWaitTask get_return_object() noexcept {
+                return SyncWaitTask(
+                    std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+
+            std::suspend_always initial_suspend() const noexcept {
+                return {};
+            }
+
+            auto final_suspend() const noexcept {
+                struct Notifier {
+                    bool await_ready() const noexcept { return false; }
+                    void await_suspend(
+                        std::coroutine_handle<promise_type> h) noexcept {
+                        // store 之后协程帧随时可能被销毁，先取地址
+                        std::atomic<uint32_t>* done = &h.promise().done;
+                        done->store(1, std::memory_order_release);
+                        Futex::wake(done);
+                    }
+                    void await_resume() const noexcept {}
+                };
+                return Notifier{};
+            }
+
+            void return_void() const noexcept {}
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+
+        explicit SyncWaitTask(std::coroutine_handle<promise_type> h)
+            : handle_(h) {}
+        ~SyncWaitTask() { handle_.destroy(); }
+
+        /// non-copyable
+        SyncWaitTask(const SyncWaitTask&) = delete;
+        SyncWaitTask& operator=(const SyncWaitTask&) = delete;
+
+        void run() {
+            handle_.resume();
+            std::atomic<uint32_t>& done = handle_.promise().done;
+            while (done.load(std::memory_order_acquire) == 0) {
+                Futex::wait(&done, 0);
+            }
+        }
+
+    private:
+        std::coroutine_handle<promise_type> handle_;
+    };
+
+    template <typename T>
+    SyncWaitTask makeSyncWaitTask(const Task<T>& task) {
+        co_await task.whenReady();
+    }
+
+    ///
+    /// @brief 立即开始执行、结束时自行销毁的协程
+    ///
+    struct DetachedTask {
+        struct promise_type {
+            DetachedTask get_return_object() const noexcept { return {}; }
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept {}
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+    };
+
+    inline DetachedTask runDetached(Task<void> task) { co_await task; }
+
+    template <typename Executor>
+    DetachedTask runDetachedOn(Executor& executor, Task<void> task);
+}  // namespace detail
+
+///
+/// @brief 阻塞当前线程直到 task 完成，返回结果或重新抛出异常
+/// @note 不能在 task 需要恢复执行的线程 (如其 EventLoop 的循环线程) 中调用
+///
+template <typename T>
+T syncWait(Task<T> task) {
+    detail::SyncWaitTask waiter = detail::makeSyncWaitTask(task);
+    waiter.run();
+    return task.handle_.promise().result();
+}
+
+///
+/// @brief 在当前线程中开始执行 task，不等待其完成
+///
+inline void spawn(Task<void> task) { detail::runDetached(std::move(task)); }
+
+///
+/// @brief 在 executor (ThreadPool / EventLoop) 中执行 task，不等待其完成
+///
+template <typename Executor>
+void spawn(Executor& executor, Task<void> task) {
+    detail::runDetachedOn(executor, std::move(task));
+}
+
+///
+/// @brief 切换到线程池的工作线程继续执行
+///
+inline auto schedule(ThreadPool& pool) noexcept {
+    struct Awaiter {
+        ThreadPool& pool;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) {
+            pool.run([h]() { h.resume(); });
+        }
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{pool};
+}
+
+///
+/// @brief 切换到 EventLoop 的循环线程继续执行；已在循环线程中时，
+///        让出到本轮事件处理之后
+///
+inline auto schedule(EventLoop& loop) noexcept {
+    struct Awaiter {
+        EventLoop& loop;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) {
+            loop.queueInLoop([h]() { h.resume(); });
+        }
+        void await_resume() const noexcept {}
+    };
+    return Awaiter{loop};
+}
+
+namespace detail {
+    template <typename Executor>
+    DetachedTask runDetachedOn(Executor& executor, Task<void> task) {
+        co_await schedule(executor);
+        co_await task;
+    }
+
+    template <typename Timer>
+    struct SleepAwaiter {
+        Timer& timer;
+        double seconds;
+
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> h) {
+            timer.runAfter(seconds, [h]() { h.resume(); });
+        }
+        void await_resume() const noexcept {}
+    };
+
+    struct FdAwaiter {
+        EventLoop& loop;
+        int fd;
+        uint32_t events;
+        uint32_t revents = 0;
+
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(std::coroutine_handle<> h) {
+            // 协程恢复之前 awaiter 一直位于协程帧中
+            loop.runInLoop([this, h]() {
+                loop.addFd(fd, events, [this, h](uint32_t ready) {
+                    loop.removeFd(fd);
+                    revents = ready;
+                    h.resume();
+                });
+            });
+        }
+
+        uint32_t await_resume() const noexcept { return revents; }
+    };
+}  // namespace detail
+
+///
+/// @brief seconds 秒之后在 EventLoop 的循环线程中恢复
+///
+inline detail::SleepAwaiter<EventLoop> sleepFor(EventLoop& loop,
+                                                double seconds) {
+    return {loop, seconds};
+}
+
+///
+/// @brief seconds 秒之后在 TimerScheduler 的调度线程中恢复，
+///        恢复后应尽快 schedule() 到其他执行器
+///
+inline detail::SleepAwaiter<TimerScheduler> sleepFor(
+    TimerScheduler& scheduler, double seconds) {
+    return {scheduler, seconds};
+}
+
+///
+/// @brief 等待 fd 可读，在循环线程中恢复，返回 epoll 事件掩码
+/// @note 同一 fd 同时只能有一个等待者，且不能已由 addFd 注册
+///
+inline detail::FdAwaiter waitReadable(EventLoop& loop, int fd) {
+    return {loop, fd, EPOLLIN | EPOLLRDHUP};
+}
+
+///
+/// @brief 等待 fd 可写，在循环线程中恢复，返回 epoll 事件掩码
+///
+inline detail::FdAwaiter waitWritable(EventLoop& loop, int fd) {
+    return {loop, fd, EPOLLOUT};
+}
+
+///
+/// @brief 一次性事件，set() 之后的 co_await 不再挂起
+///
+/// state_ 为 nullptr 表示未触发且没有等待者，为 this 表示已触发，
+/// 否则为等待者组成的无锁链表的表头
+///
+class AsyncEvent {
+public:
+    explicit AsyncEvent(bool set = false)
+        : state_(set ? this : nullptr) {}
+
+    /// non-copyable
+    AsyncEvent(const AsyncEvent&) = delete;
+    AsyncEvent& operator=(const AsyncEvent&) = delete;
+
+    bool isSet() const noexcept {
+        return state_.load(std::memory_order_acquire) == this;
+    }
+
+    ///
+    /// @brief 触发事件，在调用线程中依次恢复全部等待者
+    ///
+    void set() noexcept {
+        void* old = state_.exchange(this, std::memory_order_acq_rel);
+        if (old == this) return;
+        auto* waiter = static_cast<Awaiter*>(old);
+        while (waiter) {
+            // 恢复之后 waiter 所在的协程帧可能被销毁，先取出 next
+            Awaiter* next = waiter->next;
+            waiter->handle.resume();
+            waiter = next;
+        }
+    }
+
+    struct Awaiter {
+        const AsyncEvent& event;
+        std::coroutine_handle<> handle;
+        Awaiter* next = nullptr;
+
+        bool await_ready() const noexcept { return event.isSet(); }
+
+        bool await_suspend(std::coroutine_handle<> h) noexcept {
+            handle = h;
+            void* old = event.state_.load(std::memory_order_acquire);
+            do {
+                if (old == &event) return false;  // 已触发，不挂起
+                next = static_cast<Awaiter*>(old);
+            } while (!event.state_.compare_exchange_weak(
+                old, this, std::memory_order_release,
+                std::memory_order_acquire));
+            return true;
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    Awaiter operator co_await() const noexcept { return Awaiter{*this, {}}; }
+
+private:
+    mutable std::atomic<void*> state_;
+};
+
+///
+/// @brief 协程倒计数器，计数减到零时恢复全部等待者
+///
+class AsyncLatch {
+public:
+    explicit AsyncLatch(int64_t count)
+        : count_(count), event_(count <= 0) {}
+
+    /// non-copyable
+    AsyncLatch(const AsyncLatch&) = delete;
+    AsyncLatch& operator=(const AsyncLatch&) = delete;
+
+    void countDown(int64_t n = 1) noexcept {
+        int64_t old = count_.fetch_sub(n, std::memory_order_acq_rel);
+        if (old > 0 && old <= n) event_.set();
+    }
+
+    bool ready() const noexcept { return event_.isSet(); }
+
+    AsyncEvent::Awaiter operator co_await() const noexcept {
+        return event_.operator co_await();
+    }
+
+private:
+    std::atomic<int64_t> count_;
+    AsyncEvent event_;
+};
+
+///
+/// @brief 协程队列，pop 在队列为空时挂起协程而不阻塞线程
+///
+template <typename T>
+class AsyncQueue {
+public:
+    AsyncQueue() : head_(nullptr), tail_(nullptr) {}
+
+    /// non-copyable
+    AsyncQueue(const AsyncQueue&) = delete;
+    AsyncQueue& operator=(const AsyncQueue&) = delete;
+
+    ///
+    /// @brief 入队；有等待者时直接交给等待最久的协程并在当前线程中恢复它
+    ///
+    void push(T value) {
+        mutex_.lock();
+        PopAwaiter* waiter = head_;
+        if (waiter == nullptr) {
+            items_.push_back(std::move(value));
+            mutex_.unlock();
+            return;
+        }
+        head_ = waiter->next_;
+        if (head_ == nullptr) tail_ = nullptr;
+        mutex_.unlock();
+
+        waiter->value_.emplace(std::move(value));
+        waiter->handle_.resume();
+    }
+
+    bool tryPop(T& value) {
+        FastMutexGuard lock(mutex_);
+        if (items_.empty()) return false;
+        value = std::move(items_.front());
+        items_.pop_front();
+        return true;
+    }
+
+    size_t size() const {
+        FastMutexGuard lock(mutex_);
+        return items_.size();
+    }
+
+    class PopAwaiter {
+    public:
+        explicit PopAwaiter(AsyncQueue& queue) : queue_(queue) {}
+
+        bool await_ready() const noexcept { return false; }
+
+        bool await_suspend(std::coroutine_handle<> h) {
+            FastMutexGuard lock(queue_.mutex_);
+            if (!queue_.items_.empty()) {
+                value_.emplace(std::move(queue_.items_.front()));
+                queue_.items_.pop_front();
+                return false;
+            }
+            handle_ = h;
+            next_ = nullptr;
+            if (queue_.tail_) {
+                queue_.tail_->next_ = this;
+            } else {
+                queue_.head_ = this;
+            }
+            queue_.tail_ = this;
+            return true;
+        }
+
+        T await_resume() { return std::move(*value_); }
+
+    private:
+        friend class AsyncQueue;
+
+        AsyncQueue& queue_;
+        std::optional<T> value_;
+        std::coroutine_handle<> handle_;
+        PopAwaiter* next_ = nullptr;
+    };
+
+    ///
+    /// @brief co_await queue.pop() 取出队首元素，队列为空时挂起
+    ///
+    PopAwaiter pop() noexcept { return PopAwaiter(*this); }
+
+private:
+    mutable FastMutex mutex_;
+    std::deque<T> items_ GUARDED_BY(mutex_);
+    /// 等待者组成的 FIFO 链表
+    PopAwaiter* head_ GUARDED_BY(mutex_);
+    PopAwaiter* tail_ GUARDED_BY(mutex_);
+};
+}  // namespace Lute
+
+#endif  // __cpp_impl_coroutine
@@ -12,13 +12,18 @@
  *       start 了, 线程池对象才完成析构,实现ThreadPool的过程中遇到过
  *   核心函数：
  *    1. countDwon() 对计数器进行原子减一操作
- *    2. wait() 使用条件变量等待计数器减到零，然后notify
+ *    2. wait() 在 futex 上等待计数器减到零
+ *
+ *   计数器与 "有等待者" 标志位保存在同一个 32 位 futex 字中: countDown 是
+ *   一次 CAS，只有计数减到零且确实有线程在等待时才进入内核唤醒；
+ *   wait 在计数已为零时不进入内核。countDown 在唤醒之前不再访问 latch，
+ *   wait 返回后即可销毁 latch。
  */
 
 #pragma once
 
-#include <Base/condition_variable.h>
-#include <Base/mutex.h>
+#include <atomic>   // atomic
+#include <cstdint>  // uint32_t, int64_t
 
 namespace Lute {
 class CountDownLatch {
@@ -29,19 +34,29 @@ public:
 
     explicit CountDownLatch(int count);
 
-    /// @brief 使用条件变量等待计数器减到零，然后notify
+    /// @brief 在 futex 上等待计数器减到零
     void wait();
 
-    /// @brief 对计数器进行原子减一操作
+    ///
+    /// @brief 限时等待计数器减到零
+    /// @return 超时返回 false
+    ///
+    bool waitFor(int64_t timeoutNs);
+
+    /// @brief 对计数器进行原子减一操作，已为零时不变
     void countDown();
 
     /// @brief 获取计数器值
     /// @return int
-    int getCount() const;
+    int getCount() const {
+        return static_cast<int>(state_.load(std::memory_order_acquire) &
+                                kCountMask);
+    }
 
 private:
-    mutable MutexLock mutex_;
-    Condition condition_ GUARDED_BY(mutex_);
-    int count_ GUARDED_BY(mutex_);
+    static constexpr uint32_t kWaiters = 1u << 31;
+    static constexpr uint32_t kCountMask = kWaiters - 1;
+
+    std::atomic<uint32_t> state_;
 };
 }  // namespace Lute
@@ -8,6 +8,7 @@
 
 #include <byteswap.h>
 
+#include <cstddef>  // size_t
 #include <cstdint>
 #include <type_traits>
 
@@ -43,7 +44,7 @@ typename std::enable_if<sizeof(T) == sizeof(uint32_t), T>::type byteswap(
 template <class T>
 typename std::enable_if<sizeof(T) == sizeof(uint16_t), T>::type byteswap(
     T val) {
-    return static_cast<T>(bswap_32(static_cast<uint16_t>(val)));
+    return static_cast<T>(bswap_16(static_cast<uint16_t>(val)));
 }
 
 #if LUTE_BYTE_ORDER == LUTE_BIG_ENDIAN
@@ -81,4 +82,58 @@ T byteswapOnBigEndian(T val) {
 }
 #endif
 
+///
+/// @brief 将 data 中 count 个宽度为 width (2 / 4 / 8) 字节的元素原地 byteswap
+/// @note x86-64 下按 CPU 支持情况 (运行时检测) 使用 AVX2 / SSSE3 的 pshufb
+///       每次处理 32 / 16 字节，其余情况逐个元素 byteswap
+///
+void byteswapBuffer(void* data, size_t width, size_t count);
+
+///
+/// @brief 将数组 data 的 count 个元素原地 byteswap
+///
+template <class T>
+void byteswapArray(T* data, size_t count) {
+    static_assert(sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8,
+                  "byteswapArray only supports 2 / 4 / 8 byte elements");
+    byteswapBuffer(data, sizeof(T), count);
+}
+
+/// NOTE ----------- 字节序策略 (BasicByteArray 的模板参数) -----------
+
+///
+/// @brief 运行时可切换的字节序，默认为本机字节序
+///
+class RuntimeEndian {
+public:
+    bool isLittleEndian() const { return endian_ == LUTE_LITTLE_ENDIAN; }
+    void setLittleEndian(bool val) {
+        endian_ = val ? LUTE_LITTLE_ENDIAN : LUTE_BIG_ENDIAN;
+    }
+    /// @brief 与本机字节序不同时需要 byteswap
+    bool needSwap() const { return endian_ != LUTE_BYTE_ORDER; }
+
+private:
+    int8_t endian_ = LUTE_BYTE_ORDER;
+};
+
+///
+/// @brief 编译期固定的字节序，needSwap() 为常量，
+///        与本机字节序相同时定长读写直接编译为普通的 load / store
+///
+template <int Order>
+class StaticEndian {
+public:
+    static_assert(Order == LUTE_LITTLE_ENDIAN || Order == LUTE_BIG_ENDIAN,
+                  "invalid byte order");
+
+    static constexpr bool isLittleEndian() {
+        return Order == LUTE_LITTLE_ENDIAN;
+    }
+    static constexpr bool needSwap() { return Order != LUTE_BYTE_ORDER; }
+};
+
+using LittleEndian = StaticEndian<LUTE_LITTLE_ENDIAN>;
+using BigEndian = StaticEndian<LUTE_BIG_ENDIAN>;
+
 }  // namespace Lute
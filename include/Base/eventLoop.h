@@ -0,0 +1,214 @@
+/**
+ * @brief 基于 epoll 的事件循环 EventLoop 与 EventLoopThreadPool
+ *
+ *  - one loop per thread: 每个线程最多一个 EventLoop，loop() 只能在创建它
+ *    的线程中调用
+ *  - fd 以边沿触发 (EPOLLET) 注册，回调收到 epoll 事件掩码，须一直读/写到
+ *    EAGAIN；回调中可以注册、修改或移除任意 fd (包括自己)
+ *  - runInLoop / queueInLoop: 任意线程向循环投递任务，通过 eventfd 唤醒
+ *  - 定时器: 内置 TimerWheel (1ms 精度)，epoll_wait 的超时时间取下一个
+ *    定时器的到期时间；定时器接口线程安全
+ *  - EventLoopThreadPool: 每个 Lute::Thread 运行一个 EventLoop，默认与 CPU
+ *    核数相同，可选绑定 CPU
+ *
+ * @usage
+    Lute::EventLoopThreadPool pool("IO");
+    pool.start();
+    Lute::EventLoop* loop = pool.getNextLoop();
+    loop->runInLoop([loop, fd]() {
+        loop->addFd(fd, EPOLLIN, [fd](uint32_t events) { onReadable(fd); });
+    });
+    loop->runEvery(1.0, []() { LOG_INFO << "heartbeat"; });
+ */
+
+#pragma once
+
+#include <Base/fastMutex.h>   // FastMutex
+#include <Base/thread.h>      // Thread
+#include <Base/timerWheel.h>  // TimerWheel, TimerId
+#include <sys/epoll.h>        // EPOLLIN, EPOLLOUT
+
+#include <atomic>      // atomic
+#include <cstdint>     // uint32_t, int64_t
+#include <functional>  // function
+#include <memory>      // unique_ptr
+#include <string>      // string
+#include <vector>      // vector
+
+namespace Lute {
+class CountDownLatch;
+
+class EventLoop {
+public:
+    using Functor = std::function<void()>;
+    /// @brief fd 事件回调，参数为 epoll 事件掩码 (EPOLLIN / EPOLLOUT / ...)
+    using IoCallback = std::function<void(uint32_t events)>;
+
+    EventLoop();
+    ~EventLoop();
+
+    /// non-copyable
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    ///
+    /// @brief 运行事件循环直到 quit()，只能在创建 EventLoop 的线程中调用
+    ///
+    void loop();
+
+    ///
+    /// @brief 退出事件循环，可以在任意线程中调用
+    ///
+    void quit();
+
+    ///
+    /// @brief 在循环线程中执行 cb: 当前就是循环线程时立即执行，否则入队
+    ///
+    void runInLoop(Functor cb);
+
+    ///
+    /// @brief 将 cb 加入队列，在本轮事件处理之后执行
+    ///
+    void queueInLoop(Functor cb);
+
+    /// @brief 尚未执行的投递任务数
+    size_t queueSize() const;
+
+    ///
+    /// @brief 以边沿触发方式注册 fd，只能在循环线程中调用
+    /// @param events EPOLLIN / EPOLLOUT 等，EPOLLET 自动加上
+    ///
+    void addFd(int fd, uint32_t events, IoCallback cb);
+
+    /// @brief 修改关注的事件，只能在循环线程中调用
+    void updateFd(int fd, uint32_t events);
+
+    ///
+    /// @brief 移除 fd (不关闭)，只能在循环线程中调用；
+    ///        本轮尚未分发的该 fd 的事件被丢弃
+    ///
+    void removeFd(int fd);
+
+    bool hasFd(int fd) const;
+
+    /// @name 定时器，线程安全，回调在循环线程中执行
+    /// @{
+    TimerId runAt(Timestamp time, Functor cb);
+    TimerId runAfter(double delay, Functor cb);
+    TimerId runEvery(double interval, Functor cb);
+    bool cancel(TimerId id);
+    /// @}
+
+    ///
+    /// @brief 唤醒阻塞在 epoll_wait 中的循环线程
+    ///
+    void wakeup();
+
+    bool isInLoopThread() const;
+
+    void assertInLoopThread() const {
+        if (!isInLoopThread()) abortNotInLoopThread();
+    }
+
+    /// @brief 循环的迭代次数
+    int64_t iteration() const { return iteration_; }
+
+    ///
+    /// @brief 当前线程的 EventLoop，没有时返回 nullptr
+    ///
+    static EventLoop* getEventLoopOfCurrentThread();
+
+private:
+    struct Handler {
+        IoCallback cb;
+        uint32_t events = 0;
+        /// 每次注册加一，用于识别已移除的 fd 的过期事件
+        uint32_t generation = 0;
+        bool registered = false;
+    };
+
+    void abortNotInLoopThread() const;
+    void handleWakeup();
+    void doPendingFunctors();
+    void runTimers() NO_THREAD_SAFETY_ANALYSIS;
+    /// @brief 距下一个定时器到期的毫秒数，没有定时器时返回 -1
+    int pollTimeoutMs();
+    TimerId addTimer(double delay, Functor cb, double interval);
+    void epollControl(int op, int fd, const Handler& handler);
+
+    std::atomic<bool> looping_;
+    std::atomic<bool> quit_;
+    std::atomic<bool> callingPendingFunctors_;
+    int64_t iteration_;
+    const pid_t threadId_;
+
+    int epollfd_;
+    int wakeupFd_;
+    std::vector<struct epoll_event> events_;
+    /// 以 fd 为下标
+    std::vector<Handler> handlers_;
+
+    mutable FastMutex mutex_;
+    std::vector<Functor> pendingFunctors_ GUARDED_BY(mutex_);
+
+    const int64_t startNs_;
+    mutable FastMutex timerMutex_;
+    TimerWheel timers_ GUARDED_BY(timerMutex_);
+};
+
+///
+/// @brief 运行 EventLoop 的线程池
+///
+class EventLoopThreadPool {
+public:
+    using ThreadInitCallback = std::function<void(EventLoop*)>;
+
+    explicit EventLoopThreadPool(
+        const std::string& name = std::string("EventLoop"));
+    ~EventLoopThreadPool();
+
+    /// non-copyable
+    EventLoopThreadPool(const EventLoopThreadPool&) = delete;
+    EventLoopThreadPool& operator=(const EventLoopThreadPool&) = delete;
+
+    ///
+    /// @brief 是否将第 i 个循环线程绑定到第 i % N 个 CPU，须在 start() 之前调用
+    ///
+    void setThreadAffinity(bool on) { affinity_ = on; }
+
+    ///
+    /// @brief 启动 numThreads 个循环线程，numThreads <= 0 时使用 CPU 核数；
+    ///        返回时所有 EventLoop 均已创建
+    /// @param cb 在每个循环线程中、进入 loop() 之前调用
+    ///
+    void start(int numThreads = 0,
+               const ThreadInitCallback& cb = ThreadInitCallback());
+
+    ///
+    /// @brief 退出所有循环并等待线程结束
+    ///
+    void stop();
+
+    /// @brief 轮询选择下一个 EventLoop
+    EventLoop* getNextLoop();
+
+    /// @brief 同一 hashCode 总是返回同一个 EventLoop
+    EventLoop* getLoopForHash(size_t hashCode);
+
+    const std::vector<EventLoop*>& getAllLoops() const { return loops_; }
+
+    bool started() const { return started_; }
+    const std::string& name() const { return name_; }
+
+private:
+    void threadFunc(size_t index, const ThreadInitCallback& cb,
+                    CountDownLatch* latch);
+
+    const std::string name_;
+    bool affinity_;
+    bool started_;
+    std::atomic<size_t> next_;
+    std::vector<std::unique_ptr<Thread>> threads_;
+    std::vector<EventLoop*> loops_;
+};
+}  // namespace Lute
@@ -0,0 +1,212 @@
+/**
+ * @brief 轻量级互斥量 FastMutex 与自旋锁 SpinLock
+ *
+ *  - FastMutex: 基于 futex 的三态互斥量 (Drepper, "Futexes Are Tricky")
+ *      0 - 未加锁, 1 - 已加锁且无等待者, 2 - 已加锁且可能有等待者
+ *    无竞争时加锁 / 解锁各只有一次原子操作；竞争时先有限自旋，再在 futex
+ *    上休眠；只有状态为 2 时解锁才进入内核唤醒
+ *  - 持有者线程 ID 只在调试版本 (未定义 NDEBUG) 中记录，发布版本临界区内
+ *    没有额外的 TLS 读写；isLockedByThisThread() 因此只在调试版本中提供，
+ *    isLocked() 始终可用
+ *  - SpinLock: 纯用户态自旋锁，test-and-test-and-set + 指数退避 (pause)，
+ *    退避达到上限后让出 CPU；只适用于极短的临界区
+ *  - 与 MutexLock 相同的 CAPABILITY 注解，可用于 GUARDED_BY
+ *  - 以 LUTE_MUTEX_PROFILING 构建时 FastMutex 同样记录竞争统计 (见
+ *    lockProfiler.h)，进入 lockSlow 即视为一次竞争
+ *
+ * @usage
+    Lute::FastMutex mutex;
+    int counter GUARDED_BY(mutex) = 0;
+    {
+        Lute::FastMutexGuard lock(mutex);
+        ++counter;
+    }
+ */
+
+#pragma once
+
+#include <Base/atomic.h>  // cpuRelax
+#include <Base/futex.h>   // Futex
+#include <Base/mutex.h>   // CAPABILITY, ACQUIRE, RELEASE
+
+#include <atomic>   // atomic
+#include <cassert>  // assert
+#include <cstdint>  // uint32_t
+
+#ifndef NDEBUG
+#include <Base/currentThread.h>  // CurrentThread::tid
+#endif
+
+namespace Lute {
+
+///
+/// @brief 基于 futex 的互斥量，不可重入
+///
+class CAPABILITY("mutex") FastMutex {
+public:
+    /// @param name 竞争统计报告中的名字，须在互斥量的生命期内有效
+    explicit FastMutex(const char* name = nullptr)
+        : state_(kUnlocked)
+#ifdef LUTE_MUTEX_PROFILING
+          ,
+          profile_(name)
+#endif
+    {
+        (void)name;
+    }
+
+    ~FastMutex() { assert(state_.load(std::memory_order_relaxed) == 0); }
+
+    /// non-copyable
+    FastMutex(const FastMutex&) = delete;
+    FastMutex& operator=(const FastMutex&) = delete;
+
+    void lock() ACQUIRE() {
+        uint32_t expected = kUnlocked;
+        if (state_.compare_exchange_strong(expected, kLocked,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+            profileAcquired(false, 0);
+        } else {
+            const uint64_t start = profileClock();
+            lockSlow();
+            profileAcquired(true, profileClock() - start);
+        }
+        assignHolder();
+    }
+
+    bool tryLock() TRY_ACQUIRE(true) {
+        uint32_t expected = kUnlocked;
+        if (state_.compare_exchange_strong(expected, kLocked,
+                                           std::memory_order_acquire,
+                                           std::memory_order_relaxed)) {
+            profileAcquired(false, 0);
+            assignHolder();
+            return true;
+        }
+        return false;
+    }
+
+    void unlock() RELEASE() {
+        unassignHolder();
+        profileReleased();
+        if (state_.exchange(kUnlocked, std::memory_order_release) ==
+            kContended) {
+            Futex::wake(&state_, 1);
+        }
+    }
+
+    /// @brief 是否已被某个线程加锁
+    bool isLocked() const {
+        return state_.load(std::memory_order_relaxed) != kUnlocked;
+    }
+
+#ifndef NDEBUG
+    /// @brief 是否由当前线程持有，只在调试版本中提供 (持有者只在调试版本记录)
+    bool isLockedByThisThread() const {
+        return holder_ == CurrentThread::tid();
+    }
+#endif
+
+    void assertLocked() const ASSERT_CAPABILITY(this) {
+        assert(isLockedByThisThread());
+    }
+
+private:
+    static constexpr uint32_t kUnlocked = 0;
+    static constexpr uint32_t kLocked = 1;
+    static constexpr uint32_t kContended = 2;
+
+    void lockSlow();
+
+#ifdef LUTE_MUTEX_PROFILING
+    static uint64_t profileClock() { return readCycles(); }
+    void profileAcquired(bool contended, uint64_t waitCycles) {
+        profile_.acquired(contended, waitCycles);
+    }
+    void profileReleased() { profile_.released(); }
+#else
+    static uint64_t profileClock() { return 0; }
+    void profileAcquired(bool, uint64_t) {}
+    void profileReleased() {}
+#endif
+
+#ifndef NDEBUG
+    void assignHolder() { holder_ = CurrentThread::tid(); }
+    void unassignHolder() { holder_ = 0; }
+#else
+    void assignHolder() {}
+    void unassignHolder() {}
+#endif
+
+    ///
+    /// @brief 持有该互斥量的线程 ID，只在调试版本中记录；
+    ///        成员始终存在，调试与发布版本的对象布局一致
+    ///
+    [[maybe_unused]] int holder_ = 0;
+
+    std::atomic<uint32_t> state_;
+#ifdef LUTE_MUTEX_PROFILING
+    /// @brief 竞争统计
+    LockProfile profile_;
+#endif
+};
+
+///
+/// @brief 指数退避的自旋锁，不可重入
+///
+class CAPABILITY("mutex") SpinLock {
+public:
+    SpinLock() : locked_(false) {}
+
+    /// non-copyable
+    SpinLock(const SpinLock&) = delete;
+    SpinLock& operator=(const SpinLock&) = delete;
+
+    void lock() ACQUIRE() {
+        if (!locked_.exchange(true, std::memory_order_acquire)) return;
+        lockSlow();
+    }
+
+    bool tryLock() TRY_ACQUIRE(true) {
+        return !locked_.load(std::memory_order_relaxed) &&
+               !locked_.exchange(true, std::memory_order_acquire);
+    }
+
+    void unlock() RELEASE() { locked_.store(false, std::memory_order_release); }
+
+    bool isLocked() const { return locked_.load(std::memory_order_relaxed); }
+
+private:
+    void lockSlow();
+
+    std::atomic<bool> locked_;
+};
+
+///
+/// @brief FastMutex / SpinLock 的作用域锁，用法与 MutexLockGuard 相同
+///
+template <typename Mutex>
+class SCOPED_CAPABILITY LockGuard {
+public:
+    /// non-copyable
+    LockGuard(const LockGuard&) = delete;
+    LockGuard& operator=(const LockGuard&) = delete;
+
+    explicit LockGuard(Mutex& mutex) ACQUIRE(mutex) : mutex_(mutex) {
+        mutex_.lock();
+    }
+    ~LockGuard() RELEASE() { mutex_.unlock(); }
+
+private:
+    Mutex& mutex_;
+};
+
+using FastMutexGuard = LockGuard<FastMutex>;
+using SpinLockGuard = LockGuard<SpinLock>;
+
+}  // namespace Lute
+
+// 防止误用：FastMutexGuard(mutex_) 产生的临时对象马上被销毁，没有锁住临界区
+#define FastMutexGuard(x) error "Missing guard object name"
+#define SpinLockGuard(x) error "Missing guard object name"
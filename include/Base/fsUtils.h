@@ -7,6 +7,7 @@
 
 #include <Base/utils.h>  // NOINLINE
 #include <sys/stat.h>    // stat
+#include <sys/uio.h>     // iovec
 
 #include <cstring>  // strerror_r
 #include <fstream>
@@ -14,6 +15,8 @@
 #include <vector>
 
 namespace Lute {
+class IoUring;
+
 class FSUtil {
 public:
     /// @brief List all files in path with subfix
@@ -122,6 +125,20 @@ int readFile(const std::string& filename, int maxSize, String* content,
                              createTime);
 }
 
+///
+/// @brief 批量读取多个文件，每个文件最多 maxSize 字节
+///
+/// 提供可用的 ring (或 ring 为 nullptr 而 io_uring 可用) 时，各普通文件的
+/// 读请求一次提交、由内核并发执行，磁盘延迟相互重叠；其余情况 (不支持
+/// io_uring、/proc 等大小未知的文件) 逐个调用 readFile
+///
+/// @param contents 输出，与 filenames 一一对应
+/// @return 与 filenames 一一对应的 errno，0 表示成功
+///
+std::vector<int> readFiles(const std::vector<std::string>& filenames,
+                           int maxSize, std::vector<std::string>* contents,
+                           IoUring* ring = nullptr);
+
 ///
 /// @brief Append content to file
 /// @note Not thread safe
@@ -148,6 +165,14 @@ public:
     ///
     void append(const char* logline, size_t len);
 
+    ///
+    /// @brief 批量写入 count 段数据，先刷出 stdio 缓冲以保证顺序
+    ///
+    /// ring 可用时各段作为链接的写请求一次提交 (落在已注册缓冲区内的段
+    /// 使用 WRITE_FIXED)，否则使用 writev；写入不完整的部分同步补写
+    ///
+    void appendv(const struct iovec* iov, int count, IoUring* ring = nullptr);
+
     void flush();
 
     off_t writtenBytes() const { return writtenBytes_; }
@@ -161,6 +186,9 @@ private:
     ///
     size_t write(const char* logline, size_t len);
 
+    /// @brief 绕过 stdio 写入全部数据，返回实际写入的字节数
+    size_t writeFully(const char* data, size_t len);
+
     FILE* fp_;                // FILE*
     char buffer_[64 * 1024];  // 64KB
     off_t writtenBytes_;      // 已经写入的字节数
@@ -0,0 +1,123 @@
+///
+/// @brief futex(2) 封装与基于 futex 的 EventCount
+///
+/// Futex::wait / Futex::wake 直接操作 32 位原子变量，阻塞 / 唤醒均只在
+/// 存在竞争时进入内核，适合作为无锁数据结构 "先自旋，再休眠" 的休眠部分。
+///
+/// EventCount 用于给无锁结构补充阻塞等待能力，而不在快路径上引入锁:
+///     等待方                              通知方
+///     key = ec.prepareWait();             修改状态 (如入队成功)
+///     if (条件已满足) {                   ec.notify();
+///         ec.cancelWait(); return;
+///     }
+///     ec.wait(key);
+/// prepareWait 之后的条件检查与 notify 之前的状态修改之间有全序保证，
+/// 不会出现 "检查时条件不满足，通知却已经错过" 的丢失唤醒。
+/// 没有需要唤醒的等待者时 notify 只有一次内存栅栏和一次读。
+///
+
+#pragma once
+
+#include <atomic>   // atomic
+#include <climits>  // INT_MAX
+#include <cstdint>  // uint32_t, int64_t
+
+namespace Lute {
+namespace Futex {
+    ///
+    /// @brief *addr == expected 时休眠，直到被 wake、超时或被信号打断
+    /// @param timeoutNs 相对超时 (纳秒)，小于 0 表示不超时
+    /// @return 被唤醒 (可能是虚假唤醒) 返回 0；*addr != expected 或超时返回 -1
+    ///         并设置 errno (EAGAIN / ETIMEDOUT / EINTR)
+    ///
+    int wait(const std::atomic<uint32_t>* addr, uint32_t expected,
+             int64_t timeoutNs = -1);
+
+    ///
+    /// @brief 唤醒最多 count 个在 addr 上休眠的线程
+    /// @return 被唤醒的线程数
+    ///
+    int wake(const std::atomic<uint32_t>* addr, int count = INT_MAX);
+}  // namespace Futex
+
+///
+/// @brief CLOCK_MONOTONIC 的当前值 (纳秒)，用于计算限时等待的截止时间
+///
+int64_t monotonicNs();
+
+///
+/// @brief 事件计数器 - 无锁结构的条件变量
+///
+/// state_ 低 32 位为已登记的等待者数，高 32 位为已发出但尚未被等待者消费的
+/// 信号数。信号数不小于等待者数时 notify 直接返回，被唤醒的线程尚未运行时，
+/// 连续的 notify 不会重复进入内核。
+///
+class EventCount {
+public:
+    EventCount() : epoch_(0), state_(0) {}
+
+    /// non-copyable
+    EventCount(const EventCount&) = delete;
+    EventCount& operator=(const EventCount&) = delete;
+
+    ///
+    /// @brief 登记为等待者，返回当前纪元；随后必须重新检查条件，
+    ///        再调用 wait(key) / waitFor(key) 或 cancelWait() 之一
+    ///
+    uint32_t prepareWait() {
+        state_.fetch_add(kWaiter, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return epoch_.load(std::memory_order_acquire);
+    }
+
+    /// @brief 条件已满足，放弃等待
+    void cancelWait() { leave(); }
+
+    ///
+    /// @brief 休眠直到 prepareWait 之后有 notify 发生 (允许虚假唤醒)
+    ///
+    void wait(uint32_t key);
+
+    ///
+    /// @brief 最多休眠 timeoutNs 纳秒
+    /// @return 被 notify 返回 true，超时返回 false
+    ///
+    bool waitFor(uint32_t key, int64_t timeoutNs);
+
+    /// @brief 唤醒一个等待者
+    void notify() {
+        // 与 prepareWait 中的栅栏配对: 重新检查条件的等待者能看到通知前的
+        // 状态修改，否则通知方一定能看到该等待者
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint64_t state = state_.load(std::memory_order_relaxed);
+        if (signals(state) >= waiters(state)) return;
+        notifySlow(false);
+    }
+
+    /// @brief 唤醒全部等待者
+    void notifyAll() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        uint64_t state = state_.load(std::memory_order_relaxed);
+        if (signals(state) >= waiters(state)) return;
+        notifySlow(true);
+    }
+
+private:
+    static constexpr uint64_t kWaiter = 1;
+    static constexpr uint64_t kSignal = uint64_t(1) << 32;
+
+    static uint32_t waiters(uint64_t state) {
+        return static_cast<uint32_t>(state);
+    }
+    static uint32_t signals(uint64_t state) {
+        return static_cast<uint32_t>(state >> 32);
+    }
+
+    void notifySlow(bool all);
+    /// @brief 注销等待者，并消费一个信号
+    void leave();
+
+    std::atomic<uint32_t> epoch_;
+    std::atomic<uint64_t> state_;
+};
+}  // namespace Lute
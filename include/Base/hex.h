@@ -0,0 +1,43 @@
+///
+/// @brief 十六进制编码 / 解码
+///
+/// x86-64 下使用 SSE2 每次处理 16 字节 (编码) / 32 字符 (解码)，
+/// 其余平台及尾部数据使用查表实现，两者结果一致。
+///
+/// @example
+///     std::string hex = Lute::hexEncode("Lute", 4);  // "4c757465"
+///     std::string raw;
+///     assert(Lute::hexDecode(hex, &raw) && raw == "Lute");
+///
+
+#pragma once
+
+#include <Base/string_view.h>  // string_view
+
+#include <cstddef>  // size_t
+#include <string>   // string
+
+namespace Lute {
+///
+/// @brief 将 src 的 len 字节编码为 2 * len 个小写十六进制字符写入 dst
+/// @note 不追加 '\0'
+///
+void hexEncode(const void* src, size_t len, char* dst);
+
+///
+/// @brief 将 src 的 len 字节编码为小写十六进制字符串
+///
+std::string hexEncode(const void* src, size_t len);
+
+///
+/// @brief 将 src 的 len 个十六进制字符 (大小写均可) 解码为 len / 2 字节写入 dst
+/// @return len 为奇数或包含非法字符时返回 false，此时 dst 内容未定义
+///
+bool hexDecode(const char* src, size_t len, void* dst);
+
+///
+/// @brief 将十六进制字符串解码到 out
+/// @return len 为奇数或包含非法字符时返回 false
+///
+bool hexDecode(const string_view& src, std::string* out);
+}  // namespace Lute
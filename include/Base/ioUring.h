@@ -0,0 +1,147 @@
+/**
+ * @brief 基于原始系统调用的最小 io_uring 封装 (不依赖 liburing)
+ *
+ *  - 一个 IoUring 对象对应一个 ring，只能由一个线程使用
+ *  - prepareRead / prepareWrite 只填写 SQE，submit 一次 io_uring_enter
+ *    提交全部已准备的请求，并可同时等待若干完成事件
+ *  - registerBuffers 注册固定缓冲区；prepareRead / prepareWrite 的缓冲落在
+ *    已注册缓冲区内时自动使用 READ_FIXED / WRITE_FIXED，省去每次请求的
+ *    页面 pin / unpin。已注册的内存在注销 (或 ring 析构) 之前不能释放
+ *  - 内核不支持 (< 5.1) 或被 seccomp 禁止时 valid() 为 false，调用方应回退到
+ *    read / write；supported() 还会探测 READ / WRITE 操作码 (>= 5.6) 并缓存
+ *    结果。不支持的操作码以 -EINVAL 完成
+ *
+ * AppendFile::appendv 与 readFiles 在提供 ring 时使用它批量提交，
+ * AsyncLogger 可通过 setIoUring(true) 或 LOG_IO_URING = true 启用。
+ *
+ * @usage
+    Lute::IoUring ring(32);
+    if (ring.valid()) {
+        ring.prepareWrite(fd, buf1, len1, -1, 1, true);  // 与下一个请求链接
+        ring.prepareWrite(fd, buf2, len2, -1, 2);
+        ring.submit(2);  // 提交并等待两个完成事件
+        uint64_t userData;
+        int32_t res;
+        while (ring.peekCompletion(&userData, &res)) handle(userData, res);
+    }
+ */
+
+#pragma once
+
+#include <sys/uio.h>  // iovec
+
+#include <cstddef>  // size_t
+#include <cstdint>  // uint64_t, int32_t
+#include <vector>   // vector
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+namespace Lute {
+class IoUring {
+public:
+    ///
+    /// @param entries 提交队列的长度，内核会向上取整为 2 的幂
+    ///
+    explicit IoUring(unsigned entries = 64);
+    ~IoUring();
+
+    /// non-copyable
+    IoUring(const IoUring&) = delete;
+    IoUring& operator=(const IoUring&) = delete;
+
+    ///
+    /// @brief 当前内核与进程环境是否支持 io_uring 及本类用到的操作码
+    ///
+    static bool supported();
+
+    bool valid() const { return ringFd_ >= 0; }
+
+    /// @brief 创建失败时的 errno
+    int error() const { return error_; }
+
+    /// @brief 提交队列的长度，也是单次最多可准备的请求数
+    unsigned entries() const { return sqEntries_; }
+
+    ///
+    /// @brief 注册固定缓冲区，替换之前注册的缓冲区
+    /// @return 0 或 errno (如超出 RLIMIT_MEMLOCK 时为 ENOMEM)
+    ///
+    int registerBuffers(const struct iovec* iovecs, unsigned count);
+    int unregisterBuffers();
+
+    ///
+    /// @brief [addr, addr + len) 所在的已注册缓冲区下标，不在其中时返回 -1
+    ///
+    int findBuffer(const void* addr, size_t len) const;
+
+    ///
+    /// @brief 准备读 / 写请求
+    /// @param offset 文件偏移，-1 表示使用并推进文件当前位置
+    /// @param userData 原样出现在完成事件中
+    /// @param link 为 true 时下一个请求在本请求完成后才开始；本请求失败
+    ///        或读写不完整时，链上之后的请求以 -ECANCELED 完成
+    /// @return 提交队列已满时返回 false
+    ///
+    bool prepareRead(int fd, void* buf, unsigned len, int64_t offset,
+                     uint64_t userData, bool link = false);
+    bool prepareWrite(int fd, const void* buf, unsigned len, int64_t offset,
+                      uint64_t userData, bool link = false);
+    bool prepareFsync(int fd, uint64_t userData, bool dataSync = true);
+
+    ///
+    /// @brief 提交全部已准备的请求，并等待至少 waitNr 个完成事件
+    /// @return 提交的请求数，或 -errno；失败时未被内核取走的请求被丢弃
+    ///
+    int submit(unsigned waitNr = 0);
+
+    ///
+    /// @brief 取出一个完成事件，没有时返回 false
+    /// @param res 对应系统调用的返回值，失败时为 -errno
+    ///
+    bool peekCompletion(uint64_t* userData, int32_t* res);
+
+    ///
+    /// @brief 取出一个完成事件，没有时阻塞等待
+    /// @return io_uring_enter 失败时返回 false
+    ///
+    bool waitCompletion(uint64_t* userData, int32_t* res);
+
+    /// @brief 已准备但尚未提交的请求数
+    unsigned pending() const { return sqeTail_ - sqeHead_; }
+
+private:
+    struct io_uring_sqe* getSqe();
+    bool prepareRw(int op, int fd, const void* buf, unsigned len,
+                   int64_t offset, uint64_t userData, bool link);
+    int enter(unsigned toSubmit, unsigned waitNr, unsigned flags);
+    void unmapRings();
+
+    int ringFd_;
+    int error_;
+
+    /// 提交队列
+    void* sqRing_;
+    size_t sqRingSize_;
+    unsigned* sqHead_;
+    unsigned* sqTail_;
+    unsigned sqMask_;
+    unsigned sqEntries_;
+    unsigned* sqArray_;
+    struct io_uring_sqe* sqes_;
+    size_t sqesSize_;
+    /// 本地已准备的 SQE 区间 [sqeHead_, sqeTail_)，submit 时发布到 sqTail_
+    unsigned sqeHead_;
+    unsigned sqeTail_;
+
+    /// 完成队列，与提交队列共用一次 mmap 时 cqRing_ == sqRing_
+    void* cqRing_;
+    size_t cqRingSize_;
+    unsigned* cqHead_;
+    unsigned* cqTail_;
+    unsigned cqMask_;
+    struct io_uring_cqe* cqes_;
+
+    std::vector<struct iovec> buffers_;
+};
+}  // namespace Lute
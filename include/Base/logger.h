@@ -13,11 +13,15 @@
 
 #pragma once
 
-#include <Base/fsUtils.h>    // AppendFile
-#include <Base/mutex.h>      // MutexLock
-#include <Base/thread.h>     // Thread
-#include <Base/timestamp.h>  // Timestamp
-#include <Base/utils.h>      // memZero
+#include <Base/countDownLatch.h>  // CountDownLatch
+#include <Base/fastMutex.h>       // FastMutex
+#include <Base/fsUtils.h>         // AppendFile
+#include <Base/futex.h>           // EventCount
+#include <Base/mutex.h>           // MutexLock
+#include <Base/objectPool.h>      // ObjectPool
+#include <Base/thread.h>          // Thread
+#include <Base/timestamp.h>       // Timestamp
+#include <Base/utils.h>           // memZero
 
 #include <memory>  // unique_ptr
 
@@ -50,6 +54,7 @@ namespace detail {
 
         const char* data() const { return data_; }
         int length() const { return static_cast<int>(cur_ - data_); }
+        static constexpr int capacity() { return SIZE; }
 
         // write to data_ directly
         char* current() { return cur_; }
@@ -167,13 +172,26 @@ public:
     ~LogFile();
 
     void append(const char* logline, int len);
+    ///
+    /// @brief 一次写入多段日志，见 AppendFile::appendv
+    ///
+    void appendv(const struct iovec* iov, int count);
     void flush();
     bool rollFile();
 
+    ///
+    /// @brief 设置 appendv 使用的 io_uring，nullptr 表示使用 writev
+    /// @note ring 只能由调用 appendv 的线程使用
+    ///
+    void setIoUring(IoUring* ring) { ring_ = ring; }
+
 private:
     const static int kRollPerSeconds_ = 60 * 60 * 24;
 
     void append_unlocked(const char* logline, int len);
+    void appendv_unlocked(const struct iovec* iov, int count);
+    /// @brief 写入之后检查是否需要滚动或刷新文件
+    void checkRoll();
 
     static std::string getLogFileName(const std::string& basename, time_t* now);
 
@@ -189,6 +207,7 @@ private:
     time_t lastRoll_;                   // Last roll time
     time_t lastFlush_;                  // Last flush time
     std::unique_ptr<AppendFile> file_;  // 日志文件
+    IoUring* ring_;                     // appendv 使用的 io_uring
 };
 
 ///
@@ -280,8 +299,12 @@ public:
     AsyncLogger(const AsyncLogger&) = delete;
     AsyncLogger& operator=(AsyncLogger&) = delete;
 
+    ///
+    /// @param options 后端线程的参数，如将其绑定到非关键路径的 CPU 上
+    ///
     AsyncLogger(const std::string& basename, off_t rollSize,
-                int flushInterval = 3);
+                int flushInterval = 3,
+                const ThreadOptions& options = ThreadOptions());
     ~AsyncLogger() {
         if (running_) stop();
     }
@@ -299,25 +322,37 @@ public:
 
     void stop() NO_THREAD_SAFETY_ANALYSIS {
         running_ = false;
-        cond_.notify();
+        wakeup_.notify();
         thread_.join();
     }
 
+    ///
+    /// @brief 后端线程是否通过 io_uring 批量写文件 (内核不支持时自动回退到
+    ///        writev)，须在 start() 之前调用
+    ///
+    void setIoUring(bool on) { useIoUring_ = on; }
+
 private:
     void threadFunc();
 
     using Buffer = detail::FixedBuffer<detail::kLargeBuffer>;
-    using BufferVector = std::vector<std::unique_ptr<Buffer>>;
-    using BufferPtr = BufferVector::value_type;
+    using BufferPtr = ObjectPool<Buffer>::Ptr;
+    using BufferVector = std::vector<BufferPtr>;
+
+    /// @brief 所有 AsyncLogger 共用的缓冲池，缓冲不在线程本地缓存
+    static ObjectPool<Buffer>& bufferPool();
 
     const int flushInterval_;
     std::atomic<bool> running_;
     const std::string basename_;
     const off_t rollSize_;
+    bool useIoUring_;
     Thread thread_;
     CountDownLatch latch_;
-    MutexLock mutex_;
-    Condition cond_ GUARDED_BY(mutex_);
+    /// 临界区只有缓冲的追加与交换，使用 FastMutex 而非 pthread 互斥量
+    FastMutex mutex_;
+    /// 有写满的缓冲或停止时唤醒后端线程
+    EventCount wakeup_;
 
     /// 当前缓冲
     BufferPtr currentBuffer_ GUARDED_BY(mutex_);
@@ -5,6 +5,8 @@
  *  调用 pthread_mutex_init 函数进行初始化
  *  对互斥量加锁调用 int pthread_mutex_lock(pthread_mutex_t *mutex)
  *  对互斥量解锁锁调用 int pthread_mutex_unlock(pthread_mutex_t *mutex)
+ *
+ *  以 LUTE_MUTEX_PROFILING 构建时记录每个互斥量的竞争统计，见 lockProfiler.h
  */
 
 #pragma once
@@ -14,6 +16,10 @@
 
 #include <cassert>
 
+#ifdef LUTE_MUTEX_PROFILING
+#include <Base/lockProfiler.h>  // LockProfile
+#endif
+
 // Thread safety annotations {
 // https://clang.llvm.org/docs/ThreadSafetyAnalysis.html
 // Enable thread safety attributes only with clang.
@@ -117,7 +123,15 @@ public:
     MutexLock& operator=(MutexLock&) = delete;
 
     /// @brief 互斥量初始化为默认属性
-    MutexLock() : holder_(0) {
+    /// @param name 竞争统计报告中的名字，须在互斥量的生命期内有效
+    explicit MutexLock(const char* name = nullptr)
+        : holder_(0)
+#ifdef LUTE_MUTEX_PROFILING
+          ,
+          profile_(name)
+#endif
+    {
+        (void)name;
         MCHECK(pthread_mutexattr_init(&mutexAttr_));
         MCHECK(pthread_mutexattr_settype(&mutexAttr_, PTHREAD_MUTEX_NORMAL));
         MCHECK(pthread_mutex_init(&mutex_, &mutexAttr_));
@@ -145,7 +159,17 @@ public:
      */
     inline void lock() ACQUIRE() {
         // 顺序不能反
+#ifdef LUTE_MUTEX_PROFILING
+        if (pthread_mutex_trylock(&mutex_) == 0) {
+            profile_.acquired(false, 0);
+        } else {
+            uint64_t start = readCycles();
+            MCHECK(pthread_mutex_lock(&mutex_));
+            profile_.acquired(true, readCycles() - start);
+        }
+#else
         MCHECK(pthread_mutex_lock(&mutex_));
+#endif
         assignHolder();
     }
 
@@ -156,6 +180,9 @@ public:
      */
     inline void unlock() RELEASE() {
         unassignHolder();
+#ifdef LUTE_MUTEX_PROFILING
+        profile_.released();
+#endif
         MCHECK(pthread_mutex_unlock(&mutex_));
     }
 
@@ -173,6 +200,10 @@ private:
     pthread_mutex_t mutex_;
     /// @brief 持有该互斥量的线程ID pid_t
     pid_t holder_;
+#ifdef LUTE_MUTEX_PROFILING
+    /// @brief 竞争统计
+    LockProfile profile_;
+#endif
 
     inline void unassignHolder() { holder_ = 0; }
     /// @brief 持有该互斥量的线程 ID(tid)
@@ -189,9 +220,18 @@ private:
 
         explicit UnassignGuard(MutexLock& owner) : owner_(owner) {
             owner_.unassignHolder();
+#ifdef LUTE_MUTEX_PROFILING
+            // 条件变量等待期间不计入持有时间，重新拿到锁视为一次加锁
+            owner_.profile_.released();
+#endif
         }
 
-        ~UnassignGuard() { owner_.assignHolder(); }
+        ~UnassignGuard() {
+#ifdef LUTE_MUTEX_PROFILING
+            owner_.profile_.acquired(false, 0);
+#endif
+            owner_.assignHolder();
+        }
 
     private:
         MutexLock& owner_;
@@ -0,0 +1,254 @@
+/**
+ * @brief 对象池 ObjectPool<T>: 线程本地空闲链表 + 共享溢出链表
+ *
+ *  - acquire(args...) 在池中的空闲块上原地构造 T，release(obj) 析构 T 并
+ *    归还内存块；块只在池析构时还给堆，稳态运行不再分配
+ *  - 每个线程在每个池中有一条记录 (ThreadRecordList)，持有一条最多
+ *    localCacheSize 个块的空闲链表，命中时不涉及任何原子读改写
+ *  - 本地链表超过上限时把一半移入共享溢出链表；本地为空时从溢出链表
+ *    取回至多 localCacheSize + 1 个块。溢出链表由 SpinLock 保护，压入是
+ *    O(1) 的拼接，取回只走过取回的块，每 localCacheSize / 2 次操作才
+ *    进入一次临界区
+ *  - 线程退出时本地链表并入溢出链表，记录在池内复用，因此一个线程
+ *    acquire、另一个线程 release 的生产者/消费者模式同样适用
+ *  - stats(): hits (从空闲链表取得)、misses (向堆申请新块)、highWater
+ *    (向堆申请过的块数，即池占用内存的峰值)、inUse (尚未归还的对象数)；
+ *    计数器只由记录的持有者写入，读取时汇总
+ *  - T 的构造函数不应抛出异常
+ *
+ * @usage
+    static Lute::ObjectPool<Request>* pool = new Lute::ObjectPool<Request>;
+    Request* req = pool->acquire(fd);
+    ...
+    pool->release(req);
+
+    Lute::ObjectPool<Request>::Ptr ptr = pool->make(fd);  // 析构时归还
+ */
+
+#pragma once
+
+#include <Base/fastMutex.h>     // SpinLock
+#include <Base/threadRecord.h>  // ThreadRecordList
+
+#include <atomic>       // atomic
+#include <cassert>      // assert
+#include <cstddef>      // size_t
+#include <cstdint>      // uint64_t
+#include <memory>       // unique_ptr
+#include <new>          // placement new
+#include <type_traits>  // aligned_storage
+#include <utility>      // forward
+
+namespace Lute {
+template <typename T>
+class ObjectPool {
+public:
+    struct Stats {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t highWater;
+        int64_t inUse;
+    };
+
+    /// @brief unique_ptr 的删除器，把对象归还给池
+    class Deleter {
+    public:
+        Deleter(ObjectPool* pool = nullptr) : pool_(pool) {}
+        void operator()(T* obj) const { pool_->release(obj); }
+
+    private:
+        ObjectPool* pool_;
+    };
+    using Ptr = std::unique_ptr<T, Deleter>;
+
+    ///
+    /// @param localCacheSize 每个线程本地最多缓存的空闲块数，
+    ///        0 表示全部经过共享溢出链表 (适合体积很大的对象)
+    ///
+    explicit ObjectPool(size_t localCacheSize = 32)
+        : localCacheSize_(localCacheSize),
+          records_(&ObjectPool::releaseRecord),
+          overflow_(nullptr),
+          allocated_(0) {}
+
+    /// 析构时不能有其他线程访问，所有对象都应已归还
+    ~ObjectPool() {
+        assert(stats().inUse == 0);
+        freeChain(overflow_);
+        Record* r = records_.takeAll();
+        while (r != nullptr) {
+            freeChain(r->head);
+            Record* next = r->next;
+            delete r;
+            r = next;
+        }
+    }
+
+    /// non-copyable
+    ObjectPool(const ObjectPool&) = delete;
+    ObjectPool& operator=(const ObjectPool&) = delete;
+
+    ///
+    /// @brief 取得一个空闲块并以 args 构造 T
+    ///
+    template <typename... Args>
+    T* acquire(Args&&... args) {
+        Record* r = localRecord();
+        Block* block = r->head;
+        if (block != nullptr) {
+            r->head = block->next;
+            --r->count;
+            bump(r->hits);
+        } else if ((block = takeOverflow(r)) != nullptr) {
+            bump(r->hits);
+        } else {
+            block = new Block;
+            bump(r->misses);
+            allocated_.fetch_add(1, std::memory_order_relaxed);
+        }
+        bump(r->acquired);
+        return new (&block->storage) T(std::forward<Args>(args)...);
+    }
+
+    ///
+    /// @brief 析构 obj 并归还其内存块，可以在任意线程调用
+    ///
+    void release(T* obj) {
+        if (obj == nullptr) return;
+        obj->~T();
+        Block* block = reinterpret_cast<Block*>(obj);
+        Record* r = localRecord();
+        block->next = r->head;
+        r->head = block;
+        ++r->count;
+        bump(r->released);
+        if (r->count > localCacheSize_) {
+            spill(r, r->count - localCacheSize_ / 2);
+        }
+    }
+
+    /// @brief acquire() 并包装为析构时自动归还的 unique_ptr
+    template <typename... Args>
+    Ptr make(Args&&... args) {
+        return Ptr(acquire(std::forward<Args>(args)...), Deleter(this));
+    }
+
+    Stats stats() const {
+        Stats s = {0, 0, allocated_.load(std::memory_order_relaxed), 0};
+        uint64_t acquired = 0;
+        uint64_t released = 0;
+        records_.forEach([&](const Record* r) {
+            s.hits += r->hits.load(std::memory_order_relaxed);
+            s.misses += r->misses.load(std::memory_order_relaxed);
+            acquired += r->acquired.load(std::memory_order_relaxed);
+            released += r->released.load(std::memory_order_relaxed);
+        });
+        s.inUse = static_cast<int64_t>(acquired - released);
+        return s;
+    }
+
+    size_t localCacheSize() const { return localCacheSize_; }
+
+private:
+    /// 空闲时存放链表指针，使用时存放 T
+    union Block {
+        Block* next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    struct Record {
+        ObjectPool* pool = nullptr;
+        std::atomic<bool> inUse{false};
+        Record* next = nullptr;
+        /// 本地空闲链表，只由持有者访问
+        Block* head = nullptr;
+        size_t count = 0;
+        /// 只由持有者写入
+        std::atomic<uint64_t> hits{0};
+        std::atomic<uint64_t> misses{0};
+        std::atomic<uint64_t> acquired{0};
+        std::atomic<uint64_t> released{0};
+    };
+
+    static void bump(std::atomic<uint64_t>& counter) {
+        counter.store(counter.load(std::memory_order_relaxed) + 1,
+                      std::memory_order_relaxed);
+    }
+
+    static void freeChain(Block* block) {
+        while (block != nullptr) {
+            Block* next = block->next;
+            delete block;
+            block = next;
+        }
+    }
+
+    /// @brief 当前线程的记录，首次调用时登记，优先复用已退出线程的记录
+    Record* localRecord() {
+        Record* record = records_.current();
+        if (record != nullptr) return record;
+        return records_.acquire([this]() {
+            auto* r = new Record;
+            r->pool = this;
+            return r;
+        });
+    }
+
+    /// @brief 线程退出: 本地空闲块并入溢出链表，记录留待复用
+    static void releaseRecord(void* ptr) {
+        auto* record = static_cast<Record*>(ptr);
+        if (record->count > 0) record->pool->spill(record, record->count);
+        ThreadRecordList<Record>::release(record);
+    }
+
+    /// @brief 把本地链表头部的 n 个块移入溢出链表
+    void spill(Record* r, size_t n) {
+        Block* first = r->head;
+        Block* last = first;
+        for (size_t i = 1; i < n; ++i) last = last->next;
+        r->head = last->next;
+        r->count -= n;
+        pushOverflow(first, last);
+    }
+
+    void pushOverflow(Block* first, Block* last) {
+        SpinLockGuard lock(overflowLock_);
+        last->next = overflow_;
+        overflow_ = first;
+    }
+
+    ///
+    /// @brief 从溢出链表头部取回至多 localCacheSize_ + 1 个块: 返回第一个，
+    ///        其余放入 (为空的) 本地链表
+    ///
+    Block* takeOverflow(Record* r) {
+        Block* block;
+        Block* last;
+        size_t n = 0;
+        {
+            SpinLockGuard lock(overflowLock_);
+            block = overflow_;
+            if (block == nullptr) return nullptr;
+            last = block;
+            while (n < localCacheSize_ && last->next != nullptr) {
+                last = last->next;
+                ++n;
+            }
+            overflow_ = last->next;
+        }
+        last->next = nullptr;
+        r->head = block->next;
+        r->count = n;
+        return block;
+    }
+
+    const size_t localCacheSize_;
+    /// 所有线程记录 (包括空闲的)，只增不减
+    ThreadRecordList<Record> records_;
+    /// 共享溢出链表
+    SpinLock overflowLock_;
+    Block* overflow_ GUARDED_BY(overflowLock_);
+    /// 向堆申请过的块数
+    std::atomic<uint64_t> allocated_;
+};
+}  // namespace Lute
@@ -0,0 +1,285 @@
+/**
+ * @brief 基于 ThreadPool 的并行算法: parallelFor / parallelReduce /
+ *        parallelSort
+ *
+ *  - 递归二分: 区间大于 grain 时，右半部分作为任务提交 (可被空闲线程窃取)，
+ *    左半部分继续在当前线程拆分，负载不均时由 work-stealing 自动平衡
+ *  - grain 为 0 时按线程数自动选择: 区间划分为约 8 * 线程数 份
+ *  - 等待子任务时调用 ThreadPool::tryRunOne 帮助执行，工作线程内嵌套调用
+ *    也不会阻塞线程池；非工作线程没有可执行的任务时，自旋之后在 EventCount
+ *    上休眠，直到任务组完成
+ *  - 任务抛出的第一个异常在调用线程中重新抛出
+ *  - 不传入线程池时使用 defaultThreadPool()
+ *
+ * @usage
+    std::vector<double> v(1 << 20);
+    Lute::parallelFor(size_t(0), v.size(), size_t(0),
+                      [&v](size_t i) { v[i] = std::sqrt(i); });
+    double sum = Lute::parallelReduce(
+        size_t(0), v.size(), size_t(0), 0.0,
+        [&v](size_t i) { return v[i]; }, std::plus<double>());
+    Lute::parallelSort(v.begin(), v.end(), std::greater<double>());
+ */
+
+#pragma once
+
+#include <Base/atomic.h>      // cpuRelax
+#include <Base/futex.h>       // EventCount
+#include <Base/threadPool.h>  // ThreadPool
+
+#include <algorithm>    // sort, partition
+#include <atomic>       // atomic
+#include <exception>    // exception_ptr
+#include <functional>   // less
+#include <mutex>        // mutex
+#include <thread>       // yield
+#include <utility>      // move
+
+namespace Lute {
+///
+/// @brief 进程内共享的线程池，首次调用时按 CPU 核数启动
+///
+ThreadPool& defaultThreadPool();
+
+namespace detail {
+    ///
+    /// @brief 所有 TaskGroup 共用的完成通知，有意泄漏: 最后一个任务通知时
+    ///        等待者可能已经返回并析构了 TaskGroup
+    ///
+    EventCount& taskGroupDone();
+
+    ///
+    /// @brief 一组任务的完成计数，wait() 时帮助执行线程池中的任务
+    ///
+    class TaskGroup {
+    public:
+        explicit TaskGroup(ThreadPool& pool) : pool_(pool), pending_(0) {}
+
+        /// non-copyable
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+
+        template <typename F>
+        void run(F&& f) {
+            pending_.fetch_add(1, std::memory_order_relaxed);
+            pool_.run([this, f = std::forward<F>(f)]() mutable {
+                if (!failed()) {
+                    try {
+                        f();
+                    } catch (...) {
+                        setError(std::current_exception());
+                    }
+                }
+                if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                    taskGroupDone().notifyAll();
+                }
+            });
+        }
+
+        ///
+        /// @brief 等待全部任务完成，并重新抛出第一个异常
+        ///
+        void wait() {
+            // 工作线程不休眠: 休眠的工作线程无法执行之后进入注入队列的任务
+            const bool canPark = !pool_.inWorkerThread();
+            int idle = 0;
+            while (pending_.load(std::memory_order_acquire) > 0) {
+                if (pool_.tryRunOne()) {
+                    idle = 0;
+                } else if (++idle < 64) {
+                    cpuRelax();
+                } else if (idle < 128 || !canPark) {
+                    std::this_thread::yield();
+                } else {
+                    park();
+                }
+            }
+            if (error_) std::rethrow_exception(error_);
+        }
+
+        bool failed() const { return failed_.load(std::memory_order_relaxed); }
+
+        void setError(std::exception_ptr error) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) error_ = std::move(error);
+            failed_.store(true, std::memory_order_relaxed);
+        }
+
+    private:
+        /// @brief 剩余的任务都已被工作线程取走，休眠到任务组完成
+        void park() {
+            EventCount& done = taskGroupDone();
+            uint32_t key = done.prepareWait();
+            if (pending_.load(std::memory_order_acquire) == 0) {
+                done.cancelWait();
+            } else {
+                done.wait(key);
+            }
+        }
+
+        ThreadPool& pool_;
+        std::atomic<int64_t> pending_;
+        std::atomic<bool> failed_{false};
+        std::mutex mutex_;
+        std::exception_ptr error_;
+    };
+
+    ///
+    /// @brief 并行执行 left 与 right: right 作为任务提交，left 在当前线程执行
+    ///
+    template <typename Left, typename Right>
+    void parallelInvoke(ThreadPool& pool, Left&& left, Right&& right) {
+        TaskGroup group(pool);
+        group.run(std::forward<Right>(right));
+        try {
+            left();
+        } catch (...) {
+            group.setError(std::current_exception());
+        }
+        group.wait();
+    }
+
+    template <typename Index>
+    Index autoGrain(ThreadPool& pool, Index begin, Index end, Index grain) {
+        if (grain > 0) return grain;
+        Index n = end - begin;
+        auto parts = static_cast<Index>(8 * (pool.numThreads() + 1));
+        return n / parts > 0 ? n / parts : 1;
+    }
+
+    template <typename Index, typename Fn>
+    void forRange(TaskGroup& group, Index begin, Index end, Index grain,
+                  const Fn& fn) {
+        // 右半部分提交为任务，左半部分继续拆分
+        while (end - begin > grain) {
+            Index mid = begin + (end - begin) / 2;
+            group.run([&group, mid, end, grain, &fn]() {
+                forRange(group, mid, end, grain, fn);
+            });
+            end = mid;
+        }
+        if (group.failed()) return;
+        for (Index i = begin; i < end; ++i) fn(i);
+    }
+
+    template <typename Index, typename T, typename Map, typename Combine>
+    T reduceRange(ThreadPool& pool, Index begin, Index end, Index grain,
+                  const T& identity, const Map& map, const Combine& combine) {
+        if (end - begin <= grain) {
+            T acc = identity;
+            for (Index i = begin; i < end; ++i) acc = combine(acc, map(i));
+            return acc;
+        }
+        Index mid = begin + (end - begin) / 2;
+        T left = identity;
+        T right = identity;
+        parallelInvoke(
+            pool,
+            [&]() {
+                left = reduceRange(pool, begin, mid, grain, identity, map,
+                                   combine);
+            },
+            [&]() {
+                right =
+                    reduceRange(pool, mid, end, grain, identity, map, combine);
+            });
+        // 保持左右顺序，combine 只需满足结合律
+        return combine(left, right);
+    }
+
+    template <typename RandomIt, typename Compare>
+    void sortRange(ThreadPool& pool, RandomIt first, RandomIt last,
+                   const Compare& comp, size_t grain, int depth) {
+        auto n = static_cast<size_t>(last - first);
+        if (n <= grain || depth <= 0) {
+            std::sort(first, last, comp);
+            return;
+        }
+
+        // 三数取中作为枢轴，三路划分: [< pivot) [== pivot) [> pivot)
+        RandomIt mid = first + n / 2;
+        RandomIt back = last - 1;
+        if (comp(*mid, *first)) std::iter_swap(mid, first);
+        if (comp(*back, *mid)) std::iter_swap(back, mid);
+        if (comp(*mid, *first)) std::iter_swap(mid, first);
+        auto pivot = *mid;
+        RandomIt lower = std::partition(
+            first, last, [&](const auto& x) { return comp(x, pivot); });
+        RandomIt upper = std::partition(
+            lower, last, [&](const auto& x) { return !comp(pivot, x); });
+
+        parallelInvoke(
+            pool,
+            [&]() { sortRange(pool, first, lower, comp, grain, depth - 1); },
+            [&]() { sortRange(pool, upper, last, comp, grain, depth - 1); });
+    }
+}  // namespace detail
+
+///
+/// @brief 对 [begin, end) 中的每个 i 并行调用 fn(i)
+/// @param grain 不再拆分的最小区间长度，0 表示自动选择
+///
+template <typename Index, typename Fn>
+void parallelFor(ThreadPool& pool, Index begin, Index end, Index grain,
+                 Fn&& fn) {
+    if (end <= begin) return;
+    grain = detail::autoGrain(pool, begin, end, grain);
+    detail::TaskGroup group(pool);
+    try {
+        detail::forRange(group, begin, end, grain, fn);
+    } catch (...) {
+        group.setError(std::current_exception());
+    }
+    group.wait();
+}
+
+template <typename Index, typename Fn>
+void parallelFor(Index begin, Index end, Index grain, Fn&& fn) {
+    parallelFor(defaultThreadPool(), begin, end, grain, std::forward<Fn>(fn));
+}
+
+///
+/// @brief 并行计算 combine(...combine(identity, map(begin))..., map(end - 1))
+/// @param combine 须满足结合律，各区间的结果按从左到右的顺序合并
+///
+template <typename Index, typename T, typename Map, typename Combine>
+T parallelReduce(ThreadPool& pool, Index begin, Index end, Index grain,
+                 T identity, const Map& map, const Combine& combine) {
+    if (end <= begin) return identity;
+    grain = detail::autoGrain(pool, begin, end, grain);
+    return detail::reduceRange(pool, begin, end, grain, identity, map,
+                               combine);
+}
+
+template <typename Index, typename T, typename Map, typename Combine>
+T parallelReduce(Index begin, Index end, Index grain, T identity,
+                 const Map& map, const Combine& combine) {
+    return parallelReduce(defaultThreadPool(), begin, end, grain,
+                          std::move(identity), map, combine);
+}
+
+///
+/// @brief 并行快速排序 (不稳定)，小区间或递归过深时退化为 std::sort
+///
+template <typename RandomIt, typename Compare>
+void parallelSort(ThreadPool& pool, RandomIt first, RandomIt last,
+                  Compare comp) {
+    const size_t kMinGrain = 4096;
+    auto n = static_cast<size_t>(last - first);
+    size_t grain = n / (8 * (pool.numThreads() + 1));
+    if (grain < kMinGrain) grain = kMinGrain;
+    int depth = 0;
+    for (size_t i = n; i > 1; i >>= 1) depth += 2;
+    detail::sortRange(pool, first, last, comp, grain, depth);
+}
+
+template <typename RandomIt, typename Compare>
+void parallelSort(RandomIt first, RandomIt last, Compare comp) {
+    parallelSort(defaultThreadPool(), first, last, comp);
+}
+
+template <typename RandomIt>
+void parallelSort(RandomIt first, RandomIt last) {
+    parallelSort(defaultThreadPool(), first, last, std::less<>());
+}
+}  // namespace Lute
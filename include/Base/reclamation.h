@@ -0,0 +1,294 @@
+/**
+ * @brief 无锁数据结构的安全内存回收: 基于纪元的回收 (EBR) 与 hazard pointer
+ *
+ *  - 被摘除的节点通过 retire(ptr, deleter) 交给回收域，确认没有读者还能
+ *    访问它之后才调用 deleter
+ *  - 每个线程在每个域中有一条记录，首次使用时登记 (记录 CurrentThread::tid)，
+ *    线程退出时通过 pthread key 的析构函数归还，记录本身在域内复用
+ *  - retire 先放入线程本地的批次，攒够 kBatchSize 个再并入域的待回收列表；
+ *    没有后台回收线程时由 retire 的调用者顺带回收
+ *  - startReclaimer(intervalMs) 启动一个 Lute::Thread 周期性回收，
+ *    retire 的调用方不再承担回收开销
+ *  - 域析构时认为已没有读者，释放全部待回收对象
+ *
+ *  EpochDomain: 读者进入临界区时公布当前全局纪元，所有活跃读者都已看到
+ *    纪元 e 时全局纪元才能推进到 e + 1；纪元 e 退休的对象在全局纪元到达
+ *    e + 2 时释放。读者开销只有一次存储和一个栅栏，但一个长时间停留在
+ *    临界区的读者会阻止所有回收
+ *  HazardPointerDomain: 读者逐个公布正在访问的指针，回收时跳过被公布的
+ *    对象。读者每次保护一个指针需要一次存储、栅栏和复查，但待回收的对象数
+ *    有上界，不受慢读者影响
+ *
+ * @usage
+    Lute::EpochDomain ebr;
+    ebr.startReclaimer();
+    {
+        Lute::EpochDomain::Guard guard(ebr);
+        Node* node = head.load(std::memory_order_acquire);
+        use(node);  // 临界区内 node 不会被释放
+    }
+    Node* old = head.exchange(newNode);
+    ebr.retire(old);
+
+    Lute::HazardPointerDomain hpDomain;
+    {
+        Lute::HazardPointer hp(hpDomain);
+        Node* node = hp.protect(head);
+        use(node);  // hp 保护期间 node 不会被释放
+    }
+ */
+
+#pragma once
+
+#include <Base/barrier.h>       // Event
+#include <Base/fastMutex.h>     // FastMutex
+#include <Base/thread.h>        // Thread
+#include <Base/threadRecord.h>  // ThreadRecordList
+
+#include <atomic>   // atomic
+#include <cstddef>  // size_t
+#include <cstdint>  // uint64_t
+#include <memory>   // unique_ptr
+#include <vector>   // vector
+
+namespace Lute {
+///
+/// @brief 回收域的公共部分: 线程记录、retire 批次与后台回收线程
+///
+class ReclaimDomain {
+public:
+    using Deleter = void (*)(void*);
+
+    /// 线程本地批次攒够这么多个对象后并入域的待回收列表
+    static const size_t kBatchSize = 64;
+
+    /// non-copyable
+    ReclaimDomain(const ReclaimDomain&) = delete;
+    ReclaimDomain& operator=(const ReclaimDomain&) = delete;
+
+    ///
+    /// @brief 退休一个已从数据结构中摘除的对象，安全之后调用 deleter(ptr)
+    ///
+    void retire(void* ptr, Deleter deleter);
+
+    /// @brief 以 delete 释放
+    template <typename T>
+    void retire(T* ptr) {
+        retire(static_cast<void*>(ptr),
+               [](void* p) { delete static_cast<T*>(p); });
+    }
+
+    ///
+    /// @brief 并入当前线程的批次，释放所有已经安全的对象
+    /// @return 释放的对象数
+    ///
+    size_t reclaim();
+
+    ///
+    /// @brief 启动后台回收线程，每 intervalMs 毫秒回收一次
+    ///
+    void startReclaimer(int intervalMs = 10);
+    void stopReclaimer();
+
+    /// @brief 已并入域、尚未释放的对象数 (不含各线程本地批次)
+    size_t pending() const;
+
+    /// @brief 已释放的对象总数
+    uint64_t reclaimed() const {
+        return reclaimed_.load(std::memory_order_relaxed);
+    }
+
+protected:
+    struct Retired {
+        void* ptr;
+        Deleter deleter;
+        /// EpochDomain: 退休时的全局纪元
+        uint64_t epoch;
+    };
+
+    struct Record {
+        virtual ~Record() = default;
+
+        ReclaimDomain* domain = nullptr;
+        std::atomic<bool> inUse{false};
+        /// 持有该记录的线程 ID
+        int tid = 0;
+        Record* next = nullptr;
+        /// 只由持有者访问
+        std::vector<Retired> batch;
+    };
+
+    ReclaimDomain();
+    virtual ~ReclaimDomain();
+
+    ///
+    /// @brief 派生类析构时调用: 停止后台线程，释放全部对象与记录
+    ///
+    void shutdown();
+
+    /// @brief 当前线程的记录，首次调用时登记
+    Record* localRecord();
+
+    /// @brief 遍历所有记录 (包括空闲的)
+    template <typename Func>
+    void forEachRecord(Func func) const {
+        records_.forEach(func);
+    }
+
+    /// @name 派生类实现
+    /// @{
+    virtual Record* newRecord() = 0;
+    /// @brief 线程退出、归还记录之前调用
+    virtual void onRelease(Record* record) = 0;
+    /// @brief 退休时为对象打上标记 (EpochDomain 记录纪元)
+    virtual uint64_t stamp() { return 0; }
+    ///
+    /// @brief 从 candidates 中移出可以安全释放的对象到 freeable，
+    ///        不持有域的锁
+    ///
+    virtual void collect(std::vector<Retired>* candidates,
+                         std::vector<Retired>* freeable) = 0;
+    /// @}
+
+private:
+    static void releaseRecord(void* record);
+    void flush(Record* record);
+    void reclaimerFunc(int intervalMs);
+
+    ThreadRecordList<Record> records_;
+
+    mutable FastMutex mutex_;
+    std::vector<Retired> pending_ GUARDED_BY(mutex_);
+    std::atomic<uint64_t> reclaimed_;
+
+    std::atomic<bool> reclaimerRunning_;
+    Event stopReclaimer_;
+    std::unique_ptr<Thread> reclaimer_;
+};
+
+///
+/// @brief 基于纪元的回收域
+///
+class EpochDomain : public ReclaimDomain {
+public:
+    EpochDomain();
+    ~EpochDomain() override;
+
+    ///
+    /// @brief 进入读临界区，可以嵌套
+    ///
+    void enter();
+    void leave();
+
+    /// @brief 读临界区的作用域守卫
+    class Guard {
+    public:
+        explicit Guard(EpochDomain& domain) : domain_(domain) {
+            domain_.enter();
+        }
+        ~Guard() { domain_.leave(); }
+
+        /// non-copyable
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        EpochDomain& domain_;
+    };
+
+    uint64_t epoch() const { return epoch_.load(std::memory_order_acquire); }
+
+    ///
+    /// @brief 所有活跃读者都已看到当前纪元时推进全局纪元
+    /// @return 是否推进
+    ///
+    bool tryAdvance();
+
+private:
+    struct EpochRecord : Record {
+        /// 读者公布的纪元，0 表示不在临界区
+        std::atomic<uint64_t> epoch{0};
+        /// 嵌套深度，只由持有者访问
+        int nest = 0;
+    };
+
+    Record* newRecord() override { return new EpochRecord; }
+    void onRelease(Record* record) override;
+    uint64_t stamp() override;
+    void collect(std::vector<Retired>* candidates,
+                 std::vector<Retired>* freeable) override;
+
+    /// 从 2 开始，纪元 0 表示不在临界区
+    std::atomic<uint64_t> epoch_;
+};
+
+///
+/// @brief hazard pointer 回收域
+///
+class HazardPointerDomain : public ReclaimDomain {
+public:
+    /// 每个线程可以同时持有的 hazard pointer 数
+    static const int kHazardsPerThread = 4;
+
+    HazardPointerDomain();
+    ~HazardPointerDomain() override;
+
+private:
+    friend class HazardPointer;
+
+    struct HazardRecord : Record {
+        std::atomic<void*> hazards[kHazardsPerThread] = {};
+        /// 已分配的槽位，只由持有者访问
+        unsigned used = 0;
+    };
+
+    /// @brief 分配当前线程的一个空闲槽位
+    std::atomic<void*>* acquireSlot();
+    void releaseSlot(std::atomic<void*>* slot);
+
+    Record* newRecord() override { return new HazardRecord; }
+    void onRelease(Record* record) override;
+    void collect(std::vector<Retired>* candidates,
+                 std::vector<Retired>* freeable) override;
+};
+
+///
+/// @brief 占用当前线程的一个 hazard pointer 槽位，析构时归还
+///
+class HazardPointer {
+public:
+    explicit HazardPointer(HazardPointerDomain& domain)
+        : domain_(domain), slot_(domain.acquireSlot()) {}
+    ~HazardPointer() { domain_.releaseSlot(slot_); }
+
+    /// non-copyable
+    HazardPointer(const HazardPointer&) = delete;
+    HazardPointer& operator=(const HazardPointer&) = delete;
+
+    ///
+    /// @brief 读取 src 并公布，直到公布的值与 src 一致；
+    ///        返回的指针在 reset() 或析构之前不会被释放
+    ///
+    template <typename T>
+    T* protect(const std::atomic<T*>& src) {
+        T* ptr = src.load(std::memory_order_relaxed);
+        for (;;) {
+            slot_->store(ptr, std::memory_order_seq_cst);
+            T* again = src.load(std::memory_order_seq_cst);
+            if (again == ptr) return ptr;
+            ptr = again;
+        }
+    }
+
+    ///
+    /// @brief 直接公布 ptr，调用方须自行确认公布之后 ptr 仍可达
+    ///
+    void set(void* ptr) { slot_->store(ptr, std::memory_order_seq_cst); }
+
+    void reset() { slot_->store(nullptr, std::memory_order_release); }
+
+private:
+    HazardPointerDomain& domain_;
+    std::atomic<void*>* slot_;
+};
+}  // namespace Lute
@@ -0,0 +1,229 @@
+/**
+ * @brief 读写锁 RWLock 与顺序锁 SeqLock
+ *
+ *  - RWLock: pthread_rwlock_t 封装，写者优先: 有写者等待时新的读者阻塞，
+ *    读多写少时写者不会被持续到来的读者饿死；带 ACQUIRE_SHARED /
+ *    RELEASE_SHARED 注解，配合 ReaderLockGuard / WriterLockGuard 使用
+ *  - SeqLock<T>: 适用于频繁读取、很少修改的小结构体 (T 须可平凡复制)。
+ *    读者不写任何共享内存，只在读取期间有写入时重试；写者之间用 SpinLock
+ *    互斥。数据按 8 字节原子字存储，读写并发时没有数据竞争
+ *
+ * @usage
+    Lute::RWLock lock;
+    Lute::ini::INIStructure config GUARDED_BY(lock);
+    {
+        Lute::ReaderLockGuard guard(lock);  // 所有线程可同时读取
+        std::string level = config.get("log").get("level");
+    }
+    {
+        Lute::WriterLockGuard guard(lock);  // 重新加载配置
+        ini.read(config);
+    }
+
+    struct Route { uint32_t ip; uint16_t port; };
+    Lute::SeqLock<Route> route(Route{0x7F000001, 8080});
+    Route r = route.load();
+    route.store(Route{0x7F000001, 9090});
+ */
+
+#pragma once
+
+#include <Base/atomic.h>     // cpuRelax
+#include <Base/fastMutex.h>  // SpinLock
+#include <Base/mutex.h>      // MCHECK, CAPABILITY
+#include <pthread.h>
+
+#include <atomic>       // atomic
+#include <cstdint>      // uint64_t
+#include <cstring>      // memcpy
+#include <type_traits>  // is_trivially_copyable
+
+namespace Lute {
+
+///
+/// @brief 写者优先的读写锁，不可重入
+///
+class CAPABILITY("mutex") RWLock {
+public:
+    RWLock() {
+        pthread_rwlockattr_t attr;
+        MCHECK(pthread_rwlockattr_init(&attr));
+        // glibc 默认读者优先，且只有 NONRECURSIVE 版本才真正让写者优先
+        MCHECK(pthread_rwlockattr_setkind_np(
+            &attr, PTHREAD_RWLOCK_PREFER_WRITER_NONRECURSIVE_NP));
+        MCHECK(pthread_rwlock_init(&rwlock_, &attr));
+        MCHECK(pthread_rwlockattr_destroy(&attr));
+    }
+
+    ~RWLock() { MCHECK(pthread_rwlock_destroy(&rwlock_)); }
+
+    /// non-copyable
+    RWLock(const RWLock&) = delete;
+    RWLock& operator=(const RWLock&) = delete;
+
+    /// @brief 独占 (写) 锁
+    void lock() ACQUIRE() { MCHECK(pthread_rwlock_wrlock(&rwlock_)); }
+
+    bool tryLock() TRY_ACQUIRE(true) {
+        return pthread_rwlock_trywrlock(&rwlock_) == 0;
+    }
+
+    void unlock() RELEASE() { MCHECK(pthread_rwlock_unlock(&rwlock_)); }
+
+    /// @brief 共享 (读) 锁
+    void lockShared() ACQUIRE_SHARED() {
+        MCHECK(pthread_rwlock_rdlock(&rwlock_));
+    }
+
+    bool tryLockShared() TRY_ACQUIRE_SHARED(true) {
+        return pthread_rwlock_tryrdlock(&rwlock_) == 0;
+    }
+
+    void unlockShared() RELEASE_SHARED() {
+        MCHECK(pthread_rwlock_unlock(&rwlock_));
+    }
+
+private:
+    pthread_rwlock_t rwlock_;
+};
+
+///
+/// @brief 读锁的作用域守卫
+///
+class SCOPED_CAPABILITY ReaderLockGuard {
+public:
+    /// non-copyable
+    ReaderLockGuard(const ReaderLockGuard&) = delete;
+    ReaderLockGuard& operator=(const ReaderLockGuard&) = delete;
+
+    explicit ReaderLockGuard(RWLock& lock) ACQUIRE_SHARED(lock) : lock_(lock) {
+        lock_.lockShared();
+    }
+    ~ReaderLockGuard() RELEASE() { lock_.unlockShared(); }
+
+private:
+    RWLock& lock_;
+};
+
+///
+/// @brief 写锁的作用域守卫
+///
+class SCOPED_CAPABILITY WriterLockGuard {
+public:
+    /// non-copyable
+    WriterLockGuard(const WriterLockGuard&) = delete;
+    WriterLockGuard& operator=(const WriterLockGuard&) = delete;
+
+    explicit WriterLockGuard(RWLock& lock) ACQUIRE(lock) : lock_(lock) {
+        lock_.lock();
+    }
+    ~WriterLockGuard() RELEASE() { lock_.unlock(); }
+
+private:
+    RWLock& lock_;
+};
+
+///
+/// @brief 顺序锁保护的值
+/// @tparam T 可平凡复制的类型，适合不超过几个缓存行的小结构体
+///
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "SeqLock requires a trivially copyable type");
+
+public:
+    SeqLock() : SeqLock(T()) {}
+    explicit SeqLock(const T& value) : seq_(0) { storeWords(value); }
+
+    /// non-copyable
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    ///
+    /// @brief 读取一致的快照，读取期间有写入时重试
+    ///
+    T load() const {
+        for (;;) {
+            uint64_t begin = seq_.load(std::memory_order_acquire);
+            if (begin & 1) {  // 写入进行中
+                cpuRelax();
+                continue;
+            }
+            T value = loadWords();
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (seq_.load(std::memory_order_relaxed) == begin) return value;
+        }
+    }
+
+    void store(const T& value) {
+        SpinLockGuard guard(writer_);
+        beginWrite();
+        storeWords(value);
+        endWrite();
+    }
+
+    ///
+    /// @brief 在写者互斥下读取-修改-写回，f 的签名为 void(T&)
+    ///
+    template <typename F>
+    void update(F&& f) {
+        SpinLockGuard guard(writer_);
+        T value = loadWords();
+        f(value);
+        beginWrite();
+        storeWords(value);
+        endWrite();
+    }
+
+    ///
+    /// @brief 写入次数，可用于判断值是否被修改过
+    ///
+    uint64_t version() const {
+        return seq_.load(std::memory_order_acquire) >> 1;
+    }
+
+private:
+    static constexpr size_t kWords = (sizeof(T) + 7) / 8;
+
+    void beginWrite() {
+        seq_.store(seq_.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_relaxed);
+        // 序号变为奇数之后才能写数据
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void endWrite() {
+        seq_.store(seq_.load(std::memory_order_relaxed) + 1,
+                   std::memory_order_release);
+    }
+
+    /// @brief 与写者并发时可能读到不一致的值，由调用者根据序号丢弃
+    T loadWords() const {
+        uint64_t buf[kWords];
+        for (size_t i = 0; i < kWords; ++i) {
+            buf[i] = words_[i].load(std::memory_order_relaxed);
+        }
+        T value;
+        std::memcpy(&value, buf, sizeof(T));
+        return value;
+    }
+
+    void storeWords(const T& value) {
+        uint64_t buf[kWords] = {};
+        std::memcpy(buf, &value, sizeof(T));
+        for (size_t i = 0; i < kWords; ++i) {
+            words_[i].store(buf[i], std::memory_order_relaxed);
+        }
+    }
+
+    std::atomic<uint64_t> seq_;
+    std::atomic<uint64_t> words_[kWords];
+    SpinLock writer_;
+};
+
+}  // namespace Lute
+
+// 防止误用：ReaderLockGuard(lock_) 产生的临时对象马上被销毁，没有锁住临界区
+#define ReaderLockGuard(x) error "Missing guard object name"
+#define WriterLockGuard(x) error "Missing guard object name"
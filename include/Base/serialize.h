@@ -0,0 +1,453 @@
+///
+/// @brief 基于 ByteArray 的结构体序列化 / 反序列化
+///
+/// 通过 LUTE_SERIALIZE 宏在编译期登记结构体字段，自动生成编码 / 解码代码，
+/// 不再需要手写 writeFint32 / writeStringVint 等逐字段调用。
+///
+/// 编码规则与 ByteArray 的手写接口保持一致:
+///     - 算术类型 / 枚举: 定长，按 ByteArray 的字节序 (同 writeFint* /
+///       writeFloat / writeDouble)，bool 占 1 字节；不支持 long double
+///     - std::string: 同 writeStringVint
+///     - std::vector<T>: 元素个数 (varint) + 逐个元素
+///     - 已登记的结构体: 按登记顺序逐个字段，可嵌套
+///
+/// @details 结构体开头连续的定长字段在编译期合并，打包到栈上缓冲后
+///          一次 write / read 完成；全部字段定长的结构体整体只需一次拷贝。
+///          serialize() 先计算精确的编码长度并调用 ByteArray::reserve，
+///          保证编码过程中只分配一次内存块。
+///          支持任意字节序策略的 BasicByteArray，编译期固定字节序时
+///          是否 byteswap 同样在编译期确定。
+///
+/// @example
+///     namespace app {
+///     struct Point {
+///         int32_t x;
+///         int32_t y;
+///         std::string tag;
+///     };
+///     LUTE_SERIALIZE(Point, x, y, tag)  // 必须与 Point 在同一命名空间
+///     }  // namespace app
+///
+///     Lute::ByteArray ba;
+///     Lute::serialize(ba, app::Point{1, 2, "origin"});
+///     ba.setPosition(0);
+///     auto p = Lute::deserialize<app::Point>(ba);
+///
+
+#pragma once
+
+#include <Base/bytearray.h>  // BasicByteArray
+#include <Base/endian.h>     // byteswap
+
+#include <algorithm>    // min
+#include <cstdint>      // uint8_t, uint16_t, uint32_t, uint64_t
+#include <cstring>      // memcpy
+#include <stdexcept>    // out_of_range
+#include <string>       // string
+#include <tuple>        // tie, get, apply
+#include <type_traits>  // enable_if, void_t
+#include <utility>      // index_sequence
+#include <vector>       // vector
+
+/// NOTE 登记字段的宏展开，最多支持 16 个字段
+#define LUTE_PP_CAT(a, b) LUTE_PP_CAT_(a, b)
+#define LUTE_PP_CAT_(a, b) a##b
+#define LUTE_PP_NARG(...)                                                  \
+    LUTE_PP_NARG_(__VA_ARGS__, 16, 15, 14, 13, 12, 11, 10, 9, 8, 7, 6, 5, 4, \
+                  3, 2, 1, 0)
+#define LUTE_PP_NARG_(_1, _2, _3, _4, _5, _6, _7, _8, _9, _10, _11, _12, _13, \
+                      _14, _15, _16, N, ...)                                  \
+    N
+
+#define LUTE_PP_FIELDS_1(o, x) o.x
+#define LUTE_PP_FIELDS_2(o, x, ...) o.x, LUTE_PP_FIELDS_1(o, __VA_ARGS__)
+#define LUTE_PP_FIELDS_3(o, x, ...) o.x, LUTE_PP_FIELDS_2(o, __VA_ARGS__)
+#define LUTE_PP_FIELDS_4(o, x, ...) o.x, LUTE_PP_FIELDS_3(o, __VA_ARGS__)
+#define LUTE_PP_FIELDS_5(o, x, ...) o.x, LUTE_PP_FIELDS_4(o, __VA_ARGS__)
+#define LUTE_PP_FIELDS_6(o, x, ...) o.x, LUTE_PP_FIELDS_5(o, __VA_ARGS__)
+#define LUTE_PP_FIELDS_7(o, x, ...) o.x, LUTE_PP_FIELDS_6(o, __VA_ARGS__)
+#define LUTE_PP_FIELDS_8(o, x, ...) o.x, LUTE_PP_FIELDS_7(o, __VA_ARGS__)
+#define LUTE_PP_FIELDS_9(o, x, ...) o.x, LUTE_PP_FIELDS_8(o, __VA_ARGS__)
+#define LUTE_PP_FIELDS_10(o, x, ...) o.x, LUTE_PP_FIELDS_9(o, __VA_ARGS__)
+#define LUTE_PP_FIELDS_11(o, x, ...) o.x, LUTE_PP_FIELDS_10(o, __VA_ARGS__)
+#define LUTE_PP_FIELDS_12(o, x, ...) o.x, LUTE_PP_FIELDS_11(o, __VA_ARGS__)
+#define LUTE_PP_FIELDS_13(o, x, ...) o.x, LUTE_PP_FIELDS_12(o, __VA_ARGS__)
+#define LUTE_PP_FIELDS_14(o, x, ...) o.x, LUTE_PP_FIELDS_13(o, __VA_ARGS__)
+#define LUTE_PP_FIELDS_15(o, x, ...) o.x, LUTE_PP_FIELDS_14(o, __VA_ARGS__)
+#define LUTE_PP_FIELDS_16(o, x, ...) o.x, LUTE_PP_FIELDS_15(o, __VA_ARGS__)
+#define LUTE_PP_FIELDS(o, ...) \
+    LUTE_PP_CAT(LUTE_PP_FIELDS_, LUTE_PP_NARG(__VA_ARGS__))(o, __VA_ARGS__)
+
+///
+/// @brief 登记结构体 Type 参与序列化的字段 (按编码顺序)
+/// @note 须在 Type 所在的命名空间中使用，通过 ADL 查找
+///
+#define LUTE_SERIALIZE(Type, ...)                                \
+    inline auto luteSerializeFields(Type& luteValue) {           \
+        return std::tie(LUTE_PP_FIELDS(luteValue, __VA_ARGS__)); \
+    }                                                            \
+    inline auto luteSerializeFields(const Type& luteValue) {     \
+        return std::tie(LUTE_PP_FIELDS(luteValue, __VA_ARGS__)); \
+    }
+
+namespace Lute {
+namespace detail {
+    template <size_t N>
+    struct UIntOfSize;
+    template <>
+    struct UIntOfSize<1> {
+        using type = uint8_t;
+    };
+    template <>
+    struct UIntOfSize<2> {
+        using type = uint16_t;
+    };
+    template <>
+    struct UIntOfSize<4> {
+        using type = uint32_t;
+    };
+    template <>
+    struct UIntOfSize<8> {
+        using type = uint64_t;
+    };
+
+    /// @brief T 是否通过 LUTE_SERIALIZE 登记
+    template <typename T, typename = void>
+    struct IsRegistered : std::false_type {};
+    template <typename T>
+    struct IsRegistered<
+        T, std::void_t<decltype(luteSerializeFields(std::declval<T&>()))>>
+        : std::true_type {};
+
+    template <typename T>
+    struct IsVector : std::false_type {};
+    template <typename T, typename A>
+    struct IsVector<std::vector<T, A>> : std::true_type {};
+
+    template <typename T>
+    constexpr bool kIsScalar = std::is_arithmetic<T>::value ||
+                               std::is_enum<T>::value;
+
+    ///
+    /// @brief 定长类型的编码长度，变长类型为 0
+    ///
+    template <typename T, typename = void>
+    struct FixedSize : std::integral_constant<size_t, 0> {};
+
+    template <typename T>
+    struct FixedSize<T, std::enable_if_t<kIsScalar<T>>>
+        : std::integral_constant<size_t, sizeof(T)> {};
+
+    template <typename Tuple>
+    struct FieldsFixedSize;
+    template <typename... Fs>
+    struct FieldsFixedSize<std::tuple<Fs...>> {
+        static constexpr bool kAllFixed =
+            (true && ... && (FixedSize<std::decay_t<Fs>>::value > 0));
+        static constexpr size_t value =
+            kAllFixed ? (size_t(0) + ... + FixedSize<std::decay_t<Fs>>::value)
+                      : 0;
+    };
+
+    template <typename T>
+    using FieldsOf = decltype(luteSerializeFields(std::declval<const T&>()));
+
+    /// 所有字段都定长的结构体同样视为定长
+    template <typename T>
+    struct FixedSize<T, std::enable_if_t<IsRegistered<T>::value>>
+        : std::integral_constant<size_t,
+                                 FieldsFixedSize<FieldsOf<T>>::value> {};
+
+    ///
+    /// @brief 开头连续的定长字段个数
+    ///
+    template <typename Tuple>
+    struct FixedPrefix;
+    template <typename... Fs>
+    struct FixedPrefix<std::tuple<Fs...>> {
+        static constexpr size_t count() {
+            constexpr size_t sizes[] = {FixedSize<std::decay_t<Fs>>::value...,
+                                        0};
+            size_t n = 0;
+            while (n < sizeof...(Fs) && sizes[n] > 0) ++n;
+            return n;
+        }
+        static constexpr size_t bytes() {
+            constexpr size_t sizes[] = {FixedSize<std::decay_t<Fs>>::value...,
+                                        0};
+            size_t total = 0;
+            for (size_t i = 0; i < count(); ++i) total += sizes[i];
+            return total;
+        }
+    };
+
+    /// @brief 与 ByteArray::writeUint64 一致的 varint 长度
+    inline size_t varintSize(uint64_t v) {
+        size_t n = 1;
+        while (v >= 0x80) {
+            v >>= 7;
+            ++n;
+        }
+        return n;
+    }
+
+    template <typename T>
+    void packFixed(char*& p, const T& v, bool swap) {
+        if constexpr (std::is_same<T, bool>::value) {
+            *p++ = v ? 1 : 0;
+        } else if constexpr (kIsScalar<T>) {
+            static_assert(sizeof(T) <= 8,
+                          "scalars wider than 8 bytes (long double) are not "
+                          "serializable");
+            using U = typename UIntOfSize<sizeof(T)>::type;
+            U u;
+            ::memcpy(&u, &v, sizeof(u));
+            if constexpr (sizeof(T) > 1) {
+                if (swap) u = byteswap(u);
+            }
+            ::memcpy(p, &u, sizeof(u));
+            p += sizeof(u);
+        } else {
+            std::apply([&](const auto&... f) { (packFixed(p, f, swap), ...); },
+                       luteSerializeFields(v));
+        }
+    }
+
+    template <typename T>
+    void unpackFixed(const char*& p, T& v, bool swap) {
+        if constexpr (std::is_same<T, bool>::value) {
+            v = *p++ != 0;
+        } else if constexpr (kIsScalar<T>) {
+            static_assert(sizeof(T) <= 8,
+                          "scalars wider than 8 bytes (long double) are not "
+                          "serializable");
+            using U = typename UIntOfSize<sizeof(T)>::type;
+            U u;
+            ::memcpy(&u, p, sizeof(u));
+            if constexpr (sizeof(T) > 1) {
+                if (swap) u = byteswap(u);
+            }
+            ::memcpy(&v, &u, sizeof(u));
+            p += sizeof(u);
+        } else {
+            std::apply([&](auto&... f) { (unpackFixed(p, f, swap), ...); },
+                       luteSerializeFields(v));
+        }
+    }
+
+    template <typename T>
+    size_t encodedSize(const T& v);
+
+    template <typename... Fs>
+    size_t fieldsSize(const std::tuple<Fs...>& fields) {
+        return std::apply(
+            [](const auto&... f) { return (size_t(0) + ... + encodedSize(f)); },
+            fields);
+    }
+
+    template <typename T>
+    size_t encodedSize(const T& v) {
+        if constexpr (FixedSize<T>::value > 0) {
+            return FixedSize<T>::value;
+        } else if constexpr (std::is_same<T, std::string>::value) {
+            return varintSize(v.size()) + v.size();
+        } else if constexpr (IsVector<T>::value) {
+            using E = typename T::value_type;
+            size_t n = varintSize(v.size());
+            if constexpr (FixedSize<E>::value > 0) {
+                return n + v.size() * FixedSize<E>::value;
+            } else {
+                for (const auto& e : v) n += encodedSize(e);
+                return n;
+            }
+        } else {
+            static_assert(IsRegistered<T>::value,
+                          "type is not serializable, use LUTE_SERIALIZE");
+            return fieldsSize(luteSerializeFields(v));
+        }
+    }
+
+    template <typename BA, typename T>
+    void encode(BA& ba, const T& v, bool swap);
+    template <typename BA, typename T>
+    void decode(BA& ba, T& v, bool swap);
+
+    /// 定长元素的数组按块打包，避免逐元素调用 write
+    constexpr size_t kPackChunk = 4096;
+
+    template <typename BA, typename T>
+    void encodeVector(BA& ba, const T& v, bool swap) {
+        using E = typename T::value_type;
+        constexpr size_t kSize = FixedSize<E>::value;
+        ba.writeUint64(v.size());
+        if constexpr (kSize == 0) {
+            for (const auto& e : v) encode(ba, e, swap);
+        } else if constexpr (std::is_arithmetic<E>::value &&
+                             !std::is_same<E, bool>::value) {
+            // 需要 byteswap 时由 writeArray 批量 (SIMD) 转换
+            ba.writeArray(v.data(), v.size());
+        } else {
+            char buf[kSize > kPackChunk ? kSize : kPackChunk];
+            char* p = buf;
+            for (const auto& e : v) {
+                if (static_cast<size_t>(p - buf) + kSize > sizeof(buf)) {
+                    ba.write(buf, p - buf);
+                    p = buf;
+                }
+                packFixed(p, static_cast<const E&>(e), swap);
+            }
+            ba.write(buf, p - buf);
+        }
+    }
+
+    template <typename BA, typename T>
+    void decodeVector(BA& ba, T& v, bool swap) {
+        using E = typename T::value_type;
+        constexpr size_t kSize = FixedSize<E>::value;
+        uint64_t n = ba.readUint64();
+        // 元素至少占 1 字节，提前拒绝损坏数据导致的超大分配
+        if (n > ba.readableSize() / (kSize > 0 ? kSize : 1)) {
+            throw std::out_of_range("not enough len");
+        }
+        v.clear();
+        v.resize(n);
+        if constexpr (kSize == 0) {
+            for (auto& e : v) decode(ba, e, swap);
+        } else if constexpr (std::is_arithmetic<E>::value &&
+                             !std::is_same<E, bool>::value) {
+            ba.readArray(v.data(), n);
+        } else {
+            char buf[kSize > kPackChunk ? kSize : kPackChunk];
+            size_t i = 0;
+            while (i < n) {
+                size_t batch = std::min<size_t>(n - i, sizeof(buf) / kSize);
+                ba.read(buf, batch * kSize);
+                const char* p = buf;
+                for (size_t j = 0; j < batch; ++j, ++i) {
+                    E e{};
+                    unpackFixed(p, e, swap);
+                    v[i] = e;
+                }
+            }
+        }
+    }
+
+    template <typename Tuple, size_t... I>
+    void packPrefix(char*& p, const Tuple& t, bool swap,
+                    std::index_sequence<I...>) {
+        (packFixed(p, std::get<I>(t), swap), ...);
+    }
+
+    template <typename Tuple, size_t... I>
+    void unpackPrefix(const char*& p, Tuple& t, bool swap,
+                      std::index_sequence<I...>) {
+        (unpackFixed(p, std::get<I>(t), swap), ...);
+    }
+
+    template <size_t P, typename BA, typename Tuple, size_t... I>
+    void encodeRest(BA& ba, const Tuple& t, bool swap,
+                    std::index_sequence<I...>) {
+        (encode(ba, std::get<P + I>(t), swap), ...);
+    }
+
+    template <size_t P, typename BA, typename Tuple, size_t... I>
+    void decodeRest(BA& ba, Tuple& t, bool swap,
+                    std::index_sequence<I...>) {
+        (decode(ba, std::get<P + I>(t), swap), ...);
+    }
+
+    template <typename BA, typename T>
+    void encode(BA& ba, const T& v, bool swap) {
+        if constexpr (FixedSize<T>::value > 0) {
+            char buf[FixedSize<T>::value];
+            char* p = buf;
+            packFixed(p, v, swap);
+            ba.write(buf, sizeof(buf));
+        } else if constexpr (std::is_same<T, std::string>::value) {
+            ba.writeStringVint(v);
+        } else if constexpr (IsVector<T>::value) {
+            encodeVector(ba, v, swap);
+        } else {
+            static_assert(IsRegistered<T>::value,
+                          "type is not serializable, use LUTE_SERIALIZE");
+            auto fields = luteSerializeFields(v);
+            using Fields = decltype(fields);
+            constexpr size_t kCount = std::tuple_size<Fields>::value;
+            constexpr size_t kPrefix = FixedPrefix<Fields>::count();
+            if constexpr (kPrefix > 0) {
+                char buf[FixedPrefix<Fields>::bytes()];
+                char* p = buf;
+                packPrefix(p, fields, swap,
+                           std::make_index_sequence<kPrefix>());
+                ba.write(buf, sizeof(buf));
+            }
+            encodeRest<kPrefix>(ba, fields, swap,
+                                std::make_index_sequence<kCount - kPrefix>());
+        }
+    }
+
+    template <typename BA, typename T>
+    void decode(BA& ba, T& v, bool swap) {
+        if constexpr (FixedSize<T>::value > 0) {
+            char buf[FixedSize<T>::value];
+            ba.read(buf, sizeof(buf));
+            const char* p = buf;
+            unpackFixed(p, v, swap);
+        } else if constexpr (std::is_same<T, std::string>::value) {
+            v = ba.readStringVint();
+        } else if constexpr (IsVector<T>::value) {
+            decodeVector(ba, v, swap);
+        } else {
+            static_assert(IsRegistered<T>::value,
+                          "type is not serializable, use LUTE_SERIALIZE");
+            auto fields = luteSerializeFields(v);
+            using Fields = decltype(fields);
+            constexpr size_t kCount = std::tuple_size<Fields>::value;
+            constexpr size_t kPrefix = FixedPrefix<Fields>::count();
+            if constexpr (kPrefix > 0) {
+                char buf[FixedPrefix<Fields>::bytes()];
+                ba.read(buf, sizeof(buf));
+                const char* p = buf;
+                unpackPrefix(p, fields, swap,
+                             std::make_index_sequence<kPrefix>());
+            }
+            decodeRest<kPrefix>(ba, fields, swap,
+                                std::make_index_sequence<kCount - kPrefix>());
+        }
+    }
+}  // namespace detail
+
+///
+/// @brief 精确的编码长度 (字节)
+///
+template <typename T>
+size_t serializedSize(const T& v) {
+    return detail::encodedSize(v);
+}
+
+///
+/// @brief 将 v 编码写入 ba 的当前位置
+/// @post position_ += serializedSize(v)
+///
+template <typename Endian, typename T>
+void serialize(BasicByteArray<Endian>& ba, const T& v) {
+    ba.reserve(serializedSize(v));
+    detail::encode(ba, v, ba.needSwap());
+}
+
+///
+/// @brief 从 ba 的当前位置解码到 v
+/// @exception std::out_of_range when 数据不足
+///
+template <typename Endian, typename T>
+void deserialize(BasicByteArray<Endian>& ba, T& v) {
+    detail::decode(ba, v, ba.needSwap());
+}
+
+template <typename T, typename Endian>
+T deserialize(BasicByteArray<Endian>& ba) {
+    T v{};
+    deserialize(ba, v);
+    return v;
+}
+}  // namespace Lute
@@ -6,18 +6,55 @@
 
 #pragma once
 
-#include <Base/countDownLatch.h>  // CountDownLatch
-#include <pthread.h>              // pthread_t
+#include <pthread.h>  // pthread_t
+#include <sched.h>    // SCHED_OTHER
 
 #include <atomic>
 #include <functional>  // function
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace Lute {
+///
+/// @brief 线程的创建参数
+///
+/// 栈大小在 pthread_create 时通过线程属性设置，其余各项在新线程开始执行
+/// 线程函数之前由新线程自己设置；设置失败时输出到 stderr，线程照常运行
+///
+struct ThreadOptions {
+    /// @brief 允许运行的 CPU 列表，为空时不限制
+    std::vector<int> cpus;
+    /// @brief 栈大小 (字节)，0 表示使用系统默认值
+    size_t stackSize = 0;
+    /// @brief 调度策略: SCHED_OTHER / SCHED_BATCH / SCHED_IDLE / SCHED_FIFO /
+    ///        SCHED_RR，实时策略需要 CAP_SYS_NICE
+    int schedPolicy = SCHED_OTHER;
+    /// @brief SCHED_FIFO / SCHED_RR 的优先级 (1 ~ 99)
+    int schedPriority = 0;
+    /// @brief nice 值 (-20 ~ 19)，0 表示不修改
+    int nice = 0;
+    /// @brief 优先从该 NUMA 节点分配内存 (MPOL_PREFERRED)，-1 表示不设置
+    int numaNode = -1;
+
+    ///
+    /// @brief 解析 "0-3,6,8-9" 形式的 CPU 列表，格式错误的部分被忽略
+    ///
+    static std::vector<int> parseCpuList(const std::string& list);
+};
+
+namespace detail {
+    struct ThreadData;
+}  // namespace detail
+
 /**
  * pthread 核心函数：线程的创建和等待结束
  * pthread_create
  * pthread_join
+ *
+ * Thread 可移动不可复制。线程函数在 start() 时移动到与新线程共享的
+ * ThreadData (引用计数) 中，新线程通过一个原子变量 + futex 报告自己的 tid，
+ * 只有确实有线程在等待时才进入内核唤醒。
  */
 class Thread {
 public:
@@ -27,11 +64,26 @@ public:
     Thread(const Thread&) = delete;
     Thread& operator=(Thread&) = delete;
 
-    explicit Thread(ThreadFunc, std::string name = std::string());
-    // FIXME: make it movable in C++11
+    explicit Thread(ThreadFunc, std::string name = std::string(),
+                    ThreadOptions options = ThreadOptions());
     ~Thread();
 
-    void start();
+    ///
+    /// @brief 移动之后 other 处于未启动的状态，只能析构或被赋值
+    ///
+    Thread(Thread&& other) noexcept;
+    ///
+    /// @brief 若 *this 已启动且未 join，先将其 detach
+    ///
+    Thread& operator=(Thread&& other) noexcept;
+
+    ///
+    /// @brief 创建线程
+    /// @param waitForTid 为 true 时等待新线程报告 tid 之后返回 (此时
+    ///        ThreadOptions 已生效)；为 false 时立即返回，tid() 在首次调用时
+    ///        等待
+    ///
+    void start(bool waitForTid = true);
     int join();  // return pthread_join()
 
     bool started() const { return started_; }
@@ -39,10 +91,15 @@ public:
     // pthread_t
     // pthreadId() const { return pthreadId_; }
 
-    pid_t tid() const { return tid_; }
+    ///
+    /// @brief 新线程的 tid，线程尚未报告时等待；未启动时返回 0
+    ///
+    pid_t tid() const;
 
     const std::string& name() const { return name_; }
 
+    const ThreadOptions& options() const { return options_; }
+
     static int numCreated() { return numCreated_.load(); }
 
 private:
@@ -52,12 +109,15 @@ private:
     /* pthread_t 不适合做程序中对线程的标识符, 只在进程内具有唯一性 */
     pthread_t pthreadId_;
     // 在操纵系统内具有全局唯一性，采用递增轮回法进行分配
-    pid_t tid_;
+    // 新线程报告之前为 0；多个线程可能同时通过 tid() 缓存，使用原子变量
+    mutable std::atomic<pid_t> tid_;
 
-    // 线程函数
+    // 线程函数，start() 时移动到 data_
     ThreadFunc func_;
     std::string name_;
-    Lute::CountDownLatch latch_;
+    ThreadOptions options_;
+    // 与新线程共享的数据，start() 之前为 nullptr
+    detail::ThreadData* data_;
 
     // 用于线程池
     static std::atomic_int32_t numCreated_;
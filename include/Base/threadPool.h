@@ -0,0 +1,278 @@
+/**
+ * @brief 基于 Lute::Thread 的 work-stealing 线程池
+ *
+ *  - 每个工作线程拥有一个 Chase-Lev 双端队列: 工作线程内提交的任务压入自己
+ *    队列的底部并从底部取出 (LIFO，缓存友好)，空闲的工作线程从随机选择的
+ *    其他线程队列顶部窃取 (FIFO)
+ *  - 非工作线程提交的任务进入全局注入队列 (MPMCQueue)
+ *  - 无任务时先自旋，再通过 EventCount 在 futex 上休眠
+ *  - 可选将第 i 个工作线程绑定到第 i % N 个 CPU
+ *  - 工作线程名为 name + 序号 (CurrentThread::name())
+ *
+ * @usage
+    Lute::ThreadPool pool("Worker");
+    pool.start(4);
+    pool.run([]() { doSomething(); });
+    std::future<int> f = pool.submit([](int x) { return x * 2; }, 21);
+    assert(f.get() == 42);
+    pool.stop();  // 等待已提交的任务全部执行完毕
+ */
+
+#pragma once
+
+#include <Base/MPMCQueue.h>  // MPMCQueue
+#include <Base/atomic.h>     // LUTE_CACHELINE_SIZE
+#include <Base/futex.h>      // EventCount
+#include <Base/thread.h>     // Thread
+
+#include <atomic>       // atomic
+#include <cstdint>      // int64_t, uint64_t
+#include <functional>   // function
+#include <future>       // future, packaged_task
+#include <memory>       // unique_ptr, shared_ptr
+#include <string>       // string
+#include <tuple>        // make_tuple, apply
+#include <type_traits>  // invoke_result_t, decay_t
+#include <vector>       // vector
+
+namespace Lute {
+namespace detail {
+    ///
+    /// @brief Chase-Lev work-stealing 双端队列
+    ///        (Lê et al., "Correct and Efficient Work-Stealing for Weak
+    ///        Memory Models", PPoPP 2013)
+    ///
+    /// 只有所有者线程可以调用 push / take，任意线程可以调用 steal。
+    /// 数组满时扩容为原来的两倍，旧数组在队列析构时才释放，
+    /// 保证并发的 steal 不会访问已释放的内存。
+    ///
+    /// @tparam T 元素类型，必须可以无锁原子读写 (如指针)
+    ///
+    template <typename T>
+    class WorkStealingDeque {
+    public:
+        /// @param capacity 初始容量，必须为 2 的幂
+        explicit WorkStealingDeque(int64_t capacity = 1024)
+            : top_(0), bottom_(0), array_(new Array(capacity)) {
+            retired_.emplace_back(array_.load(std::memory_order_relaxed));
+        }
+
+        /// non-copyable
+        WorkStealingDeque(const WorkStealingDeque&) = delete;
+        WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+        /// @brief 所有者线程: 压入底部
+        void push(T item) {
+            int64_t b = bottom_.load(std::memory_order_relaxed);
+            int64_t t = top_.load(std::memory_order_acquire);
+            Array* a = array_.load(std::memory_order_relaxed);
+            if (b - t > a->capacity - 1) a = grow(a, b, t);
+            a->put(b, item);
+            std::atomic_thread_fence(std::memory_order_release);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+
+        /// @brief 所有者线程: 从底部取出
+        /// @return 队列为空时返回 false
+        bool take(T& item) {
+            int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+            Array* a = array_.load(std::memory_order_relaxed);
+            bottom_.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t t = top_.load(std::memory_order_relaxed);
+            if (t > b) {
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return false;
+            }
+            item = a->get(b);
+            if (t == b) {
+                // 最后一个元素，与窃取者竞争
+                bool won = top_.compare_exchange_strong(
+                    t, t + 1, std::memory_order_seq_cst,
+                    std::memory_order_relaxed);
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return won;
+            }
+            return true;
+        }
+
+        /// @brief 任意线程: 从顶部窃取
+        /// @return 队列为空或与其他线程竞争失败时返回 false
+        bool steal(T& item) {
+            int64_t t = top_.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t b = bottom_.load(std::memory_order_acquire);
+            if (t >= b) return false;
+            Array* a = array_.load(std::memory_order_acquire);
+            item = a->get(t);
+            return top_.compare_exchange_strong(t, t + 1,
+                                                std::memory_order_seq_cst,
+                                                std::memory_order_relaxed);
+        }
+
+        /// @brief 元素个数的近似值
+        int64_t sizeGuess() const {
+            int64_t b = bottom_.load(std::memory_order_relaxed);
+            int64_t t = top_.load(std::memory_order_relaxed);
+            return b > t ? b - t : 0;
+        }
+
+        bool empty() const { return sizeGuess() == 0; }
+
+    private:
+        struct Array {
+            explicit Array(int64_t cap)
+                : capacity(cap),
+                  mask(cap - 1),
+                  items(new std::atomic<T>[cap]) {}
+
+            T get(int64_t i) const {
+                return items[i & mask].load(std::memory_order_relaxed);
+            }
+            void put(int64_t i, T item) {
+                items[i & mask].store(item, std::memory_order_relaxed);
+            }
+
+            const int64_t capacity;
+            const int64_t mask;
+            std::unique_ptr<std::atomic<T>[]> items;
+        };
+
+        Array* grow(Array* old, int64_t b, int64_t t) {
+            auto* a = new Array(old->capacity * 2);
+            for (int64_t i = t; i < b; ++i) a->put(i, old->get(i));
+            retired_.emplace_back(a);
+            array_.store(a, std::memory_order_release);
+            return a;
+        }
+
+        alignas(LUTE_CACHELINE_SIZE) std::atomic<int64_t> top_;
+        alignas(LUTE_CACHELINE_SIZE) std::atomic<int64_t> bottom_;
+        std::atomic<Array*> array_;
+        /// 全部分配过的数组，只由所有者线程修改
+        std::vector<std::unique_ptr<Array>> retired_;
+    };
+}  // namespace detail
+
+///
+/// @brief work-stealing 线程池
+///
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    explicit ThreadPool(const std::string& name = std::string("ThreadPool"));
+    ~ThreadPool();
+
+    /// non-copyable
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ///
+    /// @brief 全局注入队列的容量，队列满时 run() 阻塞，须在 start() 之前调用
+    ///
+    void setMaxQueueSize(size_t maxSize) { maxQueueSize_ = maxSize; }
+
+    ///
+    /// @brief 是否将第 i 个工作线程绑定到第 i % N 个 CPU，须在 start() 之前调用
+    ///
+    void setThreadAffinity(bool on) { affinity_ = on; }
+
+    ///
+    /// @brief 每个工作线程开始执行任务之前调用
+    ///
+    void setThreadInitCallback(const Task& cb) { threadInitCallback_ = cb; }
+
+    ///
+    /// @brief 启动 numThreads 个工作线程，numThreads <= 0 时使用 CPU 核数
+    ///
+    void start(int numThreads = 0);
+
+    ///
+    /// @brief 等待已提交的任务全部执行完毕后停止全部工作线程
+    ///
+    void stop();
+
+    ///
+    /// @brief 提交任务
+    /// @note 工作线程内提交的任务压入本线程的队列；未启动或已停止时，
+    ///       直接在调用线程中执行
+    ///
+    void run(Task task);
+
+    ///
+    /// @brief 提交任务，通过 future 获取返回值或异常
+    /// @note f 与 args 按值保存并在执行时移出，支持只能移动的参数
+    ///
+    template <typename F, typename... Args>
+    auto submit(F&& f, Args&&... args) -> std::future<
+        std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>> {
+        using R = std::invoke_result_t<std::decay_t<F>, std::decay_t<Args>...>;
+        auto task = std::make_shared<std::packaged_task<R()>>(
+            [f = std::forward<F>(f),
+             args = std::make_tuple(std::forward<Args>(args)...)]() mutable {
+                return std::apply(std::move(f), std::move(args));
+            });
+        std::future<R> future = task->get_future();
+        run([task]() { (*task)(); });
+        return future;
+    }
+
+    ///
+    /// @brief 在调用线程中取出并执行一个任务 (工作线程优先取自己的队列)，
+    ///        用于等待子任务完成时帮助执行，避免阻塞工作线程
+    /// @return 没有可执行的任务时返回 false
+    ///
+    bool tryRunOne();
+
+    ///
+    /// @brief 当前线程是否为本线程池的工作线程
+    ///
+    bool inWorkerThread() const;
+
+    const std::string& name() const { return name_; }
+    /// @brief 最近一次 start() 启动的工作线程数
+    size_t numThreads() const { return workers_.size(); }
+
+    ///
+    /// @brief 尚未执行的任务数的近似值
+    ///
+    size_t queueSize() const;
+
+private:
+    struct alignas(LUTE_CACHELINE_SIZE) Worker {
+        detail::WorkStealingDeque<Task*> deque;
+        /// 选择窃取对象的随机数状态 (xorshift)
+        uint64_t rng;
+    };
+
+    void runInThread(size_t index);
+    ///
+    /// @brief run() 放入任务之前登记，stop() 等待登记的调用全部离开之后
+    ///        才让工作线程退出
+    /// @return 线程池已停止时返回 false (不需要 leave())
+    ///
+    bool enter();
+    void leave();
+    /// @brief 依次尝试: 自己的队列 -> 注入队列 -> 随机窃取
+    Task* findTask(Worker* self);
+    Task* steal(Worker* self);
+    void execute(Task* task);
+
+    std::string name_;
+    size_t maxQueueSize_;
+    bool affinity_;
+    Task threadInitCallback_;
+    /// run() 是否接受任务
+    std::atomic<bool> running_;
+    /// 工作线程在所有队列为空之后退出
+    std::atomic<bool> quit_;
+    /// 正在 run() 中放入任务的调用者数
+    std::atomic<int> inFlight_;
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::unique_ptr<Thread>> threads_;
+    std::unique_ptr<MPMCQueue<Task*>> injection_;
+    EventCount idle_;
+};
+}  // namespace Lute
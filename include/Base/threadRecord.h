@@ -0,0 +1,119 @@
+/**
+ * @brief 每线程记录表 ThreadRecordList<Record>
+ *
+ *  - 回收域、对象池等对象为每个使用它的线程登记一条记录，记录挂在只增
+ *    不减的无锁链表上，遍历不需要加锁
+ *  - 当前线程的记录保存在 pthread key 中；线程退出时由使用者提供的 key
+ *    析构函数清理记录并调用 release()，记录留给之后登记的线程复用
+ *  - 记录在 takeAll() 之前不会释放，takeAll() 同时删除 pthread key，
+ *    之后线程退出不再调用析构函数
+ *  - Record 须含有 std::atomic<bool> inUse 与 Record* next 两个成员
+ *
+ * @usage
+    struct Record {
+        std::atomic<bool> inUse{false};
+        Record* next = nullptr;
+        ...
+    };
+    static void onThreadExit(void* ptr) {
+        auto* record = static_cast<Record*>(ptr);
+        ...
+        Lute::ThreadRecordList<Record>::release(record);
+    }
+
+    Lute::ThreadRecordList<Record> records(&onThreadExit);
+    Record* r = records.current();
+    if (r == nullptr) r = records.acquire([]() { return new Record; });
+ */
+
+#pragma once
+
+#include <Base/mutex.h>  // MCHECK
+#include <pthread.h>     // pthread_key_t
+
+#include <atomic>   // atomic
+#include <cassert>  // assert
+
+namespace Lute {
+template <typename Record>
+class ThreadRecordList {
+public:
+    ///
+    /// @param onThreadExit 线程退出时以该线程的记录调用，最后应调用 release()
+    ///
+    explicit ThreadRecordList(void (*onThreadExit)(void*)) : head_(nullptr) {
+        MCHECK(pthread_key_create(&key_, onThreadExit));
+    }
+
+    /// 所有记录应已由 takeAll() 取走
+    ~ThreadRecordList() { assert(head_.load() == nullptr); }
+
+    /// non-copyable
+    ThreadRecordList(const ThreadRecordList&) = delete;
+    ThreadRecordList& operator=(const ThreadRecordList&) = delete;
+
+    /// @brief 当前线程的记录，尚未登记时返回 nullptr
+    Record* current() const {
+        return static_cast<Record*>(pthread_getspecific(key_));
+    }
+
+    ///
+    /// @brief 为当前线程登记一条记录: 优先复用已退出线程归还的记录，
+    ///        没有时以 newRecord() 创建并挂入链表
+    ///
+    template <typename NewRecord>
+    Record* acquire(NewRecord newRecord) {
+        assert(current() == nullptr);
+        Record* record = nullptr;
+        for (Record* r = head_.load(std::memory_order_acquire); r != nullptr;
+             r = r->next) {
+            bool expected = false;
+            if (!r->inUse.load(std::memory_order_relaxed) &&
+                r->inUse.compare_exchange_strong(expected, true,
+                                                 std::memory_order_acquire)) {
+                record = r;
+                break;
+            }
+        }
+        if (record == nullptr) {
+            record = newRecord();
+            record->inUse.store(true, std::memory_order_relaxed);
+            Record* head = head_.load(std::memory_order_relaxed);
+            do {
+                record->next = head;
+            } while (!head_.compare_exchange_weak(head, record,
+                                                  std::memory_order_release,
+                                                  std::memory_order_relaxed));
+        }
+        MCHECK(pthread_setspecific(key_, record));
+        return record;
+    }
+
+    /// @brief 线程退出时归还记录，之前对记录的修改对复用者可见
+    static void release(Record* record) {
+        record->inUse.store(false, std::memory_order_release);
+    }
+
+    /// @brief 遍历所有记录 (包括空闲的)
+    template <typename Func>
+    void forEach(Func func) const {
+        for (Record* r = head_.load(std::memory_order_acquire); r != nullptr;
+             r = r->next) {
+            func(r);
+        }
+    }
+
+    ///
+    /// @brief 删除 pthread key 并取走整条链表，由调用方释放各记录；
+    ///        调用时不能有其他线程访问
+    ///
+    Record* takeAll() {
+        MCHECK(pthread_key_delete(key_));
+        return head_.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+private:
+    pthread_key_t key_;
+    std::atomic<Record*> head_;
+};
+}  // namespace Lute
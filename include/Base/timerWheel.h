@@ -0,0 +1,214 @@
+/**
+ * @brief 分层时间轮 TimerWheel 与定时任务调度器 TimerScheduler
+ *
+ *  - TimerWheel: 4 层时间轮 (256 + 64 + 64 + 64 个槽)，以 tick 为单位，
+ *    覆盖 2^26 个 tick (1ms 精度时约 18.6 小时)，更远的定时器暂放在最高层，
+ *    级联时重新计算位置
+ *  - 定时器节点保存在数组中，以下标 + 代数作为 TimerId，槽内为下标组成的
+ *    双向链表: add / cancel 为 O(1)，百万级定时器没有逐个分配内存的开销
+ *  - 每层维护非空槽位图，advance 跳过没有到期定时器的 tick，
+ *    ticksUntilNextExpiry 只扫描位图
+ *  - TimerWheel 不是线程安全的，由单个线程 (如 EventLoop) 驱动
+ *  - TimerScheduler: 在独立线程中驱动 TimerWheel，按下一个到期时间在 futex
+ *    上精确休眠；新定时器早于当前休眠的截止时间时才唤醒调度线程。
+ *    回调在调度线程中执行，执行期间不持有锁，回调内可以添加或取消定时器
+ *
+ * @usage
+    Lute::TimerScheduler scheduler;
+    scheduler.start();
+    Lute::TimerId id = scheduler.runEvery(0.5, []() { LOG_INFO << "tick"; });
+    scheduler.runAfter(3.0, [&]() { scheduler.cancel(id); });
+ */
+
+#pragma once
+
+#include <Base/fastMutex.h>  // FastMutex
+#include <Base/thread.h>     // Thread
+#include <Base/timestamp.h>  // Timestamp
+
+#include <atomic>      // atomic
+#include <cstdint>     // uint32_t, uint64_t
+#include <functional>  // function
+#include <string>      // string
+#include <vector>      // vector
+
+namespace Lute {
+///
+/// @brief 定时器标识，定时器到期 (非周期) 或被取消之后失效
+///
+struct TimerId {
+    static constexpr uint32_t kInvalidIndex = UINT32_MAX;
+
+    uint32_t index = kInvalidIndex;
+    uint32_t generation = 0;
+
+    bool valid() const { return index != kInvalidIndex; }
+};
+
+///
+/// @brief 分层时间轮，单线程使用
+///
+class TimerWheel {
+public:
+    using Callback = std::function<void()>;
+    ///
+    /// @brief 执行回调的方式，默认直接调用；TimerScheduler 用它在执行回调
+    ///        期间释放锁
+    ///
+    using Invoker = std::function<void(Callback&)>;
+
+    TimerWheel();
+
+    /// non-copyable
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    ///
+    /// @brief 添加定时器，在 currentTick() + delay 时到期
+    /// @param delay 延迟的 tick 数，0 视为 1
+    /// @param interval 周期 (tick)，0 表示只执行一次
+    ///
+    TimerId add(uint64_t delay, Callback cb, uint64_t interval = 0);
+
+    ///
+    /// @brief 以秒计的周期换算为 tick 数，向上取整且至少为 1；
+    ///        interval <= 0 时返回 0 (只执行一次)。EventLoop 与
+    ///        TimerScheduler 共用，同一周期在两处行为一致
+    ///
+    static uint64_t periodTicks(double interval, int64_t tickNs);
+
+    ///
+    /// @brief 取消定时器，可以在回调中取消自己
+    /// @return 定时器已失效时返回 false
+    ///
+    bool cancel(TimerId id);
+
+    ///
+    /// @brief 推进到 tick，依次执行到期的定时器
+    /// @return 执行的回调数
+    ///
+    size_t advance(uint64_t tick, const Invoker& invoke = Invoker());
+
+    ///
+    /// @brief 距下一次需要 advance 的 tick 数 (下一个定时器到期，或高层
+    ///        时间轮需要级联)，没有定时器时返回 -1
+    ///
+    int64_t ticksUntilNextExpiry() const;
+
+    uint64_t currentTick() const { return current_; }
+
+    /// @brief 尚未到期的定时器数
+    size_t size() const { return size_; }
+
+    bool empty() const { return size_ == 0; }
+
+private:
+    static constexpr int kLevels = 4;
+    static constexpr int kRootBits = 8;
+    static constexpr int kLevelBits = 6;
+    static constexpr int kRootSlots = 1 << kRootBits;
+    static constexpr int kLevelSlots = 1 << kLevelBits;
+    static constexpr int kSlots = kRootSlots + (kLevels - 1) * kLevelSlots;
+    static constexpr uint32_t kNil = UINT32_MAX;
+
+    enum class State : uint8_t { kFree, kPending, kRunning, kCancelled };
+
+    struct Node {
+        Callback cb;
+        uint64_t expire = 0;
+        uint64_t interval = 0;
+        uint32_t prev = kNil;
+        uint32_t next = kNil;
+        uint32_t generation = 0;
+        uint16_t slot = 0;
+        State state = State::kFree;
+    };
+
+    /// @brief 第 level 层槽位对应 tick 的右移位数
+    static int shift(int level) {
+        return level == 0 ? 0 : kRootBits + (level - 1) * kLevelBits;
+    }
+
+    /// @brief 槽所在的层
+    static int levelOf(int slot) {
+        return slot < kRootSlots ? 0 : 1 + (slot - kRootSlots) / kLevelSlots;
+    }
+
+    uint32_t allocNode();
+    void freeNode(uint32_t index);
+    /// @brief 按到期时间放入对应的槽
+    void place(uint32_t index);
+    void link(uint32_t index, int slot);
+    void unlink(uint32_t index);
+    /// @brief 将第 level 层当前槽中的定时器重新放置到低层
+    void cascade(int level);
+    /// @brief 执行 tick current_ 到期的定时器
+    size_t expire(const Invoker& invoke);
+
+    uint64_t current_;
+    size_t size_;
+    std::vector<Node> nodes_;
+    uint32_t freeList_;
+    uint32_t heads_[kSlots];
+    /// 非空槽位图
+    uint64_t bitmap_[kSlots / 64];
+    /// 每层的定时器数
+    size_t levelCount_[kLevels];
+};
+
+///
+/// @brief 在独立线程中驱动 TimerWheel 的定时任务调度器，线程安全
+///
+class TimerScheduler {
+public:
+    using Callback = TimerWheel::Callback;
+
+    ///
+    /// @param resolutionUs 时间轮一个 tick 的长度 (微秒)
+    ///
+    explicit TimerScheduler(
+        const std::string& name = std::string("TimerScheduler"),
+        int64_t resolutionUs = 1000);
+    ~TimerScheduler();
+
+    /// non-copyable
+    TimerScheduler(const TimerScheduler&) = delete;
+    TimerScheduler& operator=(const TimerScheduler&) = delete;
+
+    void start();
+    ///
+    /// @brief 停止调度线程，尚未到期的定时器不再执行
+    ///
+    void stop();
+
+    /// @brief 在 time 时执行 cb
+    TimerId runAt(Timestamp time, Callback cb);
+    /// @brief delay 秒之后执行 cb
+    TimerId runAfter(double delay, Callback cb);
+    /// @brief 每隔 interval 秒执行一次 cb，第一次在 interval 秒之后
+    TimerId runEvery(double interval, Callback cb);
+
+    bool cancel(TimerId id);
+
+    size_t size() const;
+
+private:
+    uint64_t nowTick() const;
+    TimerId add(double delay, Callback cb, double interval);
+    /// 执行回调期间释放 mutex_
+    void threadFunc() NO_THREAD_SAFETY_ANALYSIS;
+
+    const int64_t resolutionNs_;
+    const int64_t startNs_;
+    std::atomic<bool> running_;
+
+    mutable FastMutex mutex_;
+    TimerWheel wheel_ GUARDED_BY(mutex_);
+    /// 调度线程休眠的截止 tick
+    uint64_t sleepUntil_ GUARDED_BY(mutex_);
+    /// 调度线程休眠所在的 futex
+    std::atomic<uint32_t> wakeup_;
+
+    Thread thread_;
+};
+}  // namespace Lute
@@ -1,22 +1,41 @@
 #pragma once
 
+#include <Base/MPMCQueue.h>
 #include <Base/MTQueue.h>
+#include <Base/SPSCQueue.h>
 #include <Base/any.h>
 #include <Base/atomic.h>
+#include <Base/barrier.h>
 #include <Base/bytearray.h>
+#include <Base/checksum.h>
+#include <Base/concurrentHashMap.h>
 #include <Base/condition_variable.h>
+#include <Base/coroutine.h>
 #include <Base/countDownLatch.h>
 #include <Base/currentThread.h>
 #include <Base/endian.h>
+#include <Base/eventLoop.h>
 #include <Base/exception.h>
+#include <Base/fastMutex.h>
 #include <Base/fsUtils.h>
+#include <Base/futex.h>
+#include <Base/hex.h>
 #include <Base/ini_config.h>
+#include <Base/ioUring.h>
+#include <Base/lockProfiler.h>
 #include <Base/logger.h>
 #include <Base/mallochook.h>
 #include <Base/md5.h>
 #include <Base/mutex.h>
+#include <Base/objectPool.h>
+#include <Base/parallel.h>
+#include <Base/reclamation.h>
+#include <Base/rwlock.h>
+#include <Base/serialize.h>
 #include <Base/singleton.h>
 #include <Base/string_view.h>
 #include <Base/thread.h>
+#include <Base/threadPool.h>
+#include <Base/timerWheel.h>
 #include <Base/timestamp.h>
 #include <Base/utils.h>
@@ -0,0 +1,36 @@
+#include <Base/atomic.h>
+#include <Base/currentThread.h>
+#include <sched.h>   // sched_getcpu
+#include <unistd.h>  // sysconf
+
+Lute::StripedCounter::StripedCounter(size_t stripes) : mask_(0) {
+    if (stripes == 0) {
+        long ncpu = ::sysconf(_SC_NPROCESSORS_CONF);
+        stripes = ncpu > 0 ? static_cast<size_t>(ncpu) : 1;
+    }
+    size_t n = 1;
+    while (n < stripes) n <<= 1;
+    mask_ = n - 1;
+    slots_.reset(new PaddedAtomic<int64_t>[n]);
+}
+
+int64_t Lute::StripedCounter::value() const {
+    int64_t sum = 0;
+    for (size_t i = 0; i <= mask_; ++i) {
+        sum += slots_[i].load(std::memory_order_relaxed);
+    }
+    return sum;
+}
+
+void Lute::StripedCounter::reset() {
+    for (size_t i = 0; i <= mask_; ++i) {
+        slots_[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t Lute::StripedCounter::stripe() {
+    // glibc 通过 rseq / vDSO 实现 sched_getcpu，不进入内核
+    int cpu = ::sched_getcpu();
+    if (cpu >= 0) return static_cast<size_t>(cpu);
+    return static_cast<size_t>(CurrentThread::tid());
+}
@@ -0,0 +1,80 @@
+#include <Base/atomic.h>  // cpuRelax
+#include <Base/barrier.h>
+#include <Base/futex.h>
+
+#include <cassert>  // assert
+
+namespace {
+/// 阶段切换通常很快，休眠之前自旋的次数
+const int kSpinCount = 200;
+}  // namespace
+
+using namespace Lute;
+
+/// NOTE ----------- Event -----------
+void Event::set() {
+    if (state_.exchange(kSet, std::memory_order_acq_rel) == kWaiting) {
+        Futex::wake(&state_);
+    }
+}
+
+bool Event::waitFor(int64_t timeoutNs) {
+    const int64_t deadline = timeoutNs >= 0 ? monotonicNs() + timeoutNs : 0;
+    uint32_t state = state_.load(std::memory_order_acquire);
+    while (state != kSet) {
+        // 登记等待者，set 看到 kWaiting 才会唤醒
+        if (state == kUnset &&
+            !state_.compare_exchange_weak(state, kWaiting,
+                                          std::memory_order_acquire)) {
+            continue;
+        }
+
+        int64_t remaining = -1;
+        if (timeoutNs >= 0) {
+            remaining = deadline - monotonicNs();
+            if (remaining <= 0) return false;
+        }
+        Futex::wait(&state_, kWaiting, remaining);
+        state = state_.load(std::memory_order_acquire);
+    }
+    return true;
+}
+
+/// NOTE ----------- CyclicBarrier -----------
+CyclicBarrier::CyclicBarrier(int parties, CompletionFunc completion)
+    : parties_(static_cast<uint32_t>(parties)),
+      completion_(std::move(completion)),
+      arrived_(0),
+      generation_(0),
+      sleepers_(0) {
+    assert(parties > 0);
+}
+
+bool CyclicBarrier::arriveAndWait() {
+    // 本阶段的最后一个线程到达之前，阶段序号不会改变
+    const uint32_t generation = generation_.load(std::memory_order_acquire);
+    if (arrived_.fetch_add(1, std::memory_order_acq_rel) + 1 == parties_) {
+        arrived_.store(0, std::memory_order_relaxed);
+        if (completion_) completion_();
+        generation_.fetch_add(1, std::memory_order_seq_cst);
+        // 与等待者的 sleepers_ 登记 / generation_ 复查构成 Dekker 式同步
+        if (sleepers_.load(std::memory_order_seq_cst) > 0) {
+            Futex::wake(&generation_);
+        }
+        return true;
+    }
+
+    for (int i = 0; i < kSpinCount; ++i) {
+        if (generation_.load(std::memory_order_acquire) != generation) {
+            return false;
+        }
+        cpuRelax();
+    }
+
+    sleepers_.fetch_add(1, std::memory_order_seq_cst);
+    while (generation_.load(std::memory_order_seq_cst) == generation) {
+        Futex::wait(&generation_, generation);
+    }
+    sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    return false;
+}
@@ -1,9 +1,15 @@
 
 #include <Base/bytearray.h>
+#include <Base/checksum.h>  // crc32c, XXHash64
+#include <Base/hex.h>       // hexEncode
 #include <Base/logger.h>
+#include <fcntl.h>     // open
+#include <sys/mman.h>  // mmap, madvise
+#include <sys/stat.h>  // fstat
+#include <unistd.h>    // close, sysconf
 
-#include <iomanip>  // setw, setfill
-#include <sstream>  // stringstream
+#include <algorithm>  // min
+#include <stdexcept>  // out_of_range, logic_error
 
 using namespace Lute;
 
@@ -20,67 +26,156 @@ static inline int64_t DecodeZigzag64(const uint64_t& v) {
     return (v >> 1) ^ -(v & 1);
 }
 
-ByteArray::Node::Node() : ptr_(nullptr), next_(nullptr), size_(0) {}
-ByteArray::Node::Node(size_t size)
-    : ptr_(new char[size]), next_(nullptr), size_(size) {}
-ByteArray::Node::~Node() {
-    if (nullptr != ptr_) delete[] ptr_;
+namespace {
+/// 默认大小的内存块，由所有字节序的 ByteArray 共用一个对象池
+struct Chunk {
+    char data[4096];
+};
+
+/// 有意泄漏: 线程退出时 pthread key 的析构函数仍会访问它
+Lute::ObjectPool<Chunk>& chunkPool() {
+    static Lute::ObjectPool<Chunk>* pool = new Lute::ObjectPool<Chunk>;
+    return *pool;
+}
+}  // namespace
+
+template <class EndianPolicy>
+BasicByteArray<EndianPolicy>::Node::Node()
+    : ptr_(nullptr), next_(nullptr), size_(0), owned_(true) {}
+template <class EndianPolicy>
+BasicByteArray<EndianPolicy>::Node::Node(size_t size)
+    : ptr_(size == sizeof(Chunk) ? chunkPool().acquire()->data
+                                 : new char[size]),
+      next_(nullptr),
+      size_(size),
+      owned_(true) {}
+template <class EndianPolicy>
+BasicByteArray<EndianPolicy>::Node::Node(char* ptr, size_t size)
+    : ptr_(ptr), next_(nullptr), size_(size), owned_(false) {}
+template <class EndianPolicy>
+BasicByteArray<EndianPolicy>::Node::~Node() {
+    if (!owned_ || nullptr == ptr_) return;
+    if (size_ == sizeof(Chunk)) {
+        chunkPool().release(reinterpret_cast<Chunk*>(ptr_));
+    } else {
+        delete[] ptr_;
+    }
+}
+
+template <class EndianPolicy>
+ObjectPool<typename BasicByteArray<EndianPolicy>::Node>&
+BasicByteArray<EndianPolicy>::nodePool() {
+    // 有意泄漏，理由同 chunkPool()
+    static ObjectPool<Node>* pool = new ObjectPool<Node>;
+    return *pool;
 }
 
-ByteArray::ByteArray(size_t base_size)
+template <class EndianPolicy>
+BasicByteArray<EndianPolicy>::BasicByteArray(size_t base_size)
     : baseSize_(base_size),
       position_(0),
       capacity_(base_size),
       size_(0),
-      endian_(LUTE_BYTE_ORDER),
-      root_(new Node(base_size)),
-      curr_(root_) {}
-
-ByteArray::~ByteArray() {
+      root_(nodePool().acquire(base_size)),
+      curr_(root_),
+      mapped_(nullptr),
+      heapBaseSize_(base_size),
+      ring_(false) {}
+
+template <class EndianPolicy>
+BasicByteArray<EndianPolicy>::~BasicByteArray() {
+    if (mapped_) ::munmap(mapped_, capacity_);
     Node* tmp = root_;
     while (nullptr != tmp) {
         curr_ = tmp;
         tmp = tmp->next_;
-        delete curr_;
+        nodePool().release(curr_);
     }
 }
-void ByteArray::writeFint8(int8_t val) { write(&val, sizeof(val)); }
 
-void ByteArray::writeFuint8(uint8_t val) { write(&val, sizeof(val)); }
-
-void ByteArray::writeFint16(int16_t val) {
-    if (endian_ != LUTE_BYTE_ORDER) val = byteswap(val);
+template <class EndianPolicy>
+template <typename T>
+void BasicByteArray<EndianPolicy>::writeFixed(T val) {
+    if constexpr (sizeof(T) > 1) {
+        if (this->needSwap()) val = byteswap(val);
+    }
+    // 写满当前内存块时需要移动 curr_，交给 write() 处理
+    size_t npos = position_ % baseSize_;
+    if (!mapped_ && curr_ && curr_->size_ - npos > sizeof(val)) {
+        ::memcpy(curr_->ptr_ + npos, &val, sizeof(val));
+        position_ += sizeof(val);
+        if (position_ > size_) size_ = position_;
+        return;
+    }
     write(&val, sizeof(val));
 }
 
-void ByteArray::writeFuint16(uint16_t val) {
-    if (endian_ != LUTE_BYTE_ORDER) val = byteswap(val);
-    write(&val, sizeof(val));
+template <class EndianPolicy>
+template <typename T>
+T BasicByteArray<EndianPolicy>::readFixed() {
+    T v;
+    // 读完当前内存块时需要移动 curr_，交给 read() 处理
+    size_t npos = position_ % baseSize_;
+    if (readableSize() >= sizeof(v) && curr_ &&
+        curr_->size_ - npos > sizeof(v)) {
+        ::memcpy(&v, curr_->ptr_ + npos, sizeof(v));
+        position_ += sizeof(v);
+    } else {
+        read(&v, sizeof(v));
+    }
+    if constexpr (sizeof(T) > 1) {
+        if (this->needSwap()) v = byteswap(v);
+    }
+    return v;
 }
 
-void ByteArray::writeFint32(int32_t val) {
-    if (endian_ != LUTE_BYTE_ORDER) val = byteswap(val);
-    write(&val, sizeof(val));
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeFint8(int8_t val) {
+    writeFixed(val);
 }
 
-void ByteArray::writeFuint32(uint32_t val) {
-    if (endian_ != LUTE_BYTE_ORDER) val = byteswap(val);
-    write(&val, sizeof(val));
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeFuint8(uint8_t val) {
+    writeFixed(val);
 }
 
-void ByteArray::writeFint64(int64_t val) {
-    if (endian_ != LUTE_BYTE_ORDER) val = byteswap(val);
-    write(&val, sizeof(val));
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeFint16(int16_t val) {
+    writeFixed(val);
 }
 
-void ByteArray::writeFuint64(uint64_t val) {
-    if (endian_ != LUTE_BYTE_ORDER) val = byteswap(val);
-    write(&val, sizeof(val));
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeFuint16(uint16_t val) {
+    writeFixed(val);
 }
 
-void ByteArray::writeInt32(int32_t val) { writeUint32(EncodeZigzag32(val)); }
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeFint32(int32_t val) {
+    writeFixed(val);
+}
 
-void ByteArray::writeUint32(uint32_t val) {
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeFuint32(uint32_t val) {
+    writeFixed(val);
+}
+
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeFint64(int64_t val) {
+    writeFixed(val);
+}
+
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeFuint64(uint64_t val) {
+    writeFixed(val);
+}
+
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeInt32(int32_t val) {
+    writeUint32(EncodeZigzag32(val));
+}
+
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeUint32(uint32_t val) {
     uint8_t tmp[5];
     uint8_t i = 0;
     while (val >= 0x80) {
@@ -91,9 +186,13 @@ void ByteArray::writeUint32(uint32_t val) {
     write(tmp, i);
 }
 
-void ByteArray::writeInt64(int64_t val) { writeUint64(EncodeZigzag64(val)); }
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeInt64(int64_t val) {
+    writeUint64(EncodeZigzag64(val));
+}
 
-void ByteArray::writeUint64(uint64_t val) {
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeUint64(uint64_t val) {
     uint8_t tmp[10];
     uint8_t i = 0;
     while (val >= 0x80) {
@@ -104,44 +203,58 @@ void ByteArray::writeUint64(uint64_t val) {
     write(tmp, i);
 }
 
-void ByteArray::writeFloat(float val) {
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeFloat(float val) {
     uint32_t v;
     ::memcpy(&v, &val, sizeof(val));
     writeFuint32(v);
 }
 
-void ByteArray::writeDouble(double val) {
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeDouble(double val) {
     uint64_t v;
     ::memcpy(&v, &val, sizeof(val));
     writeFuint64(v);
 }
 
-void ByteArray::writeStringF16(const std::string_view& val) {
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeStringF16(
+    const std::string_view& val) {
     writeFuint16(val.size());
     write(val.data(), val.size());
 }
 
-void ByteArray::writeStringF32(const std::string_view& val) {
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeStringF32(
+    const std::string_view& val) {
     writeFuint32(val.size());
     write(val.data(), val.size());
 }
 
-void ByteArray::writeStringF64(const std::string_view& val) {
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeStringF64(
+    const std::string_view& val) {
     writeFuint64(val.size());
     write(val.data(), val.size());
 }
 
-void ByteArray::writeStringVint(const std::string_view& val) {
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeStringVint(
+    const std::string_view& val) {
     writeUint64(val.size());
     write(val.data(), val.size());
 }
 
-void ByteArray::writeStringWithoutLength(const std::string_view& val) {
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::writeStringWithoutLength(
+    const std::string_view& val) {
     write(val.data(), val.size());
 }
 
-void ByteArray::write(const void* buf, size_t size) {
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::write(const void* buf, size_t size) {
     if (size == 0) return;
+    if (mapped_) throw std::logic_error("write to read-only mapped ByteArray");
 
     ensureCapacity(size);
 
@@ -174,43 +287,53 @@ void ByteArray::write(const void* buf, size_t size) {
     if (position_ > size_) size_ = position_;
 }
 
-int8_t ByteArray::readFint8() {
-    int8_t v;
-    read(&v, sizeof(v));
-    return v;
+template <class EndianPolicy>
+int8_t BasicByteArray<EndianPolicy>::readFint8() {
+    return readFixed<int8_t>();
 }
 
-uint8_t ByteArray::readFuint8() {
-    uint8_t v;
-    read(&v, sizeof(v));
-    return v;
+template <class EndianPolicy>
+uint8_t BasicByteArray<EndianPolicy>::readFuint8() {
+    return readFixed<uint8_t>();
 }
 
-#define XX(type)                      \
-    type v;                           \
-    read(&v, sizeof(v));              \
-    if (endian_ == LUTE_BYTE_ORDER) { \
-        return v;                     \
-    } else {                          \
-        return byteswap(v);           \
-    }
-
-int16_t ByteArray::readFint16() { XX(int16_t); }
-uint16_t ByteArray::readFuint16() { XX(uint16_t); }
+template <class EndianPolicy>
+int16_t BasicByteArray<EndianPolicy>::readFint16() {
+    return readFixed<int16_t>();
+}
 
-int32_t ByteArray::readFint32() { XX(int32_t); }
+template <class EndianPolicy>
+uint16_t BasicByteArray<EndianPolicy>::readFuint16() {
+    return readFixed<uint16_t>();
+}
 
-uint32_t ByteArray::readFuint32() { XX(uint32_t); }
+template <class EndianPolicy>
+int32_t BasicByteArray<EndianPolicy>::readFint32() {
+    return readFixed<int32_t>();
+}
 
-int64_t ByteArray::readFint64() { XX(int64_t); }
+template <class EndianPolicy>
+uint32_t BasicByteArray<EndianPolicy>::readFuint32() {
+    return readFixed<uint32_t>();
+}
 
-uint64_t ByteArray::readFuint64() { XX(uint64_t); }
+template <class EndianPolicy>
+int64_t BasicByteArray<EndianPolicy>::readFint64() {
+    return readFixed<int64_t>();
+}
 
-#undef XX
+template <class EndianPolicy>
+uint64_t BasicByteArray<EndianPolicy>::readFuint64() {
+    return readFixed<uint64_t>();
+}
 
-int32_t ByteArray::readInt32() { return DecodeZigzag32(readUint32()); }
+template <class EndianPolicy>
+int32_t BasicByteArray<EndianPolicy>::readInt32() {
+    return DecodeZigzag32(readUint32());
+}
 
-uint32_t ByteArray::readUint32() {
+template <class EndianPolicy>
+uint32_t BasicByteArray<EndianPolicy>::readUint32() {
     uint32_t result = 0;
     for (int i = 0; i < 32; i += 7) {
         uint8_t b = readFuint8();
@@ -224,9 +347,13 @@ uint32_t ByteArray::readUint32() {
     return result;
 }
 
-int64_t ByteArray::readInt64() { return DecodeZigzag64(readUint64()); }
+template <class EndianPolicy>
+int64_t BasicByteArray<EndianPolicy>::readInt64() {
+    return DecodeZigzag64(readUint64());
+}
 
-uint64_t ByteArray::readUint64() {
+template <class EndianPolicy>
+uint64_t BasicByteArray<EndianPolicy>::readUint64() {
     uint64_t result = 0;
     for (int i = 0; i < 64; i += 7) {
         uint8_t b = readFuint8();
@@ -240,21 +367,24 @@ uint64_t ByteArray::readUint64() {
     return result;
 }
 
-float ByteArray::readFloat() {
+template <class EndianPolicy>
+float BasicByteArray<EndianPolicy>::readFloat() {
     uint32_t v = readFuint32();
     float value;
     ::memcpy(&value, &v, sizeof(v));
     return value;
 }
 
-double ByteArray::readDouble() {
+template <class EndianPolicy>
+double BasicByteArray<EndianPolicy>::readDouble() {
     uint64_t v = readFuint64();
     double value;
     ::memcpy(&value, &v, sizeof(v));
     return value;
 }
 
-std::string ByteArray::readStringF16() {
+template <class EndianPolicy>
+std::string BasicByteArray<EndianPolicy>::readStringF16() {
     uint16_t len = readFuint16();
     std::string buff;
     buff.resize(len);
@@ -262,7 +392,8 @@ std::string ByteArray::readStringF16() {
     return buff;
 }
 
-std::string ByteArray::readStringF32() {
+template <class EndianPolicy>
+std::string BasicByteArray<EndianPolicy>::readStringF32() {
     uint32_t len = readFuint32();
     std::string buff;
     buff.resize(len);
@@ -270,7 +401,8 @@ std::string ByteArray::readStringF32() {
     return buff;
 }
 
-std::string ByteArray::readStringF64() {
+template <class EndianPolicy>
+std::string BasicByteArray<EndianPolicy>::readStringF64() {
     uint64_t len = readFuint64();
     std::string buff;
     buff.resize(len);
@@ -278,7 +410,8 @@ std::string ByteArray::readStringF64() {
     return buff;
 }
 
-std::string ByteArray::readStringVint() {
+template <class EndianPolicy>
+std::string BasicByteArray<EndianPolicy>::readStringVint() {
     uint64_t len = readUint64();
     std::string buff;
     buff.resize(len);
@@ -286,7 +419,8 @@ std::string ByteArray::readStringVint() {
     return buff;
 }
 
-void ByteArray::read(void* buf, size_t size) {
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::read(void* buf, size_t size) {
     if (size > readableSize()) {
         throw std::out_of_range("not enough len");
     }
@@ -317,7 +451,9 @@ void ByteArray::read(void* buf, size_t size) {
     }
 }
 
-void ByteArray::read(void* buf, size_t size, size_t position) const {
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::read(void* buf, size_t size,
+                                        size_t position) const {
     if (size > size_ - position) throw std::out_of_range("not enough len");
 
     size_t npos = position % baseSize_;
@@ -346,7 +482,8 @@ void ByteArray::read(void* buf, size_t size, size_t position) const {
     }
 }
 
-void ByteArray::setPosition(size_t val) {
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::setPosition(size_t val) {
     if (val > capacity_) throw std::out_of_range("set position out of range");
 
     position_ = val;
@@ -359,7 +496,8 @@ void ByteArray::setPosition(size_t val) {
     if (val == curr_->size_) curr_ = curr_->next_;
 }
 
-std::string ByteArray::toString() const {
+template <class EndianPolicy>
+std::string BasicByteArray<EndianPolicy>::toString() const {
     std::string str;
     str.resize(readableSize());
     if (str.empty()) return str;
@@ -367,21 +505,83 @@ std::string ByteArray::toString() const {
     return str;
 }
 
-std::string ByteArray::toHexString() const {
-    std::string str = toString();
-    std::stringstream ss;
-
-    for (size_t i = 0; i < str.size(); ++i) {
-        if (i > 0 && i % 32 == 0) ss << std::endl;
-        ss << std::setw(2) << std::setfill('0') << std::hex
-           << static_cast<int>(static_cast<uint8_t>(str[i])) << " ";
+template <class EndianPolicy>
+template <typename Func>
+void BasicByteArray<EndianPolicy>::forEachReadable(Func&& func) const {
+    size_t len = readableSize();
+    size_t npos = position_ % baseSize_;
+    Node* curr = curr_;
+    while (len > 0) {
+        size_t n = std::min(curr->size_ - npos, len);
+        func(curr->ptr_ + npos, n);
+        len -= n;
+        curr = curr->next_;
+        npos = 0;
     }
+}
+
+template <class EndianPolicy>
+std::string BasicByteArray<EndianPolicy>::toHexString() const {
+    const size_t kBytesPerLine = 32;
+    size_t size = readableSize();
+    std::string str;
+    if (size == 0) return str;
+    // 每字节 "xx " 3 个字符, 每满 32 字节 (最后一行除外) 一个换行
+    str.resize(size * 3 + (size - 1) / kBytesPerLine);
+
+    char* out = &str[0];
+    char line[kBytesPerLine];
+    char hex[kBytesPerLine * 2];
+    size_t lineLen = 0;
+    size_t written = 0;
+    auto flushLine = [&]() {
+        if (written > 0) *out++ = '\n';
+        hexEncode(line, lineLen, hex);
+        for (size_t i = 0; i < lineLen; ++i) {
+            *out++ = hex[2 * i];
+            *out++ = hex[2 * i + 1];
+            *out++ = ' ';
+        }
+        written += lineLen;
+        lineLen = 0;
+    };
+
+    forEachReadable([&](const char* ptr, size_t len) {
+        while (len > 0) {
+            size_t n = std::min(kBytesPerLine - lineLen, len);
+            ::memcpy(line + lineLen, ptr, n);
+            lineLen += n;
+            ptr += n;
+            len -= n;
+            if (lineLen == kBytesPerLine) flushLine();
+        }
+    });
+    if (lineLen > 0) flushLine();
+
+    return str;
+}
+
+template <class EndianPolicy>
+uint32_t BasicByteArray<EndianPolicy>::crc32c() const {
+    uint32_t crc = 0;
+    forEachReadable(
+        [&](const char* ptr, size_t len) {
+            crc = Lute::crc32c(ptr, len, crc);
+        });
+    return crc;
+}
 
-    return ss.str();
+template <class EndianPolicy>
+uint64_t BasicByteArray<EndianPolicy>::xxhash64(uint64_t seed) const {
+    XXHash64 hasher(seed);
+    forEachReadable(
+        [&](const char* ptr, size_t len) { hasher.update(ptr, len); });
+    return hasher.digest();
 }
 
-uint64_t ByteArray::readableBuffers(std::vector<iovec>& buffers,
-                                    uint64_t len) const {
+template <class EndianPolicy>
+uint64_t BasicByteArray<EndianPolicy>::readableBuffers(
+    std::vector<iovec>& buffers, uint64_t len) const {
     len = len > readableSize() ? readableSize() : len;
     if (len == 0) return 0;
 
@@ -410,8 +610,9 @@ uint64_t ByteArray::readableBuffers(std::vector<iovec>& buffers,
     return size;
 }
 
-uint64_t ByteArray::readableBuffers(std::vector<iovec>& buffers, uint64_t len,
-                                    uint64_t position) const {
+template <class EndianPolicy>
+uint64_t BasicByteArray<EndianPolicy>::readableBuffers(
+    std::vector<iovec>& buffers, uint64_t len, uint64_t position) const {
     len = len > readableSize() ? readableSize() : len;
     if (len == 0) return 0;
 
@@ -446,8 +647,11 @@ uint64_t ByteArray::readableBuffers(std::vector<iovec>& buffers, uint64_t len,
     return size;
 }
 
-uint64_t ByteArray::writableBuffers(std::vector<iovec>& buffers, uint64_t len) {
+template <class EndianPolicy>
+uint64_t BasicByteArray<EndianPolicy>::writableBuffers(
+    std::vector<iovec>& buffers, uint64_t len) {
     if (len == 0) return 0;
+    if (mapped_) throw std::logic_error("write to read-only mapped ByteArray");
     ensureCapacity(len);
     uint64_t size = len;
 
@@ -474,7 +678,15 @@ uint64_t ByteArray::writableBuffers(std::vector<iovec>& buffers, uint64_t len) {
     return size;
 }
 
-bool ByteArray::readFromFile(const std::string_view& name) {
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::reserve(size_t size) {
+    if (mapped_) throw std::logic_error("write to read-only mapped ByteArray");
+    ensureCapacity(size);
+}
+
+template <class EndianPolicy>
+bool BasicByteArray<EndianPolicy>::readFromFile(
+    const std::string_view& name) {
     std::ifstream ifs;
     if (!Lute::FSUtil::openForRead(ifs, name.data(), std::ios_base::binary)) {
         LOG_ERROR << "readFromFile name=" << name.data()
@@ -493,7 +705,9 @@ bool ByteArray::readFromFile(const std::string_view& name) {
     return true;
 }
 
-bool ByteArray::writeToFile(const std::string_view& name) const {
+template <class EndianPolicy>
+bool BasicByteArray<EndianPolicy>::writeToFile(
+    const std::string_view& name) const {
     std::ofstream ofs;
     if (!Lute::FSUtil::openForWrite(ofs, name.data(), std::ios_base::binary)) {
         LOG_ERROR << "writeToFile name=" << name.data()
@@ -519,20 +733,153 @@ bool ByteArray::writeToFile(const std::string_view& name) const {
     return true;
 }
 
-void ByteArray::clear() {
+template <class EndianPolicy>
+bool BasicByteArray<EndianPolicy>::mmapFromFile(
+    const std::string_view& name) {
+    int fd = ::open(name.data(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG_ERROR << "mmapFromFile name=" << name.data()
+                  << " error, errno= " << errno
+                  << " errstr=" << strerror_tl(errno);
+        return false;
+    }
+
+    struct stat st {};
+    if (::fstat(fd, &st) != 0) {
+        LOG_ERROR << "mmapFromFile fstat name=" << name.data()
+                  << " error, errno= " << errno
+                  << " errstr=" << strerror_tl(errno);
+        ::close(fd);
+        return false;
+    }
+
+    clear();
+    // mmap(2) 不允许长度为 0 的映射，空文件直接得到空的 ByteArray
+    if (st.st_size == 0) {
+        ::close(fd);
+        return true;
+    }
+
+    auto len = static_cast<size_t>(st.st_size);
+    void* addr = ::mmap(nullptr, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    // 映射建立后即可关闭 fd，映射仍然有效
+    ::close(fd);
+    if (addr == MAP_FAILED) {
+        LOG_ERROR << "mmapFromFile mmap name=" << name.data()
+                  << " error, errno= " << errno
+                  << " errstr=" << strerror_tl(errno);
+        return false;
+    }
+
+    nodePool().release(root_);
+    mapped_ = static_cast<char*>(addr);
+    root_ = curr_ = nodePool().acquire(mapped_, len);
+    // 整个映射作为唯一的内存块，position_ % baseSize_ 即块内偏移
+    baseSize_ = capacity_ = size_ = len;
+    position_ = 0;
+    return true;
+}
+
+template <class EndianPolicy>
+bool BasicByteArray<EndianPolicy>::advise(Advice advice, size_t position,
+                                          size_t len) const {
+    if (!mapped_ || position >= size_) return false;
+
+    int flag = MADV_NORMAL;
+    switch (advice) {
+        case Advice::NORMAL:
+            flag = MADV_NORMAL;
+            break;
+        case Advice::SEQUENTIAL:
+            flag = MADV_SEQUENTIAL;
+            break;
+        case Advice::RANDOM:
+            flag = MADV_RANDOM;
+            break;
+        case Advice::WILLNEED:
+            flag = MADV_WILLNEED;
+            break;
+        case Advice::DONTNEED:
+            flag = MADV_DONTNEED;
+            break;
+    }
+
+    // madvise 要求起始地址按页对齐
+    static const size_t kPageSize = ::sysconf(_SC_PAGESIZE);
+    size_t begin = position / kPageSize * kPageSize;
+    size_t end = len > size_ - position ? size_ : position + len;
+    return ::madvise(mapped_ + begin, end - begin, flag) == 0;
+}
+
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::unmap() {
+    ::munmap(mapped_, capacity_);
+    mapped_ = nullptr;
+    nodePool().release(root_);
+
+    baseSize_ = capacity_ = heapBaseSize_;
     position_ = size_ = 0;
+    root_ = curr_ = nodePool().acquire(baseSize_);
+}
+
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::clear() {
+    if (mapped_) {
+        unmap();
+        return;
+    }
+
+    position_ = size_ = 0;
+    curr_ = root_;
+    if (ring_) return;
+
     capacity_ = baseSize_;
     Node* tmp = root_->next_;
     while (nullptr != tmp) {
         curr_ = tmp;
         tmp = tmp->next_;
-        delete curr_;
+        nodePool().release(curr_);
     }
     curr_ = root_;
     root_->next_ = nullptr;
 }
 
-void ByteArray::ensureCapacity(size_t size) {
+template <class EndianPolicy>
+size_t BasicByteArray<EndianPolicy>::discardRead() {
+    if (mapped_) return 0;
+
+    size_t count = position_ / baseSize_;
+    if (count == 0) return 0;
+
+    Node* tail = root_;
+    while (tail->next_) tail = tail->next_;
+
+    for (size_t i = 0; i < count; ++i) {
+        Node* node = root_;
+        // 已经是最后一个内存块，保留下来复用
+        if (node == tail) break;
+
+        root_ = node->next_;
+        node->next_ = nullptr;
+        if (ring_) {
+            tail->next_ = node;
+            tail = node;
+        } else {
+            nodePool().release(node);
+            capacity_ -= baseSize_;
+        }
+    }
+
+    size_t discarded = count * baseSize_;
+    position_ -= discarded;
+    size_ -= discarded;
+    // 原先所有内存块都已写满并读完, 从第一个内存块重新开始
+    if (curr_ == nullptr) curr_ = root_;
+    return discarded;
+}
+
+template <class EndianPolicy>
+void BasicByteArray<EndianPolicy>::ensureCapacity(size_t size) {
     if (size == 0) return;
 
     size_t oldCap = writableCapacity();
@@ -545,11 +892,17 @@ void ByteArray::ensureCapacity(size_t size) {
 
     Node* first = nullptr;
     for (size_t i = 0; i < count; ++i) {
-        tmp->next_ = new Node(baseSize_);
+        tmp->next_ = nodePool().acquire(baseSize_);
         if (first == nullptr) first = tmp->next_;
         tmp = tmp->next_;
         capacity_ += baseSize_;
     }
 
     if (oldCap == 0) curr_ = first;
-}
\ No newline at end of file
+}
+
+namespace Lute {
+template class BasicByteArray<RuntimeEndian>;
+template class BasicByteArray<LittleEndian>;
+template class BasicByteArray<BigEndian>;
+}  // namespace Lute
@@ -0,0 +1,218 @@
+#include <Base/checksum.h>
+#include <Base/endian.h>  // byteswapOnBigEndian
+
+#include <cstring>  // memcpy
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>  // _mm_crc32_u8, _mm_crc32_u64
+#endif
+
+namespace {
+/// @brief 小端读取，大端机器上做 byteswap
+inline uint64_t load64(const unsigned char* p) {
+    uint64_t v;
+    ::memcpy(&v, p, sizeof(v));
+    return Lute::byteswapOnBigEndian(v);
+}
+
+inline uint32_t load32(const unsigned char* p) {
+    uint32_t v;
+    ::memcpy(&v, p, sizeof(v));
+    return Lute::byteswapOnBigEndian(v);
+}
+
+inline uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+/// NOTE ----------- CRC32C -----------
+
+/// @brief CRC32C 多项式 (bit-reversed)
+const uint32_t kCrc32cPoly = 0x82F63B78;
+
+/// @brief slicing-by-8 查找表
+struct Crc32cTable {
+    uint32_t table[8][256];
+
+    Crc32cTable() {
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t crc = i;
+            for (int k = 0; k < 8; ++k) {
+                crc = (crc & 1) ? (crc >> 1) ^ kCrc32cPoly : crc >> 1;
+            }
+            table[0][i] = crc;
+        }
+        for (uint32_t i = 0; i < 256; ++i) {
+            for (int s = 1; s < 8; ++s) {
+                uint32_t prev = table[s - 1][i];
+                table[s][i] = (prev >> 8) ^ table[0][prev & 0xFF];
+            }
+        }
+    }
+};
+
+uint32_t crc32cSoftware(uint32_t crc, const unsigned char* p, size_t len) {
+    static const Crc32cTable kTable;
+    const auto& t = kTable.table;
+
+    crc = ~crc;
+    while (len >= 8) {
+        uint64_t word = load64(p);
+        auto lo = static_cast<uint32_t>(word) ^ crc;
+        auto hi = static_cast<uint32_t>(word >> 32);
+        crc = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^
+              t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^ t[3][hi & 0xFF] ^
+              t[2][(hi >> 8) & 0xFF] ^ t[1][(hi >> 16) & 0xFF] ^ t[0][hi >> 24];
+        p += 8;
+        len -= 8;
+    }
+    while (len-- > 0) crc = t[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+    return ~crc;
+}
+
+#if defined(__x86_64__)
+__attribute__((target("sse4.2"))) uint32_t crc32cHardware(
+    uint32_t crc, const unsigned char* p, size_t len) {
+    uint64_t c = ~crc;
+    while (len >= 8) {
+        uint64_t word;
+        ::memcpy(&word, p, sizeof(word));
+        c = _mm_crc32_u64(c, word);
+        p += 8;
+        len -= 8;
+    }
+    auto c32 = static_cast<uint32_t>(c);
+    while (len-- > 0) c32 = _mm_crc32_u8(c32, *p++);
+    return ~c32;
+}
+#endif
+
+using Crc32cFunc = uint32_t (*)(uint32_t, const unsigned char*, size_t);
+
+/// @brief 运行时检测 CPU 是否支持 SSE4.2 crc32 指令
+Crc32cFunc selectCrc32c() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("sse4.2")) return crc32cHardware;
+#endif
+    return crc32cSoftware;
+}
+
+/// NOTE ----------- xxHash64 -----------
+const uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+const uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+const uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+const uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+const uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+inline uint64_t xxRound(uint64_t acc, uint64_t input) {
+    acc += input * kPrime2;
+    acc = rotl64(acc, 31);
+    return acc * kPrime1;
+}
+
+inline uint64_t xxMergeRound(uint64_t acc, uint64_t val) {
+    acc ^= xxRound(0, val);
+    return acc * kPrime1 + kPrime4;
+}
+}  // namespace
+
+uint32_t Lute::crc32c(const void* data, size_t len, uint32_t crc) {
+    static const Crc32cFunc kFunc = selectCrc32c();
+    return kFunc(crc, static_cast<const unsigned char*>(data), len);
+}
+
+Lute::XXHash64::XXHash64(uint64_t seed) { reset(seed); }
+
+void Lute::XXHash64::reset(uint64_t seed) {
+    seed_ = seed;
+    acc_[0] = seed + kPrime1 + kPrime2;
+    acc_[1] = seed + kPrime2;
+    acc_[2] = seed;
+    acc_[3] = seed - kPrime1;
+    bufLen_ = 0;
+    totalLen_ = 0;
+}
+
+void Lute::XXHash64::update(const void* data, size_t len) {
+    const auto* p = static_cast<const unsigned char*>(data);
+    totalLen_ += len;
+
+    // 先补齐上次剩余的不足 32 字节的数据
+    if (bufLen_ > 0) {
+        size_t fill = sizeof(buf_) - bufLen_;
+        if (len < fill) {
+            ::memcpy(buf_ + bufLen_, p, len);
+            bufLen_ += len;
+            return;
+        }
+        ::memcpy(buf_ + bufLen_, p, fill);
+        for (int i = 0; i < 4; ++i) {
+            acc_[i] = xxRound(acc_[i], load64(buf_ + i * 8));
+        }
+        p += fill;
+        len -= fill;
+        bufLen_ = 0;
+    }
+
+    uint64_t a0 = acc_[0], a1 = acc_[1], a2 = acc_[2], a3 = acc_[3];
+    while (len >= 32) {
+        a0 = xxRound(a0, load64(p));
+        a1 = xxRound(a1, load64(p + 8));
+        a2 = xxRound(a2, load64(p + 16));
+        a3 = xxRound(a3, load64(p + 24));
+        p += 32;
+        len -= 32;
+    }
+    acc_[0] = a0;
+    acc_[1] = a1;
+    acc_[2] = a2;
+    acc_[3] = a3;
+
+    if (len > 0) {
+        ::memcpy(buf_, p, len);
+        bufLen_ = len;
+    }
+}
+
+uint64_t Lute::XXHash64::digest() const {
+    uint64_t h;
+    if (totalLen_ >= 32) {
+        h = rotl64(acc_[0], 1) + rotl64(acc_[1], 7) + rotl64(acc_[2], 12) +
+            rotl64(acc_[3], 18);
+        for (uint64_t acc : acc_) h = xxMergeRound(h, acc);
+    } else {
+        h = seed_ + kPrime5;
+    }
+    h += totalLen_;
+
+    const unsigned char* p = buf_;
+    size_t len = bufLen_;
+    while (len >= 8) {
+        h ^= xxRound(0, load64(p));
+        h = rotl64(h, 27) * kPrime1 + kPrime4;
+        p += 8;
+        len -= 8;
+    }
+    if (len >= 4) {
+        h ^= static_cast<uint64_t>(load32(p)) * kPrime1;
+        h = rotl64(h, 23) * kPrime2 + kPrime3;
+        p += 4;
+        len -= 4;
+    }
+    while (len-- > 0) {
+        h ^= (*p++) * kPrime5;
+        h = rotl64(h, 11) * kPrime1;
+    }
+
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+uint64_t Lute::XXHash64::hash(const void* data, size_t len, uint64_t seed) {
+    XXHash64 hasher(seed);
+    hasher.update(data, len);
+    return hasher.digest();
+}
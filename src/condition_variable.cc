@@ -1,6 +1,6 @@
 #include <Base/condition_variable.h>
 
-bool Lute::Condition::waitForSeconds(double seconds) {
+Lute::Condition::Condition(MutexLock& mutex) : mutex_(mutex) {
     /**
      * 在 Linux 系统中，有多种时钟可以用来获取时间信息:
      *      CLOCK_REALTIME, CLOCK_MONOTONIC, CLOCK_MONOTIC_RAW 等
@@ -12,23 +12,33 @@ bool Lute::Condition::waitForSeconds(double seconds) {
      * 区别:
         CLOCK_MONOTONIC 时钟可能会受到时间调整的影响（例如 NTP 校时），
         CLOCK_MONOTONIC_RAW 时钟则不受影响
+     * pthread_cond_timedwait 只支持 CLOCK_REALTIME 与 CLOCK_MONOTONIC，
+        默认属性下截止时间按 CLOCK_REALTIME 解释，因此须显式设置时钟
      */
-    struct timespec abstime {};
-#ifdef CLOCK_MONOTONIC_RAW
-    ::clock_gettime(CLOCK_MONOTONIC_RAW, &abstime);
-#else
-    ::clock_gettime(CLOCK_MONOTONIC, &abstime);
-#endif
+    pthread_condattr_t attr;
+    MCHECK(pthread_condattr_init(&attr));
+    MCHECK(pthread_condattr_setclock(&attr, CLOCK_MONOTONIC));
+    MCHECK(pthread_cond_init(&pcond_, &attr));
+    MCHECK(pthread_condattr_destroy(&attr));
+}
 
-    const int64_t kNanoSecondsPerSecond = 1E9;
-    auto nanoseconds = static_cast<int64_t>(seconds * kNanoSecondsPerSecond);
+bool Lute::Condition::waitUntil(Clock::time_point deadline) {
+    // libstdc++ 的 steady_clock 即 CLOCK_MONOTONIC
+    const int64_t kNanoSecondsPerSecond = 1000 * 1000 * 1000;
+    int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     deadline.time_since_epoch())
+                     .count();
+    if (ns < 0) ns = 0;
 
-    abstime.tv_sec += static_cast<time_t>((abstime.tv_nsec + nanoseconds) /
-                                          kNanoSecondsPerSecond);
-    abstime.tv_nsec = static_cast<long>((abstime.tv_nsec + nanoseconds) %
-                                        kNanoSecondsPerSecond);
+    struct timespec abstime {};
+    abstime.tv_sec = static_cast<time_t>(ns / kNanoSecondsPerSecond);
+    abstime.tv_nsec = static_cast<long>(ns % kNanoSecondsPerSecond);
 
     MutexLock::UnassignGuard ug(mutex_);
     return ETIMEDOUT == ::pthread_cond_timedwait(
                             &pcond_, mutex_.getPthreadMutex(), &abstime);
 }
+
+bool Lute::Condition::waitFor(int64_t nanoseconds) {
+    return waitUntil(Clock::now() + std::chrono::nanoseconds(nanoseconds));
+}
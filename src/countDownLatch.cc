@@ -1,24 +1,47 @@
 #include <Base/countDownLatch.h>
+#include <Base/futex.h>
 
 Lute::CountDownLatch::CountDownLatch(int count)
-    : mutex_(), condition_(mutex_), count_(count) {}
+    : state_(count > 0 ? static_cast<uint32_t>(count) : 0) {}
 
-void Lute::CountDownLatch::wait() {
-    MutexLockGuard lock(mutex_);
-    while (count_ > 0) {
-        condition_.wait();
+void Lute::CountDownLatch::wait() { waitFor(-1); }
+
+bool Lute::CountDownLatch::waitFor(int64_t timeoutNs) {
+    const int64_t deadline = timeoutNs >= 0 ? monotonicNs() + timeoutNs : 0;
+    uint32_t state = state_.load(std::memory_order_acquire);
+    while ((state & kCountMask) != 0) {
+        // 先登记等待者，countDown 看到标志位才会唤醒
+        if (!(state & kWaiters)) {
+            if (!state_.compare_exchange_weak(state, state | kWaiters,
+                                              std::memory_order_acquire)) {
+                continue;
+            }
+            state |= kWaiters;
+        }
+
+        int64_t remaining = -1;
+        if (timeoutNs >= 0) {
+            remaining = deadline - monotonicNs();
+            if (remaining <= 0) return false;
+        }
+        Futex::wait(&state_, state, remaining);
+        state = state_.load(std::memory_order_acquire);
     }
+    return true;
 }
 
 void Lute::CountDownLatch::countDown() {
-    MutexLockGuard lock(mutex_);
-    --count_;
-    if (count_ == 0) {
-        condition_.notifyAll();
+    uint32_t state = state_.load(std::memory_order_relaxed);
+    for (;;) {
+        if ((state & kCountMask) == 0) return;
+        uint32_t next = state - 1;
+        // 计数减到零时清除标志位，之后的 wait 不再进入内核
+        if ((next & kCountMask) == 0) next = 0;
+        if (state_.compare_exchange_weak(state, next,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_relaxed)) {
+            break;
+        }
     }
-}
-
-int Lute::CountDownLatch::getCount() const {
-    MutexLockGuard lock(mutex_);
-    return count_;
+    if ((state & kCountMask) == 1 && (state & kWaiters)) Futex::wake(&state_);
 }
@@ -0,0 +1,96 @@
+#include <Base/endian.h>
+
+#include <cstring>  // memcpy
+
+#if defined(__x86_64__)
+#include <immintrin.h>  // _mm_shuffle_epi8, _mm256_shuffle_epi8
+#endif
+
+namespace {
+template <class T>
+void swapScalar(char* p, size_t count) {
+    for (size_t i = 0; i < count; ++i, p += sizeof(T)) {
+        T v;
+        ::memcpy(&v, p, sizeof(v));
+        v = Lute::byteswap(v);
+        ::memcpy(p, &v, sizeof(v));
+    }
+}
+
+void swapScalar(char* p, size_t width, size_t count) {
+    switch (width) {
+        case 2:
+            swapScalar<uint16_t>(p, count);
+            break;
+        case 4:
+            swapScalar<uint32_t>(p, count);
+            break;
+        case 8:
+            swapScalar<uint64_t>(p, count);
+            break;
+        default:
+            break;
+    }
+}
+
+#if defined(__x86_64__)
+/// @brief 16 字节内按元素宽度反转字节顺序的 pshufb 掩码
+__attribute__((target("ssse3"))) __m128i swapMask(size_t width) {
+    switch (width) {
+        case 2:
+            return _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12,
+                                 15, 14);
+        case 4:
+            return _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14,
+                                 13, 12);
+        default:
+            return _mm_setr_epi8(7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11,
+                                 10, 9, 8);
+    }
+}
+
+__attribute__((target("ssse3"))) void swapSsse3(char* p, size_t width,
+                                                 size_t count) {
+    const __m128i mask = swapMask(width);
+    size_t bytes = width * count;
+    size_t i = 0;
+    for (; i + 16 <= bytes; i += 16) {
+        auto* addr = reinterpret_cast<__m128i*>(p + i);
+        _mm_storeu_si128(addr, _mm_shuffle_epi8(_mm_loadu_si128(addr), mask));
+    }
+    swapScalar(p + i, width, (bytes - i) / width);
+}
+
+__attribute__((target("avx2"))) void swapAvx2(char* p, size_t width,
+                                               size_t count) {
+    // vpshufb 在两个 128 位 lane 内分别查表，掩码重复两份即可
+    const __m256i mask = _mm256_broadcastsi128_si256(swapMask(width));
+    size_t bytes = width * count;
+    size_t i = 0;
+    for (; i + 32 <= bytes; i += 32) {
+        auto* addr = reinterpret_cast<__m256i*>(p + i);
+        __m256i v = _mm256_loadu_si256(addr);
+        _mm256_storeu_si256(addr, _mm256_shuffle_epi8(v, mask));
+    }
+    swapSsse3(p + i, width, (bytes - i) / width);
+}
+#endif
+
+using SwapFunc = void (*)(char*, size_t, size_t);
+
+/// @brief 运行时检测 CPU 支持的指令集
+SwapFunc selectSwap() {
+#if defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2")) return swapAvx2;
+    if (__builtin_cpu_supports("ssse3")) return swapSsse3;
+#endif
+    return swapScalar;
+}
+}  // namespace
+
+void Lute::byteswapBuffer(void* data, size_t width, size_t count) {
+    static const SwapFunc kFunc = selectSwap();
+    if (width != 2 && width != 4 && width != 8) return;
+    kFunc(static_cast<char*>(data), width, count);
+}
@@ -0,0 +1,357 @@
+#include <Base/countDownLatch.h>
+#include <Base/currentThread.h>
+#include <Base/eventLoop.h>
+#include <Base/futex.h>  // monotonicNs
+#include <Base/logger.h>
+#include <sys/eventfd.h>  // eventfd
+#include <unistd.h>       // close, read, write, sysconf
+
+#include <algorithm>  // max
+#include <cassert>    // assert
+#include <cerrno>     // errno
+#include <climits>    // INT_MAX
+
+namespace {
+__thread Lute::EventLoop* t_loopInThisThread = nullptr;
+
+/// 定时器精度
+const int64_t kTickNs = 1000000;
+const int kInitEventListSize = 16;
+
+/// epoll_event.data 中同时保存 fd 与注册代数
+inline uint64_t packData(int fd, uint32_t generation) {
+    return (static_cast<uint64_t>(generation) << 32) |
+           static_cast<uint32_t>(fd);
+}
+}  // namespace
+
+using namespace Lute;
+
+/// NOTE ----------- EventLoop -----------
+EventLoop* EventLoop::getEventLoopOfCurrentThread() {
+    return t_loopInThisThread;
+}
+
+EventLoop::EventLoop()
+    : looping_(false),
+      quit_(false),
+      callingPendingFunctors_(false),
+      iteration_(0),
+      threadId_(CurrentThread::tid()),
+      epollfd_(::epoll_create1(EPOLL_CLOEXEC)),
+      wakeupFd_(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+      events_(kInitEventListSize),
+      mutex_("EventLoop"),
+      startNs_(monotonicNs()),
+      timerMutex_("EventLoop.timers") {
+    if (epollfd_ < 0) LOG_SYSFATAL << "EventLoop: epoll_create1 failed";
+    if (wakeupFd_ < 0) LOG_SYSFATAL << "EventLoop: eventfd failed";
+    if (t_loopInThisThread) {
+        LOG_FATAL << "Another EventLoop " << t_loopInThisThread
+                  << " exists in this thread " << threadId_;
+    }
+    t_loopInThisThread = this;
+
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLET;
+    event.data.u64 = packData(wakeupFd_, 0);
+    if (::epoll_ctl(epollfd_, EPOLL_CTL_ADD, wakeupFd_, &event) < 0) {
+        LOG_SYSFATAL << "EventLoop: epoll_ctl wakeupFd failed";
+    }
+}
+
+EventLoop::~EventLoop() {
+    ::close(wakeupFd_);
+    ::close(epollfd_);
+    t_loopInThisThread = nullptr;
+}
+
+void EventLoop::loop() {
+    assert(!looping_);
+    assertInLoopThread();
+    looping_ = true;
+
+    while (!quit_.load(std::memory_order_acquire)) {
+        int numEvents = ::epoll_wait(epollfd_, events_.data(),
+                                     static_cast<int>(events_.size()),
+                                     pollTimeoutMs());
+        int savedErrno = errno;
+        ++iteration_;
+        if (numEvents < 0 && savedErrno != EINTR) {
+            errno = savedErrno;
+            LOG_SYSERR << "EventLoop::loop epoll_wait";
+        }
+
+        for (int i = 0; i < numEvents; ++i) {
+            uint64_t data = events_[i].data.u64;
+            int fd = static_cast<int>(data & 0xFFFFFFFF);
+            auto generation = static_cast<uint32_t>(data >> 32);
+            if (fd == wakeupFd_) {
+                handleWakeup();
+                continue;
+            }
+            if (static_cast<size_t>(fd) >= handlers_.size()) continue;
+            Handler* handler = &handlers_[fd];
+            // 本轮之前的回调中已移除或重新注册
+            if (!handler->registered || handler->generation != generation) {
+                continue;
+            }
+
+            // 回调中可能移除自己，执行期间回调对象移到局部变量
+            IoCallback cb = std::move(handler->cb);
+            cb(events_[i].events);
+            handler = &handlers_[fd];  // handlers_ 可能扩容
+            if (handler->registered && handler->generation == generation) {
+                handler->cb = std::move(cb);
+            }
+        }
+        if (static_cast<size_t>(numEvents) == events_.size()) {
+            events_.resize(events_.size() * 2);
+        }
+
+        runTimers();
+        doPendingFunctors();
+    }
+    looping_ = false;
+}
+
+void EventLoop::quit() {
+    quit_ = true;
+    // 循环线程中调用时，本轮结束后自然退出
+    if (!isInLoopThread()) wakeup();
+}
+
+void EventLoop::runInLoop(Functor cb) {
+    if (isInLoopThread()) {
+        cb();
+    } else {
+        queueInLoop(std::move(cb));
+    }
+}
+
+void EventLoop::queueInLoop(Functor cb) {
+    {
+        FastMutexGuard lock(mutex_);
+        pendingFunctors_.push_back(std::move(cb));
+    }
+    // 执行投递任务期间新投递的任务需要下一轮处理，不能阻塞在 epoll_wait
+    if (!isInLoopThread() || callingPendingFunctors_) wakeup();
+}
+
+size_t EventLoop::queueSize() const {
+    FastMutexGuard lock(mutex_);
+    return pendingFunctors_.size();
+}
+
+void EventLoop::addFd(int fd, uint32_t events, IoCallback cb) {
+    assertInLoopThread();
+    assert(fd >= 0);
+    if (static_cast<size_t>(fd) >= handlers_.size()) handlers_.resize(fd + 1);
+    Handler& handler = handlers_[fd];
+    assert(!handler.registered);
+    handler.cb = std::move(cb);
+    handler.events = events | EPOLLET;
+    ++handler.generation;
+    handler.registered = true;
+    epollControl(EPOLL_CTL_ADD, fd, handler);
+}
+
+void EventLoop::updateFd(int fd, uint32_t events) {
+    assertInLoopThread();
+    assert(hasFd(fd));
+    Handler& handler = handlers_[fd];
+    handler.events = events | EPOLLET;
+    epollControl(EPOLL_CTL_MOD, fd, handler);
+}
+
+void EventLoop::removeFd(int fd) {
+    assertInLoopThread();
+    assert(hasFd(fd));
+    Handler& handler = handlers_[fd];
+    epollControl(EPOLL_CTL_DEL, fd, handler);
+    handler.registered = false;
+    handler.cb = nullptr;
+}
+
+bool EventLoop::hasFd(int fd) const {
+    assertInLoopThread();
+    return fd >= 0 && static_cast<size_t>(fd) < handlers_.size() &&
+           handlers_[fd].registered;
+}
+
+TimerId EventLoop::runAt(Timestamp time, Functor cb) {
+    return addTimer(timeDifference(time, Timestamp::now()), std::move(cb), 0);
+}
+
+TimerId EventLoop::runAfter(double delay, Functor cb) {
+    return addTimer(delay, std::move(cb), 0);
+}
+
+TimerId EventLoop::runEvery(double interval, Functor cb) {
+    return addTimer(interval, std::move(cb), interval);
+}
+
+bool EventLoop::cancel(TimerId id) {
+    FastMutexGuard lock(timerMutex_);
+    return timers_.cancel(id);
+}
+
+void EventLoop::wakeup() {
+    uint64_t one = 1;
+    ssize_t n = ::write(wakeupFd_, &one, sizeof(one));
+    if (n != sizeof(one)) {
+        LOG_ERROR << "EventLoop::wakeup() writes " << n
+                  << " bytes instead of 8";
+    }
+}
+
+bool EventLoop::isInLoopThread() const {
+    return threadId_ == CurrentThread::tid();
+}
+
+void EventLoop::abortNotInLoopThread() const {
+    LOG_FATAL << "EventLoop " << this << " was created in threadId_ = "
+              << threadId_
+              << ", current thread id = " << CurrentThread::tid();
+}
+
+void EventLoop::handleWakeup() {
+    uint64_t one = 0;
+    ssize_t n = ::read(wakeupFd_, &one, sizeof(one));
+    if (n != sizeof(one) && errno != EAGAIN) {
+        LOG_ERROR << "EventLoop::handleWakeup() reads " << n
+                  << " bytes instead of 8";
+    }
+}
+
+void EventLoop::doPendingFunctors() {
+    std::vector<Functor> functors;
+    callingPendingFunctors_ = true;
+    {
+        FastMutexGuard lock(mutex_);
+        functors.swap(pendingFunctors_);
+    }
+    for (const Functor& functor : functors) functor();
+    callingPendingFunctors_ = false;
+}
+
+void EventLoop::runTimers() {
+    FastMutexGuard lock(timerMutex_);
+    auto now = static_cast<uint64_t>((monotonicNs() - startNs_) / kTickNs);
+    if (now <= timers_.currentTick()) return;
+    // 回调中可以添加或取消定时器，执行期间释放锁
+    timers_.advance(now, [this](TimerWheel::Callback& cb) {
+        timerMutex_.unlock();
+        cb();
+        timerMutex_.lock();
+    });
+}
+
+int EventLoop::pollTimeoutMs() {
+    int64_t deadlineNs = 0;
+    {
+        FastMutexGuard lock(timerMutex_);
+        int64_t dist = timers_.ticksUntilNextExpiry();
+        if (dist < 0) return -1;
+        deadlineNs = startNs_ +
+                     static_cast<int64_t>(timers_.currentTick() + dist) *
+                         kTickNs;
+    }
+    int64_t remaining = deadlineNs - monotonicNs();
+    if (remaining <= 0) return 0;
+    // 向上取整，避免提前醒来空转
+    int64_t ms = (remaining + 999999) / 1000000;
+    return ms > INT_MAX ? INT_MAX : static_cast<int>(ms);
+}
+
+TimerId EventLoop::addTimer(double delay, Functor cb, double interval) {
+    TimerId id;
+    {
+        FastMutexGuard lock(timerMutex_);
+        // 向上取整到 tick，定时器不会提前执行
+        int64_t deadlineNs = monotonicNs() - startNs_ +
+                             static_cast<int64_t>(std::max(delay, 0.0) * 1e9);
+        auto target = static_cast<uint64_t>((deadlineNs + kTickNs - 1) /
+                                            kTickNs);
+        uint64_t current = timers_.currentTick();
+        uint64_t ticks = target > current ? target - current : 1;
+        id = timers_.add(ticks, std::move(cb),
+                         TimerWheel::periodTicks(interval, kTickNs));
+    }
+    // 循环线程可能正以更晚的超时阻塞在 epoll_wait 中
+    if (!isInLoopThread()) wakeup();
+    return id;
+}
+
+void EventLoop::epollControl(int op, int fd, const Handler& handler) {
+    struct epoll_event event;
+    event.events = handler.events;
+    event.data.u64 = packData(fd, handler.generation);
+    if (::epoll_ctl(epollfd_, op, fd, &event) < 0) {
+        if (op == EPOLL_CTL_DEL) {
+            LOG_SYSERR << "epoll_ctl op = DEL fd = " << fd;
+        } else {
+            LOG_SYSFATAL << "epoll_ctl op = " << op << " fd = " << fd;
+        }
+    }
+}
+
+/// NOTE ----------- EventLoopThreadPool -----------
+EventLoopThreadPool::EventLoopThreadPool(const std::string& name)
+    : name_(name), affinity_(false), started_(false), next_(0) {}
+
+EventLoopThreadPool::~EventLoopThreadPool() {
+    if (started_) stop();
+}
+
+void EventLoopThreadPool::start(int numThreads, const ThreadInitCallback& cb) {
+    assert(!started_);
+    int numCpus = static_cast<int>(::sysconf(_SC_NPROCESSORS_ONLN));
+    if (numCpus <= 0) numCpus = 1;
+    if (numThreads <= 0) numThreads = numCpus;
+
+    started_ = true;
+    loops_.assign(numThreads, nullptr);
+    CountDownLatch latch(numThreads);
+    threads_.reserve(numThreads);
+    for (int i = 0; i < numThreads; ++i) {
+        char id[32];
+        snprintf(id, sizeof(id), "%d", i + 1);
+        ThreadOptions options;
+        if (affinity_) options.cpus.push_back(i % numCpus);
+        threads_.emplace_back(new Thread(
+            std::bind(&EventLoopThreadPool::threadFunc, this, i, cb, &latch),
+            name_ + id, options));
+        threads_.back()->start(false);
+    }
+    latch.wait();
+}
+
+void EventLoopThreadPool::stop() {
+    if (!started_) return;
+    for (EventLoop* loop : loops_) loop->quit();
+    for (auto& thr : threads_) thr->join();
+    threads_.clear();
+    loops_.clear();
+    started_ = false;
+}
+
+EventLoop* EventLoopThreadPool::getNextLoop() {
+    assert(!loops_.empty());
+    return loops_[next_.fetch_add(1, std::memory_order_relaxed) %
+                  loops_.size()];
+}
+
+EventLoop* EventLoopThreadPool::getLoopForHash(size_t hashCode) {
+    assert(!loops_.empty());
+    return loops_[hashCode % loops_.size()];
+}
+
+void EventLoopThreadPool::threadFunc(size_t index, const ThreadInitCallback& cb,
+                                     CountDownLatch* latch) {
+    EventLoop loop;
+    if (cb) cb(&loop);
+    loops_[index] = &loop;
+    latch->countDown();
+    loop.loop();
+}
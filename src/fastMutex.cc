@@ -0,0 +1,48 @@
+#include <Base/fastMutex.h>
+#include <sched.h>  // sched_yield
+
+namespace {
+/// FastMutex 休眠之前的自旋次数
+const int kMutexSpinCount = 100;
+
+/// SpinLock 单次退避的 pause 次数上限，超过后让出 CPU
+const int kMaxBackoff = 1024;
+}  // namespace
+
+void Lute::FastMutex::lockSlow() {
+    // 持有者通常很快释放: 先只读自旋，避免反复写缓存行
+    for (int i = 0; i < kMutexSpinCount; ++i) {
+        uint32_t state = state_.load(std::memory_order_relaxed);
+        if (state == kUnlocked &&
+            state_.compare_exchange_weak(state, kLocked,
+                                         std::memory_order_acquire,
+                                         std::memory_order_relaxed)) {
+            return;
+        }
+        if (state == kContended) break;  // 已有线程在休眠，不再自旋
+        cpuRelax();
+    }
+
+    // 置为 2 表示有等待者，解锁方须唤醒；交换得到 0 说明已拿到锁
+    while (state_.exchange(kContended, std::memory_order_acquire) !=
+           kUnlocked) {
+        Futex::wait(&state_, kContended);
+    }
+}
+
+void Lute::SpinLock::lockSlow() {
+    int backoff = 1;
+    for (;;) {
+        // test-and-test-and-set: 锁被持有时只读，不争抢缓存行
+        while (locked_.load(std::memory_order_relaxed)) {
+            if (backoff < kMaxBackoff) {
+                for (int i = 0; i < backoff; ++i) cpuRelax();
+                backoff <<= 1;
+            } else {
+                // 持有者可能已被抢占
+                ::sched_yield();
+            }
+        }
+        if (!locked_.exchange(true, std::memory_order_acquire)) return;
+    }
+}
@@ -1,11 +1,14 @@
 #include <Base/fsUtils.h>
+#include <Base/ioUring.h>
 #include <dirent.h>  // opendir
 #include <fcntl.h>   // open
+#include <limits.h>  // IOV_MAX
 #include <unistd.h>  // access
 
-#include <cassert>  // assert
-#include <csignal>  // kill
-#include <cstring>  // strcmp
+#include <algorithm>  // min
+#include <cassert>    // assert
+#include <csignal>    // kill
+#include <cstring>    // strcmp
 #include <memory>
 #include <string>  // string
 
@@ -338,7 +341,191 @@ void AppendFile::append(const char* logline, const size_t len) {
     writtenBytes_ += written;
 }
 
+void AppendFile::appendv(const struct iovec* iov, int count, IoUring* ring) {
+    // stdio 缓冲中尚未写出的数据在前
+    ::fflush(fp_);
+    const int fd = ::fileno(fp_);
+    int i = 0;
+
+    if (ring && ring->valid()) {
+        const int kMaxBatch = 64;
+        int32_t results[kMaxBatch];
+        while (i < count) {
+            int batch = std::min({count - i, kMaxBatch,
+                                  static_cast<int>(ring->entries())});
+            // 链接保证各段按顺序追加
+            for (int j = 0; j < batch; ++j) {
+                bool ok = ring->prepareWrite(
+                    fd, iov[i + j].iov_base,
+                    static_cast<unsigned>(iov[i + j].iov_len), -1,
+                    static_cast<uint64_t>(j), j + 1 < batch);
+                assert(ok);
+                (void)ok;
+            }
+            // 未能提交的请求已被丢弃，与写入不完整的段一起同步补写
+            int submitted =
+                std::max(ring->submit(static_cast<unsigned>(batch)), 0);
+            for (int j = 0; j < batch; ++j) results[j] = -ECANCELED;
+            for (int j = 0; j < submitted; ++j) {
+                uint64_t userData = 0;
+                int32_t res = 0;
+                if (!ring->waitCompletion(&userData, &res)) break;
+                if (userData < static_cast<uint64_t>(batch)) {
+                    results[userData] = res;
+                }
+            }
+            // 写入不完整时链被打断，之后的请求以 -ECANCELED 完成，按序补写
+            for (int j = 0; j < batch; ++j) {
+                const struct iovec& v = iov[i + j];
+                size_t done = results[j] > 0 ? static_cast<size_t>(results[j])
+                                             : 0;
+                if (done < v.iov_len) {
+                    done += writeFully(static_cast<const char*>(v.iov_base) +
+                                           done,
+                                       v.iov_len - done);
+                }
+                writtenBytes_ += static_cast<off_t>(done);
+            }
+            i += batch;
+        }
+    }
+
+    while (i < count) {
+        int n = std::min(count - i, IOV_MAX);
+        ssize_t written = ::writev(fd, iov + i, n);
+        if (written < 0) {
+            if (errno == EINTR) continue;
+            char buf[512];
+            ::fprintf(stderr, "AppendFile::appendv() failed %s\n",
+                      ::strerror_r(errno, buf, sizeof(buf)));
+            return;
+        }
+        writtenBytes_ += written;
+        // 跳过已完整写入的段，不完整的段补写剩余部分
+        auto left = static_cast<size_t>(written);
+        while (i < count && left >= iov[i].iov_len) left -= iov[i++].iov_len;
+        if (left > 0) {
+            writtenBytes_ += writeFully(
+                static_cast<const char*>(iov[i].iov_base) + left,
+                iov[i].iov_len - left);
+            ++i;
+        }
+    }
+}
+
+size_t AppendFile::writeFully(const char* data, size_t len) {
+    const int fd = ::fileno(fp_);
+    size_t written = 0;
+    while (written < len) {
+        ssize_t n = ::write(fd, data + written, len - written);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            char buf[512];
+            ::fprintf(stderr, "AppendFile::writeFully() failed %s\n",
+                      ::strerror_r(errno, buf, sizeof(buf)));
+            break;
+        }
+        written += static_cast<size_t>(n);
+    }
+    return written;
+}
+
 void AppendFile::flush() { ::fflush(fp_); }
 
+std::vector<int> Lute::readFiles(const std::vector<std::string>& filenames,
+                                 int maxSize,
+                                 std::vector<std::string>* contents,
+                                 IoUring* ring) {
+    assert(contents != nullptr);
+    const size_t count = filenames.size();
+    std::vector<int> errors(count, 0);
+    contents->assign(count, std::string());
+
+    std::unique_ptr<IoUring> localRing;
+    if (ring == nullptr && count > 1 && IoUring::supported()) {
+        localRing.reset(new IoUring(static_cast<unsigned>(
+            std::min<size_t>(count, 64))));
+        ring = localRing.get();
+    }
+
+    // 大小已知的普通文件走 io_uring，其余的逐个同步读取
+    std::vector<int> fds(count, -1);
+    std::vector<size_t> batch;
+    for (size_t i = 0; i < count; ++i) {
+        if (ring && ring->valid()) {
+            int fd = ::open(filenames[i].c_str(), O_RDONLY | O_CLOEXEC);
+            struct stat st {};
+            if (fd >= 0 && ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+                st.st_size > 0) {
+                fds[i] = fd;
+                (*contents)[i].resize(static_cast<size_t>(
+                    std::min<int64_t>(st.st_size, maxSize)));
+                batch.push_back(i);
+                continue;
+            }
+            if (fd >= 0) ::close(fd);
+        }
+        errors[i] = readFile(filenames[i], maxSize, &(*contents)[i]);
+    }
+
+    std::vector<bool> reaped(count, false);
+    size_t next = 0;
+    while (next < batch.size()) {
+        size_t n = std::min<size_t>(batch.size() - next, ring->entries());
+        for (size_t j = 0; j < n; ++j) {
+            size_t i = batch[next + j];
+            std::string& content = (*contents)[i];
+            ring->prepareRead(fds[i], &content[0],
+                              static_cast<unsigned>(content.size()), 0, i);
+        }
+        int submitted = ring->submit(static_cast<unsigned>(n));
+        for (int j = 0; j < submitted; ++j) {
+            uint64_t i = 0;
+            int32_t res = 0;
+            if (!ring->waitCompletion(&i, &res)) break;
+            reaped[i] = true;
+            std::string& content = (*contents)[i];
+            if (res == -EINVAL || res == -EOPNOTSUPP) {
+                // 内核不支持该操作码 (调用方提供的 ring 未经 supported())
+                errors[i] = readFile(filenames[i], maxSize, &content);
+                continue;
+            }
+            if (res < 0) {
+                errors[i] = -res;
+                content.clear();
+                continue;
+            }
+            // 读取不完整 (文件在读取期间被截断或是短读) 时同步读完
+            auto done = static_cast<size_t>(res);
+            while (done < content.size()) {
+                ssize_t m = ::pread(fds[i], &content[done],
+                                    content.size() - done,
+                                    static_cast<off_t>(done));
+                if (m <= 0) {
+                    if (m < 0) errors[i] = errno;
+                    break;
+                }
+                done += static_cast<size_t>(m);
+            }
+            content.resize(done);
+        }
+        // 未能提交的请求已被丢弃，waitCompletion 失败时剩余的完成事件也
+        // 无从取得，均退回同步读取。仍在进行的请求写入的是同一缓冲区的
+        // 同一位置 (readFile 先 clear，不释放容量)，内容相同
+        for (size_t j = 0; j < n; ++j) {
+            size_t i = batch[next + j];
+            if (!reaped[i]) {
+                errors[i] = readFile(filenames[i], maxSize, &(*contents)[i]);
+            }
+        }
+        next += n;
+    }
+
+    for (int fd : fds) {
+        if (fd >= 0) ::close(fd);
+    }
+    return errors;
+}
+
 template int Lute::readFile(const std::string& filename, int maxSize,
                             std::string* content, int64_t*, int64_t*, int64_t*);
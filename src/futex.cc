@@ -0,0 +1,97 @@
+#include <Base/futex.h>
+#include <linux/futex.h>  // FUTEX_WAIT_PRIVATE, FUTEX_WAKE_PRIVATE
+#include <sys/syscall.h>  // SYS_futex
+#include <time.h>         // timespec, clock_gettime
+#include <unistd.h>       // syscall
+
+#include <cerrno>  // errno
+
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t),
+              "futex word must be a plain 32-bit integer");
+
+namespace {
+inline uint32_t* futexWord(const std::atomic<uint32_t>* addr) {
+    return const_cast<uint32_t*>(reinterpret_cast<const uint32_t*>(addr));
+}
+}  // namespace
+
+int64_t Lute::monotonicNs() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+int Lute::Futex::wait(const std::atomic<uint32_t>* addr, uint32_t expected,
+                      int64_t timeoutNs) {
+    struct timespec ts;
+    struct timespec* timeout = nullptr;
+    if (timeoutNs >= 0) {
+        ts.tv_sec = timeoutNs / 1000000000;
+        ts.tv_nsec = timeoutNs % 1000000000;
+        timeout = &ts;
+    }
+    long ret = ::syscall(SYS_futex, futexWord(addr), FUTEX_WAIT_PRIVATE,
+                         expected, timeout, nullptr, 0);
+    return ret == 0 ? 0 : -1;
+}
+
+int Lute::Futex::wake(const std::atomic<uint32_t>* addr, int count) {
+    long ret = ::syscall(SYS_futex, futexWord(addr), FUTEX_WAKE_PRIVATE, count,
+                         nullptr, nullptr, 0);
+    return ret < 0 ? 0 : static_cast<int>(ret);
+}
+
+void Lute::EventCount::wait(uint32_t key) {
+    while (epoch_.load(std::memory_order_acquire) == key) {
+        Futex::wait(&epoch_, key);
+    }
+    leave();
+}
+
+bool Lute::EventCount::waitFor(uint32_t key, int64_t timeoutNs) {
+    const int64_t deadline = monotonicNs() + timeoutNs;
+    bool notified = true;
+    while (epoch_.load(std::memory_order_acquire) == key) {
+        int64_t remain = deadline - monotonicNs();
+        if (remain <= 0) {
+            notified = false;
+            break;
+        }
+        Futex::wait(&epoch_, key, remain);
+    }
+    leave();
+    return notified;
+}
+
+void Lute::EventCount::leave() {
+    uint64_t state = state_.load(std::memory_order_relaxed);
+    for (;;) {
+        uint64_t next = state - kWaiter;
+        // 信号数不能超过剩余的等待者数，否则之后登记的等待者会被误认为
+        // 已经通知过而永远得不到唤醒
+        if (signals(state) > 0) next -= kSignal;
+        if (signals(next) > waiters(next)) {
+            next = (next & 0xFFFFFFFFu) | (uint64_t(waiters(next)) << 32);
+        }
+        if (state_.compare_exchange_weak(state, next,
+                                         std::memory_order_seq_cst)) {
+            return;
+        }
+    }
+}
+
+void Lute::EventCount::notifySlow(bool all) {
+    uint64_t state = state_.load(std::memory_order_relaxed);
+    for (;;) {
+        uint32_t w = waiters(state);
+        uint32_t s = signals(state);
+        if (s >= w) return;
+        uint64_t next = all ? (uint64_t(w) << 32) | w : state + kSignal;
+        if (state_.compare_exchange_weak(state, next,
+                                         std::memory_order_seq_cst)) {
+            break;
+        }
+    }
+    epoch_.fetch_add(1, std::memory_order_release);
+    Futex::wake(&epoch_, all ? INT_MAX : 1);
+}
@@ -0,0 +1,126 @@
+#include <Base/hex.h>
+
+#include <cstdint>  // uint8_t
+
+#ifdef __SSE2__
+#include <emmintrin.h>  // SSE2
+#endif
+
+namespace {
+const char kHexDigits[] = "0123456789abcdef";
+
+/// @brief 字符 -> 半字节的查找表，非法字符为 0xFF
+struct HexTable {
+    uint8_t value[256];
+
+    HexTable() {
+        for (int i = 0; i < 256; ++i) value[i] = 0xFF;
+        for (int i = 0; i < 10; ++i) value['0' + i] = static_cast<uint8_t>(i);
+        for (int i = 0; i < 6; ++i) {
+            value['a' + i] = static_cast<uint8_t>(10 + i);
+            value['A' + i] = static_cast<uint8_t>(10 + i);
+        }
+    }
+};
+const HexTable kHexTable;
+
+#ifdef __SSE2__
+/// @brief 16 个半字节 (0 ~ 15) 转换为 ASCII: x + '0' + (x > 9 ? 39 : 0)
+inline __m128i nibbleToAscii(__m128i x) {
+    __m128i gt9 = _mm_cmpgt_epi8(x, _mm_set1_epi8(9));
+    x = _mm_add_epi8(x, _mm_set1_epi8('0'));
+    return _mm_add_epi8(x, _mm_and_si128(gt9, _mm_set1_epi8('a' - '0' - 10)));
+}
+
+/// @brief 16 个 ASCII 字符转换为半字节，非法字符将清除 ok 中对应的位
+inline __m128i asciiToNibble(__m128i c, int* ok) {
+    const __m128i zero = _mm_setzero_si128();
+    // c - '0' 按无符号 <= 9 即为数字，小于 '0' 的字符回绕为大数
+    __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    __m128i isDigit =
+        _mm_cmpeq_epi8(_mm_subs_epu8(digit, _mm_set1_epi8(9)), zero);
+    // (c | 0x20) - 'a' 按无符号 <= 5 即为 a ~ f / A ~ F
+    __m128i alpha = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)),
+                                 _mm_set1_epi8('a'));
+    __m128i isAlpha =
+        _mm_cmpeq_epi8(_mm_subs_epu8(alpha, _mm_set1_epi8(5)), zero);
+    alpha = _mm_add_epi8(alpha, _mm_set1_epi8(10));
+
+    *ok &= _mm_movemask_epi8(_mm_or_si128(isDigit, isAlpha));
+    return _mm_or_si128(_mm_and_si128(isDigit, digit),
+                        _mm_and_si128(isAlpha, alpha));
+}
+
+/// @brief 16 个半字节两两合并为 8 个字节 (每个 16 位 lane 的低 8 位)
+inline __m128i combineNibbles(__m128i v) {
+    // 16 位 lane = hi | lo << 8  ->  hi << 4 | lo
+    __m128i hi = _mm_and_si128(v, _mm_set1_epi16(0x00FF));
+    __m128i lo = _mm_srli_epi16(v, 8);
+    return _mm_or_si128(_mm_slli_epi16(hi, 4), lo);
+}
+#endif
+}  // namespace
+
+void Lute::hexEncode(const void* src, size_t len, char* dst) {
+    const auto* in = static_cast<const uint8_t*>(src);
+    size_t i = 0;
+#ifdef __SSE2__
+    const __m128i mask = _mm_set1_epi8(0x0F);
+    for (; i + 16 <= len; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        __m128i hi = _mm_and_si128(_mm_srli_epi16(v, 4), mask);
+        __m128i lo = _mm_and_si128(v, mask);
+        // 高半字节在前
+        __m128i first = nibbleToAscii(_mm_unpacklo_epi8(hi, lo));
+        __m128i second = nibbleToAscii(_mm_unpackhi_epi8(hi, lo));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i), first);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 2 * i + 16), second);
+    }
+#endif
+    for (; i < len; ++i) {
+        dst[2 * i] = kHexDigits[in[i] >> 4];
+        dst[2 * i + 1] = kHexDigits[in[i] & 0x0F];
+    }
+}
+
+std::string Lute::hexEncode(const void* src, size_t len) {
+    std::string hex;
+    hex.resize(len * 2);
+    if (len > 0) hexEncode(src, len, &hex[0]);
+    return hex;
+}
+
+bool Lute::hexDecode(const char* src, size_t len, void* dst) {
+    if (len % 2 != 0) return false;
+
+    auto* out = static_cast<uint8_t*>(dst);
+    size_t i = 0;
+#ifdef __SSE2__
+    for (; i + 32 <= len; i += 32) {
+        int ok = 0xFFFF;
+        __m128i first = asciiToNibble(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)), &ok);
+        __m128i second = asciiToNibble(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 16)),
+            &ok);
+        if (ok != 0xFFFF) return false;
+        __m128i bytes =
+            _mm_packus_epi16(combineNibbles(first), combineNibbles(second));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i / 2), bytes);
+    }
+#endif
+    for (; i < len; i += 2) {
+        uint8_t hi = kHexTable.value[static_cast<uint8_t>(src[i])];
+        uint8_t lo = kHexTable.value[static_cast<uint8_t>(src[i + 1])];
+        if ((hi | lo) == 0xFF) return false;
+        out[i / 2] = static_cast<uint8_t>(hi << 4 | lo);
+    }
+    return true;
+}
+
+bool Lute::hexDecode(const string_view& src, std::string* out) {
+    if (src.size() % 2 != 0) return false;
+    out->resize(src.size() / 2);
+    if (src.empty()) return true;
+    return hexDecode(src.data(), src.size(), &(*out)[0]);
+}
@@ -0,0 +1,279 @@
+#include <Base/ioUring.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>     // mmap, munmap
+#include <sys/syscall.h>  // SYS_io_uring_setup
+#include <unistd.h>       // syscall, close
+
+#include <algorithm>  // max
+#include <cerrno>     // errno
+#include <cstdint>    // uint64_t
+#include <cstring>    // memset
+#include <vector>     // vector
+
+namespace {
+inline unsigned loadAcquire(const unsigned* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+inline void storeRelease(unsigned* p, unsigned v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+template <typename T>
+inline T* ringPtr(void* base, unsigned offset) {
+    return reinterpret_cast<T*>(static_cast<char*>(base) + offset);
+}
+}  // namespace
+
+using namespace Lute;
+
+bool IoUring::supported() {
+    static const bool kSupported = []() {
+        struct io_uring_params params;
+        memset(&params, 0, sizeof(params));
+        int fd = static_cast<int>(::syscall(SYS_io_uring_setup, 1, &params));
+        if (fd < 0) return false;
+        // io_uring_setup 在 5.1 即可用，而 IORING_OP_READ / WRITE 到 5.6 才
+        // 加入，需逐个探测 (不支持 IORING_REGISTER_PROBE 的内核同样过旧)
+        const unsigned kOps = 256;
+        std::vector<uint64_t> storage(
+            (sizeof(struct io_uring_probe) +
+             kOps * sizeof(struct io_uring_probe_op)) / sizeof(uint64_t) + 1);
+        auto* probe = reinterpret_cast<struct io_uring_probe*>(storage.data());
+        bool ok = ::syscall(SYS_io_uring_register, fd, IORING_REGISTER_PROBE,
+                            probe, kOps) == 0;
+        for (unsigned op : {IORING_OP_READ, IORING_OP_WRITE, IORING_OP_FSYNC}) {
+            ok = ok && op < probe->ops_len &&
+                 (probe->ops[op].flags & IO_URING_OP_SUPPORTED);
+        }
+        ::close(fd);
+        return ok;
+    }();
+    return kSupported;
+}
+
+IoUring::IoUring(unsigned entries)
+    : ringFd_(-1),
+      error_(0),
+      sqRing_(MAP_FAILED),
+      sqRingSize_(0),
+      sqHead_(nullptr),
+      sqTail_(nullptr),
+      sqMask_(0),
+      sqEntries_(0),
+      sqArray_(nullptr),
+      sqes_(nullptr),
+      sqesSize_(0),
+      sqeHead_(0),
+      sqeTail_(0),
+      cqRing_(MAP_FAILED),
+      cqRingSize_(0),
+      cqHead_(nullptr),
+      cqTail_(nullptr),
+      cqMask_(0),
+      cqes_(nullptr) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    ringFd_ = static_cast<int>(
+        ::syscall(SYS_io_uring_setup, std::max(entries, 1u), &params));
+    if (ringFd_ < 0) {
+        error_ = errno;
+        return;
+    }
+
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    cqRingSize_ =
+        params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap) {
+        sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+    }
+
+    sqRing_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQ_RING);
+    if (sqRing_ != MAP_FAILED) {
+        cqRing_ = singleMmap ? sqRing_
+                             : ::mmap(nullptr, cqRingSize_,
+                                      PROT_READ | PROT_WRITE,
+                                      MAP_SHARED | MAP_POPULATE, ringFd_,
+                                      IORING_OFF_CQ_RING);
+    }
+    sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = MAP_FAILED;
+    if (cqRing_ != MAP_FAILED) {
+        sqes = ::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ringFd_, IORING_OFF_SQES);
+    }
+    if (sqes == MAP_FAILED) {
+        error_ = errno;
+        unmapRings();
+        ::close(ringFd_);
+        ringFd_ = -1;
+        return;
+    }
+    sqes_ = static_cast<struct io_uring_sqe*>(sqes);
+
+    sqHead_ = ringPtr<unsigned>(sqRing_, params.sq_off.head);
+    sqTail_ = ringPtr<unsigned>(sqRing_, params.sq_off.tail);
+    sqMask_ = *ringPtr<unsigned>(sqRing_, params.sq_off.ring_mask);
+    sqEntries_ = *ringPtr<unsigned>(sqRing_, params.sq_off.ring_entries);
+    sqArray_ = ringPtr<unsigned>(sqRing_, params.sq_off.array);
+    sqeHead_ = sqeTail_ = *sqTail_;
+
+    cqHead_ = ringPtr<unsigned>(cqRing_, params.cq_off.head);
+    cqTail_ = ringPtr<unsigned>(cqRing_, params.cq_off.tail);
+    cqMask_ = *ringPtr<unsigned>(cqRing_, params.cq_off.ring_mask);
+    cqes_ = ringPtr<struct io_uring_cqe>(cqRing_, params.cq_off.cqes);
+}
+
+IoUring::~IoUring() {
+    if (ringFd_ < 0) return;
+    ::munmap(sqes_, sqesSize_);
+    unmapRings();
+    // 关闭 ring 时内核一并注销固定缓冲区
+    ::close(ringFd_);
+}
+
+void IoUring::unmapRings() {
+    if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_) {
+        ::munmap(cqRing_, cqRingSize_);
+    }
+    if (sqRing_ != MAP_FAILED) ::munmap(sqRing_, sqRingSize_);
+    sqRing_ = cqRing_ = MAP_FAILED;
+}
+
+int IoUring::registerBuffers(const struct iovec* iovecs, unsigned count) {
+    if (!valid()) return ENOSYS;
+    if (!buffers_.empty()) unregisterBuffers();
+    if (::syscall(SYS_io_uring_register, ringFd_, IORING_REGISTER_BUFFERS,
+                  iovecs, count) < 0) {
+        return errno;
+    }
+    buffers_.assign(iovecs, iovecs + count);
+    return 0;
+}
+
+int IoUring::unregisterBuffers() {
+    if (!valid() || buffers_.empty()) return 0;
+    buffers_.clear();
+    if (::syscall(SYS_io_uring_register, ringFd_, IORING_UNREGISTER_BUFFERS,
+                  nullptr, 0) < 0) {
+        return errno;
+    }
+    return 0;
+}
+
+int IoUring::findBuffer(const void* addr, size_t len) const {
+    auto begin = reinterpret_cast<uintptr_t>(addr);
+    for (size_t i = 0; i < buffers_.size(); ++i) {
+        auto base = reinterpret_cast<uintptr_t>(buffers_[i].iov_base);
+        if (begin >= base && begin + len <= base + buffers_[i].iov_len) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+struct io_uring_sqe* IoUring::getSqe() {
+    if (!valid()) return nullptr;
+    if (sqeTail_ - loadAcquire(sqHead_) >= sqEntries_) return nullptr;
+    struct io_uring_sqe* sqe = &sqes_[sqeTail_ & sqMask_];
+    ++sqeTail_;
+    memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+}
+
+bool IoUring::prepareRw(int op, int fd, const void* buf, unsigned len,
+                        int64_t offset, uint64_t userData, bool link) {
+    struct io_uring_sqe* sqe = getSqe();
+    if (sqe == nullptr) return false;
+
+    int index = findBuffer(buf, len);
+    if (index >= 0) {
+        op = op == IORING_OP_READ ? IORING_OP_READ_FIXED
+                                  : IORING_OP_WRITE_FIXED;
+        sqe->buf_index = static_cast<uint16_t>(index);
+    }
+    sqe->opcode = static_cast<uint8_t>(op);
+    sqe->fd = fd;
+    sqe->off = static_cast<uint64_t>(offset);
+    sqe->addr = reinterpret_cast<uintptr_t>(buf);
+    sqe->len = len;
+    sqe->user_data = userData;
+    if (link) sqe->flags |= IOSQE_IO_LINK;
+    return true;
+}
+
+bool IoUring::prepareRead(int fd, void* buf, unsigned len, int64_t offset,
+                          uint64_t userData, bool link) {
+    return prepareRw(IORING_OP_READ, fd, buf, len, offset, userData, link);
+}
+
+bool IoUring::prepareWrite(int fd, const void* buf, unsigned len,
+                           int64_t offset, uint64_t userData, bool link) {
+    return prepareRw(IORING_OP_WRITE, fd, buf, len, offset, userData, link);
+}
+
+bool IoUring::prepareFsync(int fd, uint64_t userData, bool dataSync) {
+    struct io_uring_sqe* sqe = getSqe();
+    if (sqe == nullptr) return false;
+    sqe->opcode = IORING_OP_FSYNC;
+    sqe->fd = fd;
+    sqe->fsync_flags = dataSync ? IORING_FSYNC_DATASYNC : 0;
+    sqe->user_data = userData;
+    return true;
+}
+
+int IoUring::enter(unsigned toSubmit, unsigned waitNr, unsigned flags) {
+    for (;;) {
+        long ret = ::syscall(SYS_io_uring_enter, ringFd_, toSubmit, waitNr,
+                             flags, nullptr, 0);
+        if (ret >= 0) return static_cast<int>(ret);
+        if (errno != EINTR) return -errno;
+    }
+}
+
+int IoUring::submit(unsigned waitNr) {
+    if (!valid()) return -ENOSYS;
+    // 把本地准备好的 SQE 发布给内核
+    for (unsigned i = sqeHead_; i != sqeTail_; ++i) {
+        sqArray_[i & sqMask_] = i & sqMask_;
+    }
+    storeRelease(sqTail_, sqeTail_);
+
+    const unsigned toSubmit = sqeTail_ - sqeHead_;
+    unsigned submitted = 0;
+    int ret = 0;
+    while (submitted < toSubmit || (toSubmit == 0 && waitNr > 0)) {
+        ret = enter(toSubmit - submitted, waitNr,
+                    waitNr > 0 ? IORING_ENTER_GETEVENTS : 0);
+        if (ret <= 0) break;
+        submitted += static_cast<unsigned>(ret);
+        sqeHead_ += static_cast<unsigned>(ret);
+    }
+    if (sqeHead_ != sqeTail_) {
+        // 内核没有取走的请求收回，以免在下次提交时被执行
+        sqeTail_ = sqeHead_;
+        storeRelease(sqTail_, sqeTail_);
+    }
+    if (submitted == 0 && ret < 0) return ret;
+    return static_cast<int>(submitted);
+}
+
+bool IoUring::peekCompletion(uint64_t* userData, int32_t* res) {
+    if (!valid()) return false;
+    unsigned head = *cqHead_;
+    if (head == loadAcquire(cqTail_)) return false;
+    const struct io_uring_cqe& cqe = cqes_[head & cqMask_];
+    if (userData) *userData = cqe.user_data;
+    if (res) *res = cqe.res;
+    storeRelease(cqHead_, head + 1);
+    return true;
+}
+
+bool IoUring::waitCompletion(uint64_t* userData, int32_t* res) {
+    while (!peekCompletion(userData, res)) {
+        if (!valid() || enter(0, 1, IORING_ENTER_GETEVENTS) < 0) return false;
+    }
+    return true;
+}
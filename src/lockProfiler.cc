@@ -0,0 +1,166 @@
+#include <Base/fastMutex.h>  // SpinLock
+#include <Base/futex.h>      // monotonicNs
+#include <Base/lockProfiler.h>
+#include <Base/logger.h>
+#include <time.h>  // nanosleep
+
+#include <algorithm>  // sort
+#include <cinttypes>  // PRIu64
+#include <cstdio>     // snprintf
+#include <vector>     // vector
+
+namespace {
+/// 标定 cyclesPerNs 的最短时间窗口
+const int64_t kCalibrateNs = 10 * 1000 * 1000;
+
+///
+/// 全局列表，有意泄漏: 静态对象中的互斥量可能在它之后析构
+///
+struct Registry {
+    Lute::SpinLock lock;
+    Lute::LockProfile* head = nullptr;
+    /// 标定的起点
+    const uint64_t startCycles = Lute::readCycles();
+    const int64_t startNs = Lute::monotonicNs();
+};
+
+Registry& registry() {
+    static Registry* instance = new Registry;
+    return *instance;
+}
+
+struct Entry {
+    const char* name;
+    uint64_t acquisitions;
+    uint64_t contended;
+    uint64_t waitCycles;
+    uint64_t maxHoldCycles;
+};
+}  // namespace
+
+using namespace Lute;
+
+/// NOTE ----------- LockProfile -----------
+LockProfile::LockProfile(const char* name)
+    : name_(name),
+      acquisitions_(0),
+      contended_(0),
+      waitCycles_(0),
+      maxHoldCycles_(0),
+      holdStart_(0),
+      prev_(nullptr),
+      next_(nullptr) {
+    LockProfiler::add(this);
+}
+
+LockProfile::~LockProfile() { LockProfiler::remove(this); }
+
+/// NOTE ----------- LockProfiler -----------
+bool LockProfiler::enabled() {
+#ifdef LUTE_MUTEX_PROFILING
+    return true;
+#else
+    return false;
+#endif
+}
+
+void LockProfiler::add(LockProfile* profile) {
+    Registry& r = registry();
+    SpinLockGuard guard(r.lock);
+    profile->next_ = r.head;
+    if (r.head) r.head->prev_ = profile;
+    r.head = profile;
+}
+
+void LockProfiler::remove(LockProfile* profile) {
+    Registry& r = registry();
+    SpinLockGuard guard(r.lock);
+    if (profile->prev_) {
+        profile->prev_->next_ = profile->next_;
+    } else {
+        r.head = profile->next_;
+    }
+    if (profile->next_) profile->next_->prev_ = profile->prev_;
+}
+
+double LockProfiler::cyclesPerNs() {
+    static const double ratio = []() {
+        Registry& r = registry();
+        int64_t elapsed = monotonicNs() - r.startNs;
+        if (elapsed < kCalibrateNs) {
+            struct timespec ts = {0, static_cast<long>(kCalibrateNs - elapsed)};
+            ::nanosleep(&ts, nullptr);
+        }
+        uint64_t cycles = readCycles() - r.startCycles;
+        elapsed = monotonicNs() - r.startNs;
+        return static_cast<double>(cycles) / static_cast<double>(elapsed);
+    }();
+    return ratio;
+}
+
+std::string LockProfiler::report(size_t maxEntries) {
+    if (!enabled()) {
+        return "lock profiling disabled, rebuild with LUTE_MUTEX_PROFILING\n";
+    }
+
+    std::vector<Entry> entries;
+    {
+        Registry& r = registry();
+        SpinLockGuard guard(r.lock);
+        for (LockProfile* p = r.head; p != nullptr; p = p->next_) {
+            Entry e;
+            e.name = p->name_ ? p->name_ : "<unnamed>";
+            e.acquisitions = p->acquisitions_.load(std::memory_order_relaxed);
+            e.contended = p->contended_.load(std::memory_order_relaxed);
+            e.waitCycles = p->waitCycles_.load(std::memory_order_relaxed);
+            e.maxHoldCycles = p->maxHoldCycles_.load(std::memory_order_relaxed);
+            if (e.acquisitions > 0) entries.push_back(e);
+        }
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) {
+                  return a.waitCycles > b.waitCycles;
+              });
+    if (entries.size() > maxEntries) entries.resize(maxEntries);
+
+    const double perNs = cyclesPerNs();
+    char buf[256];
+    snprintf(buf, sizeof(buf), "%-24s %14s %12s %12s %12s %12s\n", "name",
+             "acquisitions", "contended", "wait(ms)", "avgWait(ns)",
+             "maxHold(ns)");
+    std::string result(buf);
+    for (const Entry& e : entries) {
+        double waitNs = static_cast<double>(e.waitCycles) / perNs;
+        double avgWaitNs =
+            e.contended > 0 ? waitNs / static_cast<double>(e.contended) : 0;
+        snprintf(buf, sizeof(buf),
+                 "%-24s %14" PRIu64 " %12" PRIu64 " %12.3f %12.0f %12.0f\n",
+                 e.name, e.acquisitions, e.contended, waitNs / 1e6, avgWaitNs,
+                 static_cast<double>(e.maxHoldCycles) / perNs);
+        result += buf;
+    }
+    return result;
+}
+
+void LockProfiler::dump(size_t maxEntries) {
+    std::string text = report(maxEntries);
+    // 逐行输出，避免超出单条日志的缓冲
+    size_t begin = 0;
+    while (begin < text.size()) {
+        size_t end = text.find('\n', begin);
+        if (end == std::string::npos) end = text.size();
+        LOG_INFO << text.substr(begin, end - begin);
+        begin = end + 1;
+    }
+}
+
+void LockProfiler::reset() {
+    Registry& r = registry();
+    SpinLockGuard guard(r.lock);
+    for (LockProfile* p = r.head; p != nullptr; p = p->next_) {
+        p->acquisitions_.store(0, std::memory_order_relaxed);
+        p->contended_.store(0, std::memory_order_relaxed);
+        p->waitCycles_.store(0, std::memory_order_relaxed);
+        p->maxHoldCycles_.store(0, std::memory_order_relaxed);
+    }
+}
@@ -1,8 +1,11 @@
 #include <Base/ini_config.h>
+#include <Base/ioUring.h>
 #include <Base/logger.h>
 #include <Base/singleton.h>
 #include <Base/utils.h>
 
+#include <algorithm>  // find_if
+
 /// *********************************************************
 /// FIXME Must correspond one-to-one with .ini file
 #define INI_FILE "conf/LuteLogger.ini"
@@ -15,6 +18,12 @@
 /// Uint: seconds
 #define LUTE_LOGGER_INI_LOG_FLUSH_INTERVAL_KEY "LOG_FLUSH_INTERVAL"
 #define LUTE_LOGGER_INI_LOG_FLUSH_INTERVAL_VALUE_DEFAULT "30"
+/// 后端线程允许运行的 CPU，如 "0-1,4"，为空时不限制
+#define LUTE_LOGGER_INI_LOG_THREAD_CPUS_KEY "LOG_THREAD_CPUS"
+#define LUTE_LOGGER_INI_LOG_THREAD_CPUS_VALUE_DEFAULT ""
+/// 后端线程是否通过 io_uring 写文件，不支持时回退到 writev
+#define LUTE_LOGGER_INI_LOG_IO_URING_KEY "LOG_IO_URING"
+#define LUTE_LOGGER_INI_LOG_IO_URING_VALUE_DEFAULT "false"
 /// *********************************************************
 
 // forward declaration
@@ -108,6 +117,12 @@ namespace ini {
             LUTE_INI_WRITE(LUTE_LOGGER_INI_SECTION,
                            LUTE_LOGGER_INI_LOG_FLUSH_INTERVAL_KEY,
                            LUTE_LOGGER_INI_LOG_FLUSH_INTERVAL_VALUE_DEFAULT);
+            LUTE_INI_WRITE(LUTE_LOGGER_INI_SECTION,
+                           LUTE_LOGGER_INI_LOG_THREAD_CPUS_KEY,
+                           LUTE_LOGGER_INI_LOG_THREAD_CPUS_VALUE_DEFAULT);
+            LUTE_INI_WRITE(LUTE_LOGGER_INI_SECTION,
+                           LUTE_LOGGER_INI_LOG_IO_URING_KEY,
+                           LUTE_LOGGER_INI_LOG_IO_URING_VALUE_DEFAULT);
         }
     }
 
@@ -143,11 +158,19 @@ void initLogger(Lute::Logger::LogLevel logLevel) {
         LUTE_LOGGER_INI_SECTION, LUTE_LOGGER_INI_LOG_FILE_ROLLSIZE_KEY);
     static Lute::string_view logFlushInterval = LUTE_INI_READ(
         LUTE_LOGGER_INI_SECTION, LUTE_LOGGER_INI_LOG_FLUSH_INTERVAL_KEY);
+    static Lute::string_view logThreadCpus = LUTE_INI_READ(
+        LUTE_LOGGER_INI_SECTION, LUTE_LOGGER_INI_LOG_THREAD_CPUS_KEY);
+    static Lute::string_view logIoUring = LUTE_INI_READ(
+        LUTE_LOGGER_INI_SECTION, LUTE_LOGGER_INI_LOG_IO_URING_KEY);
+
+    Lute::ThreadOptions options;
+    options.cpus = Lute::ThreadOptions::parseCpuList(logThreadCpus.data());
 
     Lute::Logger::setLogLevel(logLevel);
     g_asyncLogger = Lute::SingletonPtr<Lute::AsyncLogger>::GetInstance(
         logFilename.data(), ::atoi(logFileRollsize.data()),
-        ::atoi(logFlushInterval.data()));
+        ::atoi(logFlushInterval.data()), options);
+    g_asyncLogger->setIoUring(logIoUring == "true");
     Lute::Logger::setOutput(defaultAsyncOutput);
     g_asyncLogger->start();
 }
@@ -325,10 +348,11 @@ Lute::LogFile::LogFile(const std::string& basename, off_t rollSize,
       flushInterval_(flushInterval),
       checkEveryN_(checkEveryN),
       count_(0),
-      mutex_(threadSafe ? new MutexLock : nullptr),
+      mutex_(threadSafe ? new MutexLock("LogFile") : nullptr),
       startOfPeriod_(0),
       lastRoll_(0),
-      lastFlush_(0) {
+      lastFlush_(0),
+      ring_(nullptr) {
     assert(basename.find('/') == std::string::npos);
     rollFile();
 }
@@ -344,6 +368,15 @@ void Lute::LogFile::append(const char* logline, int len) {
     }
 }
 
+void Lute::LogFile::appendv(const struct iovec* iov, int count) {
+    if (mutex_) {
+        MutexLockGuard lock(*mutex_);
+        appendv_unlocked(iov, count);
+    } else {
+        appendv_unlocked(iov, count);
+    }
+}
+
 void Lute::LogFile::flush() {
     if (mutex_) {
         MutexLockGuard lock(*mutex_);
@@ -355,7 +388,15 @@ void Lute::LogFile::flush() {
 
 void Lute::LogFile::append_unlocked(const char* logline, int len) {
     file_->append(logline, len);
+    checkRoll();
+}
+
+void Lute::LogFile::appendv_unlocked(const struct iovec* iov, int count) {
+    file_->appendv(iov, count, ring_);
+    checkRoll();
+}
 
+void Lute::LogFile::checkRoll() {
     if (file_->writtenBytes() > rollSize_) {
         rollFile();
     } else {
@@ -518,18 +559,25 @@ void Lute::Logger::setOutput(OutputFunc out) { g_output = out; }
 void Lute::Logger::setFlush(FlushFunc flush) { g_flush = flush; }
 
 /// NOTE ----------- AsyncLogger -----------
+Lute::ObjectPool<Lute::AsyncLogger::Buffer>& Lute::AsyncLogger::bufferPool() {
+    // 有意泄漏: 静态 AsyncLogger 可能在它之后析构
+    static ObjectPool<Buffer>* pool = new ObjectPool<Buffer>(0);
+    return *pool;
+}
+
 Lute::AsyncLogger::AsyncLogger(const std::string& basename, off_t rollSize,
-                               int flushInterval)
+                               int flushInterval, const ThreadOptions& options)
     : flushInterval_(flushInterval),
       running_(false),
       basename_(basename),
       rollSize_(rollSize),
-      thread_(std::bind(&AsyncLogger::threadFunc, this), "AsyncLogger"),
+      useIoUring_(false),
+      thread_(std::bind(&AsyncLogger::threadFunc, this), "AsyncLogger",
+              options),
       latch_(1),
-      mutex_(),
-      cond_(mutex_),
-      currentBuffer_(new Buffer),
-      nextBuffer_(new Buffer),
+      mutex_("AsyncLogger"),
+      currentBuffer_(bufferPool().make()),
+      nextBuffer_(bufferPool().make()),
       buffers_() {
     currentBuffer_->bzero();
     nextBuffer_->bzero();
@@ -543,29 +591,34 @@ Lute::AsyncLogger::AsyncLogger(const std::string& basename, off_t rollSize,
 /// @param logline 日志信息
 /// @param len 日志信息长度
 void Lute::AsyncLogger::append(const char* logline, int len) {
-    MutexLockGuard lock(mutex_);
-
-    /// 当前写缓冲有足够的空间放置日志信息
-    /// 直接放入
-    if (currentBuffer_->avail() > len) {
-        currentBuffer_->append(logline, static_cast<size_t>(len));
-    } else {  /// 当前缓冲空间不足
-        /// 将当前缓冲移动到 buffers_ 集合中，等待写入文件系统
-        buffers_.push_back(std::move(currentBuffer_));  /// 利用 移动 而非 复制
-
-        /// 如果 预备缓冲 未被移动，则将预备缓冲移动做到当前缓冲
-        /// 也就是说，前端线程的写入速度小于后端线程的文件写入速度
-        if (nextBuffer_) {
-            currentBuffer_ = std::move(nextBuffer_);
-        } else {  /// 前端线程写入太快，需要重新申请一块新的缓冲作为当前缓冲
-            // Rarely happens
-            currentBuffer_.reset(new Buffer);
-        }
+    bool full = false;
+    {
+        FastMutexGuard lock(mutex_);
+
+        /// 当前写缓冲有足够的空间放置日志信息
+        /// 直接放入
+        if (currentBuffer_->avail() > len) {
+            currentBuffer_->append(logline, static_cast<size_t>(len));
+        } else {  /// 当前缓冲空间不足
+            /// 将当前缓冲移动到 buffers_ 集合中，等待写入文件系统
+            buffers_.push_back(std::move(currentBuffer_));  /// 利用 移动
+
+            /// 如果 预备缓冲 未被移动，则将预备缓冲移动做到当前缓冲
+            /// 也就是说，前端线程的写入速度小于后端线程的文件写入速度
+            if (nextBuffer_) {
+                currentBuffer_ = std::move(nextBuffer_);
+            } else {  /// 前端线程写入太快，需要重新申请一块新的缓冲
+                // Rarely happens
+                currentBuffer_ = bufferPool().make();
+            }
 
-        /// 日志文件写入
-        currentBuffer_->append(logline, static_cast<size_t>(len));
-        cond_.notify();
+            /// 日志文件写入
+            currentBuffer_->append(logline, static_cast<size_t>(len));
+            full = true;
+        }
     }
+    /// 解锁之后再唤醒，避免后端线程醒来后立即阻塞在锁上
+    if (full) wakeup_.notify();
 }
 
 /// @brief 后端线程调用，把日志信息写入文件系统
@@ -576,14 +629,40 @@ void Lute::AsyncLogger::threadFunc() {
     // LogFile output(basename_, rollSize_, false);
     LogFile output(basename_, rollSize_, false, flushInterval_);
 
-    BufferPtr newBuffer1(new Buffer);
-    BufferPtr newBuffer2(new Buffer);
+    BufferPtr newBuffer1 = bufferPool().make();
+    BufferPtr newBuffer2 = bufferPool().make();
     newBuffer1->bzero();
     newBuffer2->bzero();
 
     /// 申请一块大小为16的缓冲集，一般只会用到2块，除非前端写入速度太快
     BufferVector buffersToWrite;
     buffersToWrite.reserve(16);
+    std::vector<struct iovec> iov;
+    iov.reserve(16);
+
+    /// 前后端循环使用的 4 块缓冲注册为 io_uring 固定缓冲区，写入时不再
+    /// 逐次 pin 页面；注册失败 (如超出 RLIMIT_MEMLOCK) 时照常写入
+    std::unique_ptr<IoUring> ring;
+    /// 已注册的缓冲不能释放 (内核持有其页面)，多余的暂存于此
+    BufferVector spareBuffers;
+    if (useIoUring_ && IoUring::supported()) {
+        ring.reset(new IoUring(32));
+        std::vector<struct iovec> fixed;
+        {
+            FastMutexGuard lock(mutex_);
+            for (Buffer* buffer : {currentBuffer_.get(), nextBuffer_.get(),
+                                   newBuffer1.get(), newBuffer2.get()}) {
+                fixed.push_back(
+                    {const_cast<char*>(buffer->data()), Buffer::capacity()});
+            }
+        }
+        ring->registerBuffers(fixed.data(),
+                              static_cast<unsigned>(fixed.size()));
+        output.setIoUring(ring.get());
+    }
+    auto isRegistered = [&ring](const BufferPtr& buffer) {
+        return ring && ring->findBuffer(buffer->data(), 1) >= 0;
+    };
 
     // currentBuffer_->length() 确保当前缓冲区数据写入完毕
     while (running_ || currentBuffer_->length() > 0) {
@@ -592,10 +671,24 @@ void Lute::AsyncLogger::threadFunc() {
         assert(buffersToWrite.empty());
 
         /// Swap out what need to be written, keep CS short
+        /// 没有写满的缓冲时最多等待 flushInterval_ 秒
+        {
+            uint32_t key = wakeup_.prepareWait();
+            bool empty;
+            {
+                FastMutexGuard lock(mutex_);
+                empty = buffers_.empty();
+            }
+            if (empty && running_) {
+                wakeup_.waitFor(key, static_cast<int64_t>(flushInterval_) *
+                                         1000000000);
+            } else {
+                wakeup_.cancelWait();
+            }
+        }
+
         {
-            MutexLockGuard lock(mutex_);
-            if (buffers_.empty())  // unusual usage!
-                cond_.waitForSeconds(flushInterval_);
+            FastMutexGuard lock(mutex_);
 
             /// 采用move 提高效率
             buffers_.push_back(std::move(currentBuffer_));
@@ -609,8 +702,9 @@ void Lute::AsyncLogger::threadFunc() {
         assert(!buffersToWrite.empty());
 
         /// 待写入缓冲集长度不对 输出错误
-        /// 将错误数据写入文件，并裁剪待写入缓冲集
-        if (buffersToWrite.size() > 25) {
+        /// 将错误数据写入文件，只写入前两块缓冲
+        size_t numToWrite = buffersToWrite.size();
+        if (numToWrite > 25) {
             char buf[256];
             snprintf(buf, sizeof buf,
                      "Dropped log messages at %s, %zd larger buffers\n",
@@ -618,33 +712,40 @@ void Lute::AsyncLogger::threadFunc() {
                      buffersToWrite.size() - 2);
             fputs(buf, stderr);
             output.append(buf, static_cast<int>(strlen(buf)));
-            buffersToWrite.erase(buffersToWrite.begin() + 2,
-                                 buffersToWrite.end());
-        }
-
-        /// 迭代待写入缓冲集，将缓冲日志写入文件系统
-        for (const auto& buffer : buffersToWrite) {
-            // FIXME: use unbuffered stdio FILE ? or use ::writev ?
-            output.append(buffer->data(), buffer->length());
+            numToWrite = 2;
         }
 
-        if (buffersToWrite.size() > 2) {
-            // drop non-bzero-ed buffers, avoid trashing
-            buffersToWrite.resize(2);
+        /// 待写入缓冲集一次写入文件系统 (io_uring 或 writev)
+        iov.clear();
+        for (size_t i = 0; i < numToWrite; ++i) {
+            const BufferPtr& buffer = buffersToWrite[i];
+            iov.push_back({const_cast<char*>(buffer->data()),
+                           static_cast<size_t>(buffer->length())});
         }
-
-        if (!newBuffer1) {
-            assert(!buffersToWrite.empty());
-            newBuffer1 = std::move(buffersToWrite.back());
-            buffersToWrite.pop_back();
-            newBuffer1->reset();
+        output.appendv(iov.data(), static_cast<int>(iov.size()));
+
+        /// 优先用备用的已注册缓冲补齐，其次是前两块缓冲，
+        /// drop non-bzero-ed buffers, avoid trashing
+        for (BufferPtr* slot : {&newBuffer1, &newBuffer2}) {
+            if (*slot) continue;
+            if (!spareBuffers.empty()) {
+                *slot = std::move(spareBuffers.back());
+                spareBuffers.pop_back();
+            } else {
+                assert(!buffersToWrite.empty());
+                auto first = std::find_if(
+                    buffersToWrite.begin(), buffersToWrite.end(),
+                    [](const BufferPtr& buffer) { return buffer != nullptr; });
+                assert(first != buffersToWrite.end());
+                *slot = std::move(*first);
+            }
+            (*slot)->reset();
         }
-
-        if (!newBuffer2) {
-            assert(!buffersToWrite.empty());
-            newBuffer2 = std::move(buffersToWrite.back());
-            buffersToWrite.pop_back();
-            newBuffer2->reset();
+        for (BufferPtr& buffer : buffersToWrite) {
+            if (buffer && isRegistered(buffer)) {
+                buffer->reset();
+                spareBuffers.push_back(std::move(buffer));
+            }
         }
 
         buffersToWrite.clear();
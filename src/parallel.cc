@@ -0,0 +1,14 @@
+#include <Base/parallel.h>
+
+Lute::ThreadPool& Lute::defaultThreadPool() {
+    // 首次调用时构造并启动 (线程安全)，进程退出时析构并停止工作线程
+    static ThreadPool pool("Parallel");
+    static bool started = (pool.start(), true);
+    (void)started;
+    return pool;
+}
+
+Lute::EventCount& Lute::detail::taskGroupDone() {
+    static EventCount* done = new EventCount;
+    return *done;
+}
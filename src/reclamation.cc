@@ -0,0 +1,242 @@
+#include <Base/currentThread.h>
+#include <Base/reclamation.h>
+
+#include <algorithm>  // sort, binary_search
+#include <cassert>    // assert
+
+using namespace Lute;
+
+/// NOTE ----------- ReclaimDomain -----------
+ReclaimDomain::ReclaimDomain()
+    : records_(&ReclaimDomain::releaseRecord),
+      reclaimed_(0),
+      reclaimerRunning_(false) {}
+
+ReclaimDomain::~ReclaimDomain() = default;
+
+void ReclaimDomain::shutdown() {
+    stopReclaimer();
+    // 之后线程退出不再调用 releaseRecord
+    Record* r = records_.takeAll();
+
+    std::vector<Retired> all;
+    {
+        FastMutexGuard lock(mutex_);
+        all.swap(pending_);
+    }
+    while (r != nullptr) {
+        all.insert(all.end(), r->batch.begin(), r->batch.end());
+        Record* next = r->next;
+        delete r;
+        r = next;
+    }
+    for (const Retired& item : all) item.deleter(item.ptr);
+    reclaimed_.fetch_add(all.size(), std::memory_order_relaxed);
+}
+
+ReclaimDomain::Record* ReclaimDomain::localRecord() {
+    Record* record = records_.current();
+    if (record != nullptr) return record;
+
+    record = records_.acquire([this]() {
+        Record* r = newRecord();
+        r->domain = this;
+        return r;
+    });
+    record->tid = CurrentThread::tid();
+    return record;
+}
+
+void ReclaimDomain::releaseRecord(void* ptr) {
+    auto* record = static_cast<Record*>(ptr);
+    ReclaimDomain* domain = record->domain;
+    domain->flush(record);
+    domain->onRelease(record);
+    record->tid = 0;
+    ThreadRecordList<Record>::release(record);
+}
+
+void ReclaimDomain::flush(Record* record) {
+    if (record->batch.empty()) return;
+    FastMutexGuard lock(mutex_);
+    pending_.insert(pending_.end(), record->batch.begin(),
+                    record->batch.end());
+    record->batch.clear();
+}
+
+void ReclaimDomain::retire(void* ptr, Deleter deleter) {
+    assert(ptr != nullptr);
+    Record* record = localRecord();
+    record->batch.push_back(Retired{ptr, deleter, stamp()});
+    if (record->batch.size() >= kBatchSize) {
+        flush(record);
+        if (!reclaimerRunning_.load(std::memory_order_relaxed)) reclaim();
+    }
+}
+
+size_t ReclaimDomain::reclaim() {
+    Record* record = records_.current();
+    if (record != nullptr) flush(record);
+
+    std::vector<Retired> candidates;
+    {
+        FastMutexGuard lock(mutex_);
+        candidates.swap(pending_);
+    }
+    if (candidates.empty()) return 0;
+
+    std::vector<Retired> freeable;
+    collect(&candidates, &freeable);
+    if (!candidates.empty()) {
+        FastMutexGuard lock(mutex_);
+        pending_.insert(pending_.end(), candidates.begin(), candidates.end());
+    }
+
+    for (const Retired& item : freeable) item.deleter(item.ptr);
+    reclaimed_.fetch_add(freeable.size(), std::memory_order_relaxed);
+    return freeable.size();
+}
+
+size_t ReclaimDomain::pending() const {
+    FastMutexGuard lock(mutex_);
+    return pending_.size();
+}
+
+void ReclaimDomain::startReclaimer(int intervalMs) {
+    assert(!reclaimer_);
+    stopReclaimer_.reset();
+    reclaimerRunning_.store(true, std::memory_order_relaxed);
+    reclaimer_.reset(new Thread(
+        [this, intervalMs]() { reclaimerFunc(intervalMs); }, "Reclaimer"));
+    reclaimer_->start();
+}
+
+void ReclaimDomain::stopReclaimer() {
+    if (!reclaimer_) return;
+    stopReclaimer_.set();
+    reclaimer_->join();
+    reclaimer_.reset();
+    reclaimerRunning_.store(false, std::memory_order_relaxed);
+}
+
+void ReclaimDomain::reclaimerFunc(int intervalMs) {
+    const int64_t intervalNs = static_cast<int64_t>(intervalMs) * 1000 * 1000;
+    while (!stopReclaimer_.waitFor(intervalNs)) reclaim();
+}
+
+/// NOTE ----------- EpochDomain -----------
+EpochDomain::EpochDomain() : epoch_(2) {}
+
+EpochDomain::~EpochDomain() { shutdown(); }
+
+void EpochDomain::enter() {
+    auto* record = static_cast<EpochRecord*>(localRecord());
+    if (record->nest++ > 0) return;
+    // 公布之后才读取共享指针；公布的纪元落后于全局纪元只会推迟回收
+    record->epoch.store(epoch_.load(std::memory_order_relaxed),
+                        std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+}
+
+void EpochDomain::leave() {
+    auto* record = static_cast<EpochRecord*>(localRecord());
+    assert(record->nest > 0);
+    if (--record->nest == 0) {
+        record->epoch.store(0, std::memory_order_release);
+    }
+}
+
+bool EpochDomain::tryAdvance() {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    uint64_t current = epoch_.load(std::memory_order_seq_cst);
+    bool allCaughtUp = true;
+    forEachRecord([&](Record* r) {
+        uint64_t e = static_cast<EpochRecord*>(r)->epoch.load(
+            std::memory_order_seq_cst);
+        if (e != 0 && e != current) allCaughtUp = false;
+    });
+    return allCaughtUp &&
+           epoch_.compare_exchange_strong(current, current + 1,
+                                          std::memory_order_seq_cst);
+}
+
+uint64_t EpochDomain::stamp() {
+    // 调用方已摘除对象，之后进入临界区的读者不会再访问它；栅栏保证摘除
+    // 先于读取纪元对其他线程可见
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    return epoch_.load(std::memory_order_seq_cst);
+}
+
+void EpochDomain::onRelease(Record* record) {
+    auto* r = static_cast<EpochRecord*>(record);
+    assert(r->nest == 0);
+    r->nest = 0;
+    r->epoch.store(0, std::memory_order_release);
+}
+
+void EpochDomain::collect(std::vector<Retired>* candidates,
+                          std::vector<Retired>* freeable) {
+    // 纪元 e 退休的对象在全局纪元到达 e + 2 时安全，最多推进两次
+    tryAdvance();
+    tryAdvance();
+    const uint64_t current = epoch_.load(std::memory_order_acquire);
+    auto safe = std::stable_partition(
+        candidates->begin(), candidates->end(),
+        [current](const Retired& item) { return item.epoch + 2 > current; });
+    freeable->assign(safe, candidates->end());
+    candidates->erase(safe, candidates->end());
+}
+
+/// NOTE ----------- HazardPointerDomain -----------
+HazardPointerDomain::HazardPointerDomain() {}
+
+HazardPointerDomain::~HazardPointerDomain() { shutdown(); }
+
+std::atomic<void*>* HazardPointerDomain::acquireSlot() {
+    auto* record = static_cast<HazardRecord*>(localRecord());
+    for (int i = 0; i < kHazardsPerThread; ++i) {
+        if (!(record->used & (1u << i))) {
+            record->used |= 1u << i;
+            return &record->hazards[i];
+        }
+    }
+    assert(false && "too many hazard pointers in one thread");
+    return nullptr;
+}
+
+void HazardPointerDomain::releaseSlot(std::atomic<void*>* slot) {
+    auto* record = static_cast<HazardRecord*>(localRecord());
+    slot->store(nullptr, std::memory_order_release);
+    record->used &= ~(1u << (slot - record->hazards));
+}
+
+void HazardPointerDomain::onRelease(Record* record) {
+    auto* r = static_cast<HazardRecord*>(record);
+    for (auto& hazard : r->hazards) {
+        hazard.store(nullptr, std::memory_order_release);
+    }
+    r->used = 0;
+}
+
+void HazardPointerDomain::collect(std::vector<Retired>* candidates,
+                                  std::vector<Retired>* freeable) {
+    // 对象在退休之前已被摘除: 此后公布它的读者在 protect 复查时会失败
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    std::vector<void*> hazards;
+    forEachRecord([&hazards](Record* r) {
+        for (auto& hazard : static_cast<HazardRecord*>(r)->hazards) {
+            void* ptr = hazard.load(std::memory_order_seq_cst);
+            if (ptr != nullptr) hazards.push_back(ptr);
+        }
+    });
+    std::sort(hazards.begin(), hazards.end());
+
+    auto safe = std::stable_partition(
+        candidates->begin(), candidates->end(),
+        [&hazards](const Retired& item) {
+            return std::binary_search(hazards.begin(), hazards.end(),
+                                      item.ptr);
+        });
+    freeable->assign(safe, candidates->end());
+    candidates->erase(safe, candidates->end());
+}
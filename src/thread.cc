@@ -1,9 +1,17 @@
 #include <Base/currentThread.h>
 #include <Base/exception.h>
+#include <Base/futex.h>
+#include <Base/objectPool.h>
 #include <Base/thread.h>
-#include <sys/prctl.h>    // prctl
-#include <sys/syscall.h>  // SYS_gettid
-#include <unistd.h>       // syscall getpid
+#include <linux/mempolicy.h>  // MPOL_PREFERRED
+#include <sys/prctl.h>        // prctl
+#include <sys/resource.h>     // setpriority
+#include <sys/syscall.h>      // SYS_gettid, SYS_set_mempolicy
+#include <unistd.h>           // syscall getpid
+
+#include <cassert>  // assert
+#include <cerrno>   // errno
+#include <cstring>  // strerror
 
 namespace Lute {
 
@@ -52,35 +60,120 @@ namespace detail {
 
     ThreadNameInitializer init;
 
+    /// @brief 输出设置线程参数失败的原因
+    void reportOptionError(const std::string& name, const char* what,
+                           int err) {
+        fprintf(stderr, "Thread %s: %s failed: %s\n", name.c_str(), what,
+                strerror(err));
+    }
+
+    /// @brief 在新线程中应用 ThreadOptions (栈大小除外)
+    void applyOptions(const ThreadOptions& options, const std::string& name) {
+        if (!options.cpus.empty()) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            for (int cpu : options.cpus) {
+                if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+            }
+            int ret = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+            if (ret != 0) reportOptionError(name, "set affinity", ret);
+        }
+
+        if (options.schedPolicy != SCHED_OTHER) {
+            struct sched_param param;
+            memset(&param, 0, sizeof(param));
+            param.sched_priority = options.schedPriority;
+            int ret = pthread_setschedparam(pthread_self(),
+                                            options.schedPolicy, &param);
+            if (ret != 0) reportOptionError(name, "set scheduler", ret);
+        }
+
+        // Linux 上 nice 值属于线程，PRIO_PROCESS + tid 只影响当前线程
+        if (options.nice != 0 &&
+            ::setpriority(PRIO_PROCESS,
+                          static_cast<id_t>(CurrentThread::tid()),
+                          options.nice) != 0) {
+            reportOptionError(name, "setpriority", errno);
+        }
+
+        if (options.numaNode >= 0) {
+            const unsigned long kBits = 8 * sizeof(unsigned long);
+            std::vector<unsigned long> mask(options.numaNode / kBits + 1, 0);
+            mask[options.numaNode / kBits] |= 1UL << (options.numaNode % kBits);
+            if (::syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask.data(),
+                          mask.size() * kBits + 1) != 0) {
+                reportOptionError(name, "set_mempolicy", errno);
+            }
+        }
+    }
+
+    struct ThreadData;
+    ObjectPool<ThreadData>& threadDataPool();
+
     /**
-     * @brief func_ / name_ / tid_ / latch_
+     * @brief Thread 与新线程共享的数据: func_ / name_ / options_ / tid_
+     *
+     * 引用计数由 Thread 和新线程各持有一份，最后一个释放者负责归还到
+     * threadDataPool()，因此 Thread 可以在新线程运行期间被移动或析构。
      */
     struct ThreadData {
         using ThreadFunc = Thread::ThreadFunc;
 
+        /// tid_ 的最高位: 有线程在 futex 上等待 tid
+        static constexpr uint32_t kWaiting = 1u << 31;
+
         ThreadFunc func_;
         std::string name_;
-        pid_t* tid_;
-        Lute::CountDownLatch* latch_;
+        ThreadOptions options_;
+        /// 新线程报告之前为 0，之后为 tid
+        std::atomic<uint32_t> tid_;
+        std::atomic<int> refs_;
 
         /// @brief Constructor
         /// @param func
         /// @param name
-        /// @param tid
-        /// @param latch
-        ThreadData(ThreadFunc func, std::string name, pid_t* tid,
-                   Lute::CountDownLatch* latch)
+        /// @param options
+        ThreadData(ThreadFunc func, std::string name, ThreadOptions options)
             : func_(std::move(func)),
               name_(std::move(name)),
-              tid_(tid),
-              latch_(latch) {}
+              options_(std::move(options)),
+              tid_(0),
+              refs_(2) {}
+
+        void release() {
+            if (refs_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                threadDataPool().release(this);
+            }
+        }
+
+        /// @brief 新线程: 报告 tid，有等待者时才唤醒
+        void publishTid(pid_t tid) {
+            uint32_t prev =
+                tid_.exchange(static_cast<uint32_t>(tid),
+                              std::memory_order_release);
+            if (prev & kWaiting) Futex::wake(&tid_);
+        }
+
+        /// @brief 等待新线程报告 tid
+        pid_t waitTid() {
+            uint32_t v = tid_.load(std::memory_order_acquire);
+            while (v == 0 || v == kWaiting) {
+                if (v == 0 &&
+                    !tid_.compare_exchange_weak(v, kWaiting,
+                                                std::memory_order_acquire)) {
+                    continue;
+                }
+                Futex::wait(&tid_, kWaiting);
+                v = tid_.load(std::memory_order_acquire);
+            }
+            return static_cast<pid_t>(v);
+        }
 
         /// @brief Call this->func_()
         void runThread() {
-            *tid_ = Lute::CurrentThread::tid();
-            tid_ = nullptr;
-            latch_->countDown();
-            latch_ = nullptr;
+            // 先应用线程参数，start() 返回时线程已经位于指定的 CPU 上
+            applyOptions(options_, name_);
+            publishTid(Lute::CurrentThread::tid());
 
             Lute::CurrentThread::t_threadName =
                 name_.empty() ? "LuteThread" : name_.c_str();
@@ -111,13 +204,21 @@ namespace detail {
         }
     };
 
+    /// 有意泄漏: 线程退出时 pthread key 的析构函数仍会访问它
+    ObjectPool<ThreadData>& threadDataPool() {
+        static ObjectPool<ThreadData>* pool = new ObjectPool<ThreadData>(8);
+        return *pool;
+    }
+
     /// @brief Call runThread()
     /// @param arg ThreadData*
     /// @return nullptr
     void* startThread(void* arg) {
         auto* data = static_cast<ThreadData*>(arg);
         data->runThread();
-        delete data;
+        // 线程结束时即释放线程函数持有的资源，不必等到 Thread 析构
+        data->func_ = nullptr;
+        data->release();
         return nullptr;
     }
 }  // namespace detail
@@ -152,14 +253,15 @@ void CurrentThread::sleepUsec(int64_t usec) {
 // ------------------------------------------------------------
 std::atomic_int32_t Thread::numCreated_;
 
-Thread::Thread(ThreadFunc func, std::string name)
+Thread::Thread(ThreadFunc func, std::string name, ThreadOptions options)
     : started_(false),
       joined_(false),
       pthreadId_(0),
       tid_(0),
       func_(std::move(func)),
       name_(std::move(name)),
-      latch_(1) {
+      options_(std::move(options)),
+      data_(nullptr) {
     setDefaultName();
 }
 
@@ -167,6 +269,46 @@ Thread::~Thread() {
     if (started_ && !joined_) {
         pthread_detach(pthreadId_);
     }
+    if (data_ != nullptr) data_->release();
+}
+
+Thread::Thread(Thread&& other) noexcept
+    : started_(other.started_),
+      joined_(other.joined_),
+      pthreadId_(other.pthreadId_),
+      tid_(other.tid_.load(std::memory_order_relaxed)),
+      func_(std::move(other.func_)),
+      name_(std::move(other.name_)),
+      options_(std::move(other.options_)),
+      data_(other.data_) {
+    other.started_ = false;
+    other.joined_ = false;
+    other.tid_.store(0, std::memory_order_relaxed);
+    other.data_ = nullptr;
+}
+
+Thread& Thread::operator=(Thread&& other) noexcept {
+    if (this == &other) return *this;
+    if (started_ && !joined_) {
+        pthread_detach(pthreadId_);
+    }
+    if (data_ != nullptr) data_->release();
+
+    started_ = other.started_;
+    joined_ = other.joined_;
+    pthreadId_ = other.pthreadId_;
+    tid_.store(other.tid_.load(std::memory_order_relaxed),
+               std::memory_order_relaxed);
+    func_ = std::move(other.func_);
+    name_ = std::move(other.name_);
+    options_ = std::move(other.options_);
+    data_ = other.data_;
+
+    other.started_ = false;
+    other.joined_ = false;
+    other.tid_.store(0, std::memory_order_relaxed);
+    other.data_ = nullptr;
+    return *this;
 }
 
 /// @brief Set the name of thread to "Thread..."
@@ -183,30 +325,73 @@ void Thread::setDefaultName() {
 /// @brief Thread start including:
 /// 1. pthread_create()
 /// 2. startThread()
-/// 3. latch_.wait()
-void Thread::start() {
+/// 3. wait for tid (optional)
+void Thread::start(bool waitForTid) {
     // Ensure the thread is not started
     assert(!started_);
     started_ = true;
 
-    // FIXME: move(func_)
-    auto* data = new detail::ThreadData(func_, name_, &tid_, &latch_);
-    // auto* data =
-    //     new detail::ThreadData(std::move(func_), name_, &tid_, &latch_);
+    // 线程函数移动到共享数据中，Thread 与新线程各持有一个引用
+    data_ = detail::threadDataPool().acquire(std::move(func_), name_, options_);
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    if (options_.stackSize > 0) {
+        int ret = pthread_attr_setstacksize(&attr, options_.stackSize);
+        if (ret != 0) detail::reportOptionError(name_, "set stack size", ret);
+    }
 
     // 当线程创建时，线程函数就已经开始执行
-    if (pthread_create(&pthreadId_, nullptr, &detail::startThread, data)) {
+    int ret = pthread_create(&pthreadId_, &attr, &detail::startThread, data_);
+    pthread_attr_destroy(&attr);
+    if (ret != 0) {
         started_ = false;
-        delete data;  // or no delete?
+        detail::threadDataPool().release(data_);
+        data_ = nullptr;
         // LOG_SYSFATAL << "Failed in pthread_create";
         perror("Failed in pthread_create");
         abort();
-    } else {
-        latch_.wait();
+    } else if (waitForTid) {
+        tid();
         assert(tid_ > 0);
     }
 }
 
+pid_t Thread::tid() const {
+    // waitTid() 已经建立了同步，并发的调用者写入的是同一个值
+    pid_t tid = tid_.load(std::memory_order_relaxed);
+    if (tid == 0 && data_ != nullptr) {
+        tid = data_->waitTid();
+        tid_.store(tid, std::memory_order_relaxed);
+    }
+    return tid;
+}
+
+std::vector<int> ThreadOptions::parseCpuList(const std::string& list) {
+    std::vector<int> cpus;
+    const char* p = list.c_str();
+    while (*p != '\0') {
+        char* end = nullptr;
+        long first = strtol(p, &end, 10);
+        if (end == p) {  // 不是数字，跳过该字符
+            ++p;
+            continue;
+        }
+        long last = first;
+        p = end;
+        if (*p == '-') {
+            last = strtol(p + 1, &end, 10);
+            if (end == p + 1) last = first;
+            p = end;
+        }
+        for (long cpu = first; cpu >= 0 && cpu <= last && cpu < CPU_SETSIZE;
+             ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
 /// @brief thread join
 /// @return pthread_join(pthreadId_, nullptr)
 int Thread::join() {
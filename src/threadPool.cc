@@ -0,0 +1,215 @@
+#include <Base/logger.h>
+#include <Base/threadPool.h>
+#include <pthread.h>  // pthread_setaffinity_np
+#include <unistd.h>   // sysconf
+
+#include <cassert>  // assert
+#include <thread>   // this_thread::yield
+
+namespace {
+/// 当前线程所属的线程池及其序号，非工作线程为 nullptr
+__thread const Lute::ThreadPool* t_pool = nullptr;
+__thread size_t t_workerIndex = 0;
+
+/// 无任务时自旋的轮数，超过后休眠
+const int kSpinRounds = 64;
+
+inline uint64_t xorshift(uint64_t& state) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+}
+}  // namespace
+
+using namespace Lute;
+
+ThreadPool::ThreadPool(const std::string& name)
+    : name_(name),
+      maxQueueSize_(65536),
+      affinity_(false),
+      running_(false),
+      quit_(false),
+      inFlight_(0) {}
+
+ThreadPool::~ThreadPool() {
+    if (running_) stop();
+}
+
+void ThreadPool::start(int numThreads) {
+    assert(threads_.empty());
+    if (numThreads <= 0) {
+        numThreads = static_cast<int>(::sysconf(_SC_NPROCESSORS_ONLN));
+        if (numThreads <= 0) numThreads = 1;
+    }
+
+    injection_.reset(new MPMCQueue<Task*>(maxQueueSize_));
+    // 上一次 stop() 保留的工作线程状态在此释放
+    workers_.clear();
+    workers_.reserve(numThreads);
+    for (int i = 0; i < numThreads; ++i) {
+        workers_.emplace_back(new Worker);
+        workers_.back()->rng = 0x9E3779B97F4A7C15ULL * (i + 1);
+    }
+
+    quit_ = false;
+    running_ = true;
+    threads_.reserve(numThreads);
+    for (int i = 0; i < numThreads; ++i) {
+        char id[32];
+        snprintf(id, sizeof(id), "%d", i + 1);
+        threads_.emplace_back(
+            new Thread(std::bind(&ThreadPool::runInThread, this, i),
+                       name_ + id));
+        threads_.back()->start(false);  // 工作线程的 tid 不需要等待
+    }
+}
+
+void ThreadPool::stop() {
+    if (!running_.exchange(false)) return;
+    // 之后进入 run() 的调用者都会看到 running_ 为 false，直接执行任务；
+    // 等待已经越过检查的调用者把任务放入队列，工作线程仍在运行，
+    // 注入队列满时的阻塞 push 也能完成
+    while (inFlight_.load(std::memory_order_seq_cst) > 0) {
+        std::this_thread::yield();
+    }
+    quit_.store(true, std::memory_order_release);
+    idle_.notifyAll();
+    for (auto& thr : threads_) thr->join();
+
+    // 工作线程退出之前最后一次查找之后才放入注入队列的任务
+    Task* task = nullptr;
+    while (injection_->tryPop(task)) execute(task);
+    // workers_ 保留到下一次 start() 或析构，并发的 tryRunOne() /
+    // numThreads() / queueSize() 不会访问已释放的内存
+    threads_.clear();
+}
+
+bool ThreadPool::enter() {
+    // 与 stop() 构成 Dekker 式握手: 要么这里看到 running_ 为 false，
+    // 要么 stop() 看到 inFlight_ 大于 0 并等待
+    inFlight_.fetch_add(1, std::memory_order_seq_cst);
+    if (running_.load(std::memory_order_seq_cst)) return true;
+    leave();
+    return false;
+}
+
+void ThreadPool::leave() {
+    inFlight_.fetch_sub(1, std::memory_order_release);
+}
+
+void ThreadPool::run(Task task) {
+    if (!enter()) {
+        task();
+        return;
+    }
+
+    auto* t = new Task(std::move(task));
+    if (t_pool == this) {
+        workers_[t_workerIndex]->deque.push(t);
+    } else {
+        injection_->push(t);
+    }
+    idle_.notify();
+    leave();
+}
+
+bool ThreadPool::tryRunOne() {
+    // workers_ 在 stop() 之后仍然保留，停止过程中等待子任务的工作线程
+    // 还能继续执行自己队列中的任务
+    if (workers_.empty()) return false;
+    Worker* self = t_pool == this ? workers_[t_workerIndex].get() : nullptr;
+    Task* task = findTask(self);
+    if (task == nullptr) return false;
+    execute(task);
+    return true;
+}
+
+bool ThreadPool::inWorkerThread() const { return t_pool == this; }
+
+size_t ThreadPool::queueSize() const {
+    size_t size = injection_ ? injection_->sizeGuess() : 0;
+    for (const auto& w : workers_) size += w->deque.sizeGuess();
+    return size;
+}
+
+void ThreadPool::runInThread(size_t index) {
+    t_pool = this;
+    t_workerIndex = index;
+    Worker* self = workers_[index].get();
+
+    if (affinity_) {
+        long ncpu = ::sysconf(_SC_NPROCESSORS_ONLN);
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(index % (ncpu > 0 ? ncpu : 1), &set);
+        int ret = ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+        if (ret != 0) {
+            LOG_ERROR << "ThreadPool " << name_
+                      << " pthread_setaffinity_np error, errstr="
+                      << strerror_tl(ret);
+        }
+    }
+    if (threadInitCallback_) threadInitCallback_();
+
+    for (;;) {
+        Task* task = findTask(self);
+        for (int i = 0; task == nullptr && i < kSpinRounds; ++i) {
+            cpuRelax();
+            task = findTask(self);
+        }
+        if (task != nullptr) {
+            execute(task);
+            continue;
+        }
+
+        uint32_t key = idle_.prepareWait();
+        task = findTask(self);
+        if (task != nullptr) {
+            idle_.cancelWait();
+            execute(task);
+            continue;
+        }
+        // 所有队列都已为空才退出，保证 stop() 之前提交的任务都被执行
+        if (quit_.load(std::memory_order_acquire)) {
+            idle_.cancelWait();
+            break;
+        }
+        idle_.wait(key);
+    }
+
+    t_pool = nullptr;
+}
+
+ThreadPool::Task* ThreadPool::findTask(Worker* self) {
+    Task* task = nullptr;
+    if (self != nullptr && self->deque.take(task)) return task;
+    if (injection_->tryPop(task)) return task;
+    return steal(self);
+}
+
+ThreadPool::Task* ThreadPool::steal(Worker* self) {
+    size_t n = workers_.size();
+    uint64_t seed;
+    if (self != nullptr) {
+        seed = xorshift(self->rng);
+    } else {
+        // 非工作线程没有随机数状态，用栈地址区分调用者
+        uint64_t local = reinterpret_cast<uintptr_t>(&seed) | 1;
+        seed = xorshift(local);
+    }
+
+    // 从随机的起点开始轮询一遍全部工作线程
+    Task* task = nullptr;
+    for (size_t i = 0, start = seed % n; i < n; ++i) {
+        Worker* victim = workers_[(start + i) % n].get();
+        if (victim == self) continue;
+        if (victim->deque.steal(task)) return task;
+    }
+    return nullptr;
+}
+
+void ThreadPool::execute(Task* task) {
+    std::unique_ptr<Task> guard(task);
+    (*task)();
+}
@@ -0,0 +1,357 @@
+#include <Base/futex.h>
+#include <Base/timerWheel.h>
+
+#include <algorithm>  // min, max
+#include <cassert>    // assert
+#include <cmath>      // ceil
+#include <cstring>    // memset
+
+namespace {
+///
+/// @brief 在 nbits 位的位图中从 from 开始循环查找第一个置位的位
+/// @return 位下标，位图为空时返回 -1
+///
+int findNextSet(const uint64_t* words, int nbits, int from) {
+    for (int pass = 0; pass < 2; ++pass) {
+        int begin = pass == 0 ? from : 0;
+        int end = pass == 0 ? nbits : from;
+        for (int i = begin; i < end; i = (i | 63) + 1) {
+            uint64_t bits = words[i >> 6] >> (i & 63);
+            if (bits != 0) return i + __builtin_ctzll(bits);
+        }
+    }
+    return -1;
+}
+}  // namespace
+
+using namespace Lute;
+
+/// NOTE ----------- TimerWheel -----------
+TimerWheel::TimerWheel() : current_(0), size_(0), freeList_(kNil) {
+    for (auto& head : heads_) head = kNil;
+    memset(bitmap_, 0, sizeof(bitmap_));
+    memset(levelCount_, 0, sizeof(levelCount_));
+}
+
+uint64_t TimerWheel::periodTicks(double interval, int64_t tickNs) {
+    if (interval <= 0) return 0;
+    auto ticks = static_cast<uint64_t>(std::ceil(interval * 1e9 / tickNs));
+    return std::max<uint64_t>(ticks, 1);
+}
+
+TimerId TimerWheel::add(uint64_t delay, Callback cb, uint64_t interval) {
+    uint32_t index = allocNode();
+    Node& node = nodes_[index];
+    node.cb = std::move(cb);
+    node.expire = current_ + std::max<uint64_t>(delay, 1);
+    node.interval = interval;
+    place(index);
+    ++size_;
+
+    TimerId id;
+    id.index = index;
+    id.generation = node.generation;
+    return id;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    if (!id.valid() || id.index >= nodes_.size()) return false;
+    Node& node = nodes_[id.index];
+    if (node.generation != id.generation) return false;
+    switch (node.state) {
+        case State::kPending:
+            unlink(id.index);
+            freeNode(id.index);
+            --size_;
+            return true;
+        case State::kRunning:
+            // 回调结束之后释放
+            node.state = State::kCancelled;
+            return true;
+        default:
+            return false;
+    }
+}
+
+size_t TimerWheel::advance(uint64_t tick, const Invoker& invoke) {
+    size_t ran = 0;
+    while (current_ < tick) {
+        // 直接跳到下一个需要处理的 tick
+        int64_t dist = ticksUntilNextExpiry();
+        if (dist < 0 || current_ + static_cast<uint64_t>(dist) > tick) {
+            current_ = tick;
+            break;
+        }
+        current_ += static_cast<uint64_t>(dist);
+
+        // 高层先级联，低位全为 0 时该层的当前槽到期
+        for (int level = kLevels - 1; level > 0; --level) {
+            uint64_t mask = (uint64_t(1) << shift(level)) - 1;
+            if ((current_ & mask) == 0) cascade(level);
+        }
+        ran += expire(invoke);
+    }
+    return ran;
+}
+
+int64_t TimerWheel::ticksUntilNextExpiry() const {
+    int64_t best = -1;
+    if (levelCount_[0] > 0) {
+        int from = static_cast<int>((current_ + 1) & (kRootSlots - 1));
+        int slot = findNextSet(bitmap_, kRootSlots, from);
+        assert(slot >= 0);
+        best = static_cast<int64_t>(
+                   (static_cast<uint64_t>(slot) - current_ - 1) &
+                   (kRootSlots - 1)) +
+               1;
+    }
+    for (int level = 1; level < kLevels; ++level) {
+        if (levelCount_[level] == 0) continue;
+        const uint64_t* words = &bitmap_[(kRootSlots >> 6) + level - 1];
+        uint64_t block = current_ >> shift(level);
+        int cur = static_cast<int>(block & (kLevelSlots - 1));
+        int from = (cur + 1) & (kLevelSlots - 1);
+        int slot = findNextSet(words, kLevelSlots, from);
+        assert(slot >= 0);
+        uint64_t steps = ((slot - cur - 1) & (kLevelSlots - 1)) + 1;
+        auto dist = static_cast<int64_t>(((block + steps) << shift(level)) -
+                                         current_);
+        if (best < 0 || dist < best) best = dist;
+    }
+    return best;
+}
+
+uint32_t TimerWheel::allocNode() {
+    if (freeList_ != kNil) {
+        uint32_t index = freeList_;
+        freeList_ = nodes_[index].next;
+        return index;
+    }
+    assert(nodes_.size() < kNil);
+    nodes_.emplace_back();
+    return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+void TimerWheel::freeNode(uint32_t index) {
+    Node& node = nodes_[index];
+    node.cb = nullptr;
+    node.state = State::kFree;
+    ++node.generation;  // 使旧的 TimerId 失效
+    node.next = freeList_;
+    freeList_ = index;
+}
+
+void TimerWheel::place(uint32_t index) {
+    uint64_t expire = std::max(nodes_[index].expire, current_);
+    uint64_t delta = expire - current_;
+    if (delta < static_cast<uint64_t>(kRootSlots)) {
+        link(index, static_cast<int>(expire & (kRootSlots - 1)));
+        return;
+    }
+
+    // 超出时间轮范围的定时器暂放在最高层，级联时按真实到期时间重新放置
+    const uint64_t kMaxDelta = (uint64_t(1) << shift(kLevels)) - 1;
+    if (delta > kMaxDelta) {
+        expire = current_ + kMaxDelta;
+        delta = kMaxDelta;
+    }
+    int level = 1;
+    while (delta >= (uint64_t(1) << shift(level + 1))) ++level;
+    int slot = kRootSlots + (level - 1) * kLevelSlots +
+               static_cast<int>((expire >> shift(level)) & (kLevelSlots - 1));
+    link(index, slot);
+}
+
+void TimerWheel::link(uint32_t index, int slot) {
+    Node& node = nodes_[index];
+    node.state = State::kPending;
+    node.slot = static_cast<uint16_t>(slot);
+    node.prev = kNil;
+    node.next = heads_[slot];
+    if (node.next != kNil) nodes_[node.next].prev = index;
+    heads_[slot] = index;
+    bitmap_[slot >> 6] |= uint64_t(1) << (slot & 63);
+    ++levelCount_[levelOf(slot)];
+}
+
+void TimerWheel::unlink(uint32_t index) {
+    Node& node = nodes_[index];
+    int slot = node.slot;
+    if (node.prev != kNil) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        heads_[slot] = node.next;
+    }
+    if (node.next != kNil) nodes_[node.next].prev = node.prev;
+    node.prev = node.next = kNil;
+    if (heads_[slot] == kNil) {
+        bitmap_[slot >> 6] &= ~(uint64_t(1) << (slot & 63));
+    }
+    --levelCount_[levelOf(slot)];
+}
+
+void TimerWheel::cascade(int level) {
+    int slot = kRootSlots + (level - 1) * kLevelSlots +
+               static_cast<int>((current_ >> shift(level)) & (kLevelSlots - 1));
+    while (heads_[slot] != kNil) {
+        uint32_t index = heads_[slot];
+        unlink(index);
+        place(index);
+    }
+}
+
+size_t TimerWheel::expire(const Invoker& invoke) {
+    int slot = static_cast<int>(current_ & (kRootSlots - 1));
+    size_t ran = 0;
+    // 每次从链表头取出一个，回调中可以安全地添加或取消其他定时器
+    while (heads_[slot] != kNil) {
+        uint32_t index = heads_[slot];
+        unlink(index);
+        if (nodes_[index].expire > current_) {  // 暂放的远期定时器
+            place(index);
+            continue;
+        }
+
+        // 一次性定时器开始执行即视为到期，回调中 size() 已不包含它
+        const bool periodic = nodes_[index].interval > 0;
+        if (!periodic) --size_;
+        // 回调执行期间 nodes_ 可能扩容，回调移出节点之后再调用
+        nodes_[index].state = State::kRunning;
+        Callback cb = std::move(nodes_[index].cb);
+        if (invoke) {
+            invoke(cb);
+        } else {
+            cb();
+        }
+        ++ran;
+
+        Node& node = nodes_[index];
+        if (node.state == State::kRunning && periodic) {
+            node.cb = std::move(cb);
+            // 落后超过一个周期时跳过错过的执行
+            node.expire += node.interval;
+            if (node.expire <= current_) node.expire = current_ + node.interval;
+            place(index);
+        } else {
+            if (periodic) --size_;
+            freeNode(index);
+        }
+    }
+    return ran;
+}
+
+/// NOTE ----------- TimerScheduler -----------
+TimerScheduler::TimerScheduler(const std::string& name, int64_t resolutionUs)
+    : resolutionNs_(std::max<int64_t>(resolutionUs, 1) * 1000),
+      startNs_(monotonicNs()),
+      running_(false),
+      mutex_("TimerScheduler"),
+      sleepUntil_(UINT64_MAX),
+      wakeup_(0),
+      thread_(std::bind(&TimerScheduler::threadFunc, this), name) {}
+
+TimerScheduler::~TimerScheduler() {
+    if (running_) stop();
+}
+
+void TimerScheduler::start() {
+    assert(!running_);
+    running_ = true;
+    thread_.start(false);
+}
+
+void TimerScheduler::stop() {
+    running_ = false;
+    wakeup_.fetch_add(1, std::memory_order_release);
+    Futex::wake(&wakeup_);
+    thread_.join();
+}
+
+TimerId TimerScheduler::runAt(Timestamp time, Callback cb) {
+    return add(timeDifference(time, Timestamp::now()), std::move(cb), 0);
+}
+
+TimerId TimerScheduler::runAfter(double delay, Callback cb) {
+    return add(delay, std::move(cb), 0);
+}
+
+TimerId TimerScheduler::runEvery(double interval, Callback cb) {
+    return add(interval, std::move(cb), interval);
+}
+
+bool TimerScheduler::cancel(TimerId id) {
+    FastMutexGuard lock(mutex_);
+    return wheel_.cancel(id);
+}
+
+size_t TimerScheduler::size() const {
+    FastMutexGuard lock(mutex_);
+    return wheel_.size();
+}
+
+uint64_t TimerScheduler::nowTick() const {
+    return static_cast<uint64_t>((monotonicNs() - startNs_) / resolutionNs_);
+}
+
+TimerId TimerScheduler::add(double delay, Callback cb, double interval) {
+    TimerId id;
+    bool notify = false;
+    {
+        FastMutexGuard lock(mutex_);
+        // 调度线程可能落后于当前时间，按真实时间计算相对时间轮的延迟；
+        // 向上取整，定时器不会提前执行
+        int64_t deadlineNs = monotonicNs() - startNs_ +
+                             static_cast<int64_t>(std::max(delay, 0.0) * 1e9);
+        uint64_t target = static_cast<uint64_t>(
+            (deadlineNs + resolutionNs_ - 1) / resolutionNs_);
+        uint64_t current = wheel_.currentTick();
+        uint64_t ticks = target > current ? target - current : 1;
+        id = wheel_.add(ticks, std::move(cb),
+                        TimerWheel::periodTicks(interval, resolutionNs_));
+        // 早于调度线程休眠的截止时间才需要唤醒
+        if (current + ticks < sleepUntil_) {
+            sleepUntil_ = current + ticks;
+            notify = true;
+        }
+    }
+    if (notify) {
+        wakeup_.fetch_add(1, std::memory_order_release);
+        Futex::wake(&wakeup_, 1);
+    }
+    return id;
+}
+
+void TimerScheduler::threadFunc() {
+    TimerWheel::Invoker invoke = [this](TimerWheel::Callback& cb) {
+        mutex_.unlock();
+        cb();
+        mutex_.lock();
+    };
+
+    mutex_.lock();
+    while (running_.load(std::memory_order_acquire)) {
+        // 处理到期定时器期间不需要被唤醒
+        sleepUntil_ = 0;
+        wheel_.advance(nowTick(), invoke);
+
+        int64_t dist = wheel_.ticksUntilNextExpiry();
+        int64_t timeoutNs = -1;
+        if (dist < 0) {
+            sleepUntil_ = UINT64_MAX;
+        } else {
+            sleepUntil_ = wheel_.currentTick() + static_cast<uint64_t>(dist);
+            timeoutNs = startNs_ +
+                        static_cast<int64_t>(sleepUntil_) * resolutionNs_ -
+                        monotonicNs();
+        }
+        uint32_t key = wakeup_.load(std::memory_order_acquire);
+        // stop() 先清除 running_ 再递增 wakeup_: key 已包含这次递增时必然看到
+        // running_ 为 false，否则 Futex::wait 会因值不等或被唤醒而返回
+        if (!running_.load(std::memory_order_acquire)) break;
+        mutex_.unlock();
+
+        if (dist < 0 || timeoutNs > 0) Futex::wait(&wakeup_, key, timeoutNs);
+        mutex_.lock();
+    }
+    mutex_.unlock();
+}
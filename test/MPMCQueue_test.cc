@@ -0,0 +1,106 @@
+#include <Base/MPMCQueue.h>
+#include <Base/MTQueue.h>
+#include <Base/utils.h>
+
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+void testBasic() {
+    Lute::MPMCQueue<std::unique_ptr<int>> que(5);
+    assert(que.capacity() == 8);
+    assert(que.empty());
+
+    for (int i = 0; i < 8; ++i) assert(que.tryPush(std::make_unique<int>(i)));
+    assert(!que.tryPush(std::make_unique<int>(8)));
+    assert(que.sizeGuess() == 8);
+
+    std::unique_ptr<int> val;
+    for (int i = 0; i < 8; ++i) {
+        assert(que.tryPop(val));
+        assert(*val == i);  // FIFO
+    }
+    assert(!que.tryPop(val));
+
+    // 析构时释放剩余元素
+    que.push(std::make_unique<int>(42));
+}
+
+/// 多生产者 / 多消费者，小容量队列频繁在满 / 空之间切换，覆盖阻塞路径
+void testConcurrent(size_t capacity, int producers, int consumers) {
+    const int64_t kPerProducer = 200000;
+    Lute::MPMCQueue<int64_t> que(capacity);
+    std::atomic<int64_t> sum(0);
+    std::atomic<int64_t> count(0);
+    const int64_t total = kPerProducer * producers;
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&que, p, kPerProducer]() {
+            for (int64_t i = 1; i <= kPerProducer; ++i) {
+                que.push(p * kPerProducer + i);
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&]() {
+            int64_t localSum = 0;
+            while (count.fetch_add(1) < total) localSum += que.pop();
+            sum.fetch_add(localSum);
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    assert(sum == total * (total + 1) / 2);
+    assert(que.empty());
+    std::cout << "MPMCQueue capacity=" << capacity << " producers=" << producers
+              << " consumers=" << consumers << " ok" << std::endl;
+}
+
+void benchmark() {
+    const int kThreads = 4;
+    const int kOps = 1000000;
+
+    Lute::MPMCQueue<int> mpmc(1024);
+    PING(MPMCQueue);
+    {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&]() {
+                for (int i = 0; i < kOps; ++i) mpmc.push(i);
+            });
+            threads.emplace_back([&]() {
+                for (int i = 0; i < kOps; ++i) mpmc.pop();
+            });
+        }
+        for (auto& t : threads) t.join();
+    }
+    PONG(MPMCQueue);
+
+    Lute::MTQueue<int> mtq;
+    PING(MTQueue);
+    {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t) {
+            threads.emplace_back([&]() {
+                for (int i = 0; i < kOps; ++i) mtq.push(i);
+            });
+            threads.emplace_back([&]() {
+                for (int i = 0; i < kOps; ++i) mtq.pop();
+            });
+        }
+        for (auto& t : threads) t.join();
+    }
+    PONG(MTQueue);
+}
+
+int main() {
+    testBasic();
+    testConcurrent(2, 1, 1);
+    testConcurrent(4, 4, 4);
+    testConcurrent(1024, 3, 5);
+    benchmark();
+    return 0;
+}
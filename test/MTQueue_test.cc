@@ -2,13 +2,92 @@
 #include <Base/utils.h>
 
 #include <atomic>
+#include <cassert>
+#include <chrono>
 #include <iostream>
 #include <thread>
+#include <vector>
 
 std::atomic_int count(0);
 Lute::MTQueue<int> que;
 
+void testBatchAndClose() {
+    Lute::MTQueue<int> q;
+    for (int i = 0; i < 10; ++i) assert(q.push(i));
+    assert(q.size() == 10);
+
+    int v = -1;
+    assert(q.tryPop(v) && v == 9);  // pop 从尾部取
+    auto first = q.popUpTo(3);
+    assert((first == std::vector<int>{0, 1, 2}));  // 按入队顺序
+    auto rest = q.popAll();
+    assert((rest == std::vector<int>{3, 4, 5, 6, 7, 8}));
+    assert(q.empty() && !q.tryPop(v));
+
+    auto begin = std::chrono::steady_clock::now();
+    assert(!q.popFor(v, std::chrono::milliseconds(20)));
+    assert(std::chrono::steady_clock::now() - begin >=
+           std::chrono::milliseconds(20));
+
+    // close 唤醒阻塞中的消费者，剩余元素仍可取完
+    std::atomic_int drained(0);
+    std::vector<std::thread> consumers;
+    for (int i = 0; i < 4; ++i) {
+        consumers.emplace_back([&q, &drained]() {
+            for (;;) {
+                auto batch = q.popUpTo(16);
+                if (batch.empty()) break;
+                drained.fetch_add(static_cast<int>(batch.size()));
+            }
+        });
+    }
+    for (int i = 0; i < 1000; ++i) q.push(i);
+    q.close();
+    for (auto& t : consumers) t.join();
+    assert(drained == 1000);
+    assert(q.closed() && !q.push(1) && !q.pushMany({1, 2}));
+    assert(!q.pop(v));
+    assert(!q.popFor(v, std::chrono::seconds(10)));
+
+    bool thrown = false;
+    try {
+        q.pop();
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+}
+
+/// 没有默认构造函数的元素
+struct NoDefault {
+    explicit NoDefault(int v) : value(v) {}
+    int value;
+};
+
+void testPopUpTo() {
+    Lute::MTQueue<NoDefault> q;
+    for (int i = 0; i < 10; ++i) q.push(NoDefault(i));
+    assert(q.pop().value == 9);
+
+    // 连续的小批量保持入队顺序，队首空位压缩后顺序不变
+    int next = 0;
+    for (int round = 0; round < 3; ++round) {
+        auto batch = q.popUpTo(2);
+        assert(batch.size() == 2);
+        for (const auto& item : batch) assert(item.value == next++);
+    }
+    assert(q.size() == 3);
+    q.push(NoDefault(100));
+    assert(q.pop().value == 100);
+    assert(q.pop().value == 8);
+    auto rest = q.popAll();
+    assert(rest.size() == 2 && rest[0].value == 6 && rest[1].value == 7);
+    assert(q.empty());
+}
+
 int main() {
+    testBatchAndClose();
+    testPopUpTo();
     int c = 0;
     PING(testMTQ);
     for (int i = 0; i < 1e4; ++i) {
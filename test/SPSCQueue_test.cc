@@ -0,0 +1,121 @@
+#include <Base/SPSCQueue.h>
+#include <Base/utils.h>
+#include <pthread.h>  // pthread_setaffinity_np
+#include <unistd.h>   // sysconf
+
+#include <cassert>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// 两个线程分别绑定到不同的核 (只有一个核时不绑定)
+void pinTo(int cpu) {
+    if (::sysconf(_SC_NPROCESSORS_ONLN) < 2) return;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    ::pthread_setaffinity_np(::pthread_self(), sizeof(set), &set);
+}
+
+void testBasic() {
+    Lute::SPSCQueue<std::string> que(3);
+    assert(que.capacity() == 4);
+    assert(que.empty());
+
+    std::vector<std::string> in = {"a", "b", "c", "d", "e"};
+    assert(que.pushMany(in.begin(), in.size()) == 4);
+    assert(!que.tryPush("f"));
+    assert(que.sizeGuess() == 4);
+
+    std::string val;
+    assert(que.tryPop(val) && val == "a");
+    std::vector<std::string> out(8);
+    assert(que.popMany(out.begin(), out.size()) == 3);
+    assert(out[0] == "b" && out[1] == "c" && out[2] == "d");
+    assert(!que.tryPop(val));
+
+    // 回绕之后仍然保持 FIFO
+    for (int round = 0; round < 10; ++round) {
+        assert(que.tryEmplace(3, 'x'));
+        assert(que.tryPush(std::to_string(round)));
+        assert(que.tryPop(val) && val == "xxx");
+        assert(que.tryPop(val) && val == std::to_string(round));
+    }
+
+    // 析构时释放剩余元素
+    Lute::SPSCQueue<std::unique_ptr<int>> owner(4);
+    owner.tryPush(std::make_unique<int>(1));
+}
+
+void testBlocking() {
+    const uint64_t kCount = 2000000;
+    Lute::SPSCQueue<uint64_t, true> que(64);
+    uint64_t sum = 0;
+
+    std::thread consumer([&]() {
+        pinTo(1);
+        uint64_t expect = 0;
+        uint64_t buf[32];
+        while (expect < kCount) {
+            if (expect % 2 == 0) {
+                uint64_t v = que.pop();
+                assert(v == expect);
+                sum += v;
+                ++expect;
+            } else {
+                size_t n = que.popMany(buf, 32);
+                for (size_t i = 0; i < n; ++i, ++expect) {
+                    assert(buf[i] == expect);
+                    sum += buf[i];
+                }
+            }
+        }
+    });
+
+    pinTo(0);
+    for (uint64_t i = 0; i < kCount; ++i) que.push(i);
+    consumer.join();
+
+    assert(sum == kCount * (kCount - 1) / 2);
+    assert(que.empty());
+    std::cout << "SPSCQueue blocking ok" << std::endl;
+}
+
+void benchmark() {
+    const uint64_t kCount = 20000000;
+    const size_t kBatch = 64;
+    Lute::SPSCQueue<uint64_t> que(4096);
+
+    PING(SPSCQueue);
+    std::thread consumer([&]() {
+        pinTo(1);
+        uint64_t buf[kBatch];
+        uint64_t received = 0;
+        while (received < kCount) {
+            size_t n = que.popMany(buf, kBatch);
+            if (n == 0) std::this_thread::yield();
+            received += n;
+        }
+    });
+
+    pinTo(0);
+    uint64_t buf[kBatch];
+    for (uint64_t sent = 0; sent < kCount;) {
+        size_t n = std::min<uint64_t>(kBatch, kCount - sent);
+        for (size_t i = 0; i < n; ++i) buf[i] = sent + i;
+        size_t pushed = que.pushMany(buf, n);
+        if (pushed == 0) std::this_thread::yield();
+        sent += pushed;
+    }
+    consumer.join();
+    PONG(SPSCQueue);
+}
+
+int main() {
+    testBasic();
+    testBlocking();
+    benchmark();
+    return 0;
+}
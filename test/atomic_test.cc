@@ -1,6 +1,97 @@
 #include <Base/atomic.h>
+#include <Base/thread.h>
+#include <Base/utils.h>
 #include <assert.h>
+
 #include <atomic>
+#include <memory>
+#include <vector>
+
+const int kThreads = 4;
+const int kCount = 1000 * 1000;
+
+/// 多个线程各自递增相邻的计数器
+template <typename Counter>
+void hammer(Counter* counters) {
+    std::vector<std::unique_ptr<Lute::Thread>> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back(new Lute::Thread([counters, i]() {
+            for (int j = 0; j < kCount; ++j) {
+                counters[i].fetch_add(1, std::memory_order_relaxed);
+            }
+        }));
+        threads.back()->start();
+    }
+    for (auto& thr : threads) thr->join();
+}
+
+void testPadded() {
+    static_assert(sizeof(Lute::PaddedAtomic<int64_t>) == LUTE_CACHELINE_SIZE,
+                  "PaddedAtomic occupies a cache line");
+    Lute::PaddedAtomic<int64_t> a(5);
+    a = 7;
+    assert(a.load() == 7);
+    assert(++a == 8);
+
+    std::unique_ptr<std::atomic<int64_t>[]> packed(
+        new std::atomic<int64_t>[kThreads]());
+    std::unique_ptr<Lute::PaddedAtomic<int64_t>[]> padded(
+        new Lute::PaddedAtomic<int64_t>[kThreads]);
+    for (int i = 0; i < kThreads; ++i) assert(padded[i].load() == 0);
+
+    PING(packedAtomic);
+    hammer(packed.get());
+    PONG(packedAtomic);
+
+    PING(paddedAtomic);
+    hammer(padded.get());
+    PONG(paddedAtomic);
+
+    for (int i = 0; i < kThreads; ++i) {
+        assert(packed[i].load() == kCount && padded[i].load() == kCount);
+    }
+}
+
+void testStriped() {
+    Lute::StripedCounter counter(3);
+    assert(counter.stripes() == 4);
+    counter.add(10);
+    counter.decrement();
+    assert(counter.value() == 9);
+    counter.reset();
+    assert(counter.value() == 0);
+
+    Lute::StripedCounter striped;
+    Lute::AtomicInt64 shared;
+    std::vector<std::unique_ptr<Lute::Thread>> threads;
+
+    PING(sharedAtomic);
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back(new Lute::Thread([&shared]() {
+            for (int j = 0; j < kCount; ++j) {
+                shared.increment(std::memory_order_relaxed);
+            }
+        }));
+        threads.back()->start();
+    }
+    for (auto& thr : threads) thr->join();
+    PONG(sharedAtomic);
+
+    threads.clear();
+    PING(stripedCounter);
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back(new Lute::Thread([&striped]() {
+            for (int j = 0; j < kCount; ++j) striped.increment();
+        }));
+        threads.back()->start();
+    }
+    for (auto& thr : threads) thr->join();
+    PONG(stripedCounter);
+
+    assert(shared.get(std::memory_order_relaxed) ==
+           int64_t(kThreads) * kCount);
+    assert(striped.value() == int64_t(kThreads) * kCount);
+}
 
 int main() {
     {
@@ -43,4 +134,23 @@ int main() {
         assert(0 == a1.fetch_add(-1));
         assert(a2.get() == a1.load());
     }
+
+    {
+        // 显式内存序
+        Lute::AtomicInt64 a3(10);
+        assert(a3.get(std::memory_order_relaxed) == 10);
+        a3.set(20);
+        assert(a3.get() == 20);
+        a3.add(5, std::memory_order_relaxed);
+        assert(a3.incrementAndGet(std::memory_order_acq_rel) == 26);
+
+        int64_t expected = 0;
+        assert(!a3.compareAndSet(expected, 1));
+        assert(expected == 26);
+        assert(a3.compareAndSet(expected, 1));
+        assert(a3.get() == 1);
+    }
+
+    testPadded();
+    testStriped();
 }
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include <Base/barrier.h>
+#include <Base/countDownLatch.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace Lute;
+
+void testLatch() {
+    CountDownLatch latch(3);
+    assert(latch.getCount() == 3);
+    // 计数未归零时限时等待超时
+    assert(!latch.waitFor(1000 * 1000));
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 3; ++i) {
+        threads.emplace_back([&latch]() { latch.countDown(); });
+    }
+    latch.wait();
+    assert(latch.getCount() == 0);
+    for (auto& t : threads) t.join();
+
+    // 已为零时 countDown 不变，wait 立即返回
+    latch.countDown();
+    assert(latch.getCount() == 0);
+    assert(latch.waitFor(0));
+
+    // 多个等待者
+    CountDownLatch gate(1);
+    std::atomic<int> passed(0);
+    for (auto& t : threads) {
+        t = std::thread([&]() {
+            gate.wait();
+            passed.fetch_add(1);
+        });
+    }
+    gate.countDown();
+    for (auto& t : threads) t.join();
+    assert(passed.load() == 3);
+}
+
+void testEvent() {
+    Event event;
+    assert(!event.isSet());
+    assert(!event.waitFor(1000 * 1000));
+
+    std::atomic<int> woken(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&]() {
+            event.wait();
+            woken.fetch_add(1);
+        });
+    }
+    event.set();
+    for (auto& t : threads) t.join();
+    assert(woken.load() == 4);
+    assert(event.isSet());
+    assert(event.waitFor(0));
+
+    event.reset();
+    assert(!event.isSet());
+    assert(Event(true).isSet());
+}
+
+void testCyclicBarrier() {
+    const int kThreads = 4;
+    const int kPhases = 1000;
+    int completions = 0;
+    std::atomic<int> counter(0);
+    bool ok = true;
+    // 完成回调在唤醒其他线程之前执行，看到的是本阶段全部线程的结果
+    CyclicBarrier barrier(kThreads, [&]() {
+        ++completions;
+        if (counter.load() != completions * kThreads) ok = false;
+    });
+    assert(barrier.parties() == kThreads);
+
+    std::atomic<int> lastArrivers(0);
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&]() {
+            for (int phase = 0; phase < kPhases; ++phase) {
+                counter.fetch_add(1);
+                if (barrier.arriveAndWait()) lastArrivers.fetch_add(1);
+                // 所有线程都已越过本阶段
+                if (counter.load() < (phase + 1) * kThreads) ok = false;
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+    assert(ok);
+    assert(completions == kPhases);
+    assert(lastArrivers.load() == kPhases);
+    assert(barrier.generation() == static_cast<uint32_t>(kPhases));
+}
+
+int main() {
+    testLatch();
+    testEvent();
+    testCyclicBarrier();
+    printf("barrier test passed\n");
+    return 0;
+}
@@ -1,6 +1,8 @@
 #include <Base/bytearray.h>
 
+#include <iomanip>
 #include <iostream>
+#include <sstream>
 
 void test() {
 #define XX(type, len, writeFun, readFun, baseLen)                      \
@@ -86,8 +88,175 @@ void test() {
 #undef XX
 }
 
+void testMmap() {
+    const char* filename = "/tmp/bytearray_mmap_test.dat";
+    std::vector<int32_t> vec;
+    Lute::ByteArray::ptr ba(new Lute::ByteArray(7));
+    for (int i = 0; i < 1000; ++i) {
+        vec.push_back(rand());
+        ba->writeFint32(vec.back());
+    }
+    ba->writeStringF32("Lute");
+    ba->writeUint64(1234567890123ull);
+    ba->setPosition(0);
+    assert(ba->writeToFile(filename));
+
+    Lute::ByteArray::ptr mapped(new Lute::ByteArray(7));
+    assert(mapped->mmapFromFile(filename));
+    assert(mapped->isMapped());
+    assert(mapped->size() == ba->size());
+    assert(mapped->advise(Lute::ByteArray::Advice::SEQUENTIAL));
+    assert(mapped->advise(Lute::ByteArray::Advice::WILLNEED, 1000, 2000));
+    assert(mapped->toString() == ba->toString());
+    for (size_t i = 0; i < vec.size(); ++i) {
+        assert(mapped->readFint32() == vec[i]);
+    }
+    assert(mapped->readStringF32() == "Lute");
+    assert(mapped->readUint64() == 1234567890123ull);
+    assert(mapped->readableSize() == 0);
+
+    bool thrown = false;
+    try {
+        mapped->writeFint8(1);
+    } catch (const std::logic_error&) {
+        thrown = true;
+    }
+    assert(thrown);
+
+    mapped->clear();
+    assert(!mapped->isMapped());
+    assert(mapped->baseSize() == 7);
+    mapped->writeFint32(42);
+    mapped->setPosition(0);
+    assert(mapped->readFint32() == 42);
+    std::cout << "mmapFromFile size=" << ba->size() << std::endl;
+}
+
+void testDiscardRead(bool ring) {
+    Lute::ByteArray ba(16);
+    ba.setRingBuffer(ring);
+
+    uint32_t produced = 0;
+    uint32_t consumed = 0;
+    size_t readPos = 0;
+    size_t maxCapacity = 0;
+    for (int round = 0; round < 10000; ++round) {
+        // 写入追加到尾部
+        ba.setPosition(ba.size());
+        for (int i = 0; i < 10; ++i) ba.writeFuint32(produced++);
+
+        // 从头部消费，始终比生产者落后 5 个
+        ba.setPosition(readPos);
+        while (produced - consumed > 5) {
+            assert(ba.readFuint32() == consumed++);
+        }
+        readPos = ba.position();
+
+        size_t discarded = ba.discardRead();
+        assert(discarded % ba.baseSize() == 0);
+        readPos -= discarded;
+        assert(ba.position() == readPos);
+        maxCapacity = std::max(maxCapacity, ba.capacity());
+    }
+    assert(maxCapacity <= 16 * 6);
+
+    ba.setPosition(readPos);
+    while (consumed < produced) assert(ba.readFuint32() == consumed++);
+    size_t capacity = ba.capacity();
+    ba.clear();
+    assert(ba.capacity() == (ring ? capacity : 16));
+    std::cout << "discardRead ring=" << ring << " maxCapacity=" << maxCapacity
+              << std::endl;
+}
+
+void testHexString() {
+    for (size_t len : {0, 1, 31, 32, 33, 64, 100, 1000}) {
+        Lute::ByteArray ba(7);
+        std::stringstream ss;
+        for (size_t i = 0; i < len; ++i) {
+            auto v = static_cast<uint8_t>(rand());
+            ba.writeFuint8(v);
+            if (i > 0 && i % 32 == 0) ss << std::endl;
+            ss << std::setw(2) << std::setfill('0') << std::hex
+               << static_cast<int>(v) << " ";
+        }
+        ba.setPosition(0);
+        assert(ba.toHexString() == ss.str());
+    }
+}
+
+template <typename T>
+void checkArray(size_t count) {
+    std::vector<T> vec(count);
+    for (auto& v : vec) v = static_cast<T>(rand() * 1234567ull + rand());
+
+    // 编译期字节序与运行时字节序的编码结果一致
+    Lute::BigEndianByteArray be(13);
+    Lute::ByteArray rt(13);
+    rt.setLittleEndian(false);
+    be.writeArray(vec.data(), vec.size());
+    for (auto v : vec) rt.writeArray(&v, 1);
+    be.setPosition(0);
+    rt.setPosition(0);
+    assert(be.toString() == rt.toString());
+
+    // 逐个元素 byteswap 后与 writeArray 的批量 byteswap 一致
+    std::string expect;
+    for (auto v : vec) {
+        std::string bytes(reinterpret_cast<const char*>(&v), sizeof(T));
+        expect.append(bytes.rbegin(), bytes.rend());
+    }
+    assert(be.toString() == expect);
+
+    std::vector<T> out(count);
+    be.readArray(out.data(), out.size());
+    assert(out == vec);
+    assert(be.readableSize() == 0);
+
+    Lute::LittleEndianByteArray le(13);
+    le.writeArray(vec.data(), vec.size());
+    le.setPosition(0);
+    assert(le.toString() == std::string(reinterpret_cast<const char*>(
+                                            vec.data()),
+                                        count * sizeof(T)));
+}
+
+void testEndianPolicy() {
+    static_assert(!Lute::LittleEndianByteArray::needSwap(), "");
+    static_assert(Lute::BigEndianByteArray::needSwap(), "");
+
+    Lute::BigEndianByteArray be(3);
+    be.writeFuint32(0x12345678);
+    be.writeFint16(-2);
+    be.writeDouble(1.5);
+    be.setPosition(0);
+    assert(be.toHexString() ==
+           "12 34 56 78 ff fe 3f f8 00 00 00 00 00 00 ");
+    assert(be.readFuint32() == 0x12345678);
+    assert(be.readFint16() == -2);
+    assert(be.readDouble() == 1.5);
+
+    Lute::LittleEndianByteArray le(3);
+    le.writeFuint32(0x12345678);
+    le.setPosition(0);
+    assert(le.toHexString() == "78 56 34 12 ");
+
+    for (size_t count : {0, 1, 7, 8, 9, 33, 1000, 5000}) {
+        checkArray<uint16_t>(count);
+        checkArray<int32_t>(count);
+        checkArray<float>(count);
+        checkArray<uint64_t>(count);
+        checkArray<double>(count);
+    }
+}
+
 int main() {
     test();
+    testEndianPolicy();
+    testHexString();
+    testMmap();
+    testDiscardRead(false);
+    testDiscardRead(true);
     Lute::ByteArray::ptr ba(new Lute::ByteArray(10));
 
     ba->writeFloat(1.234f);
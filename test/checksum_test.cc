@@ -0,0 +1,52 @@
+#include <Base/bytearray.h>
+#include <Base/checksum.h>
+#include <Base/utils.h>
+
+#include <cassert>
+#include <iostream>
+#include <string>
+
+int main() {
+    // 标准测试向量
+    assert(Lute::crc32c("", 0) == 0);
+    assert(Lute::crc32c("123456789", 9) == 0xE3069283);
+    assert(Lute::XXHash64::hash("", 0) == 0xEF46DB3751D8E999ULL);
+    assert(Lute::XXHash64::hash("a", 1) == 0xD24EC4F1A98C6E5BULL);
+
+    std::string data;
+    for (int i = 0; i < 100000; ++i) data.push_back(static_cast<char>(rand()));
+
+    // 流式计算与一次性计算结果一致
+    uint32_t crc = 0;
+    Lute::XXHash64 hasher(42);
+    for (size_t pos = 0, step = 1; pos < data.size(); pos += step, ++step) {
+        size_t n = std::min(step, data.size() - pos);
+        crc = Lute::crc32c(data.data() + pos, n, crc);
+        hasher.update(data.data() + pos, n);
+    }
+    assert(crc == Lute::crc32c(data.data(), data.size()));
+    assert(hasher.digest() == Lute::XXHash64::hash(data.data(), data.size(), 42));
+
+    // ByteArray 沿内存块链表计算，结果与连续内存一致
+    Lute::ByteArray ba(333);
+    ba.write(data.data(), data.size());
+    ba.setPosition(7);
+    assert(ba.crc32c() == Lute::crc32c(data.data() + 7, data.size() - 7));
+    assert(ba.xxhash64() ==
+           Lute::XXHash64::hash(data.data() + 7, data.size() - 7));
+
+    const int kRounds = 1000;
+    PING(crc32c);
+    for (int i = 0; i < kRounds; ++i) {
+        crc = Lute::crc32c(data.data(), data.size(), crc);
+    }
+    PONG(crc32c);
+    PING(xxhash64);
+    uint64_t h = 0;
+    for (int i = 0; i < kRounds; ++i) {
+        h ^= Lute::XXHash64::hash(data.data(), data.size(), i);
+    }
+    PONG(xxhash64);
+    std::cout << crc << " " << h << std::endl;
+    return 0;
+}
@@ -0,0 +1,131 @@
+#include <Base/concurrentHashMap.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Lute;
+
+void testBasic() {
+    ConcurrentHashMap<std::string, int> map(4);
+    assert(map.empty());
+    assert(map.shardCount() == 4);
+    assert(map.insertOrAssign("a", 1));
+    assert(map.insertOrAssign("b", 2));
+    assert(!map.insertOrAssign("a", 10));
+    assert(map.size() == 2);
+
+    int value = 0;
+    assert(map.find("a", &value) && value == 10);
+    assert(map.find("b", &value) && value == 2);
+    assert(!map.find("c", &value));
+    assert(map.contains("b"));
+
+    assert(map.erase("a"));
+    assert(!map.erase("a"));
+    assert(!map.contains("a"));
+    assert(map.size() == 1);
+
+    // 墓碑被复用
+    assert(map.insertOrAssign("a", 3));
+    assert(map.find("a", &value) && value == 3);
+
+    map.clear();
+    assert(map.empty());
+    assert(!map.contains("b"));
+}
+
+void testRehash() {
+    ConcurrentHashMap<int, int> map(2, 8);
+    std::map<int, int> expected;
+    const int kKeys = 10000;
+    for (int i = 0; i < kKeys; ++i) {
+        map.insertOrAssign(i, i * 3);
+        expected[i] = i * 3;
+    }
+    // 反复删除、插入，墓碑积累之后原大小重建
+    for (int round = 0; round < 5; ++round) {
+        for (int i = 0; i < kKeys; i += 2) {
+            assert(map.erase(i));
+            expected.erase(i);
+        }
+        for (int i = 0; i < kKeys; i += 2) {
+            map.insertOrAssign(i, i + round);
+            expected[i] = i + round;
+        }
+    }
+    assert(map.size() == expected.size());
+
+    std::map<int, int> seen;
+    map.forEach([&seen](const int& key, const int& value) {
+        assert(seen.count(key) == 0);
+        seen[key] = value;
+    });
+    assert(seen == expected);
+    for (const auto& kv : expected) {
+        int value = -1;
+        assert(map.find(kv.first, &value) && value == kv.second);
+    }
+}
+
+void testConcurrent() {
+    ConcurrentHashMap<int, std::string> map;
+    const int kWriters = 2;
+    const int kReaders = 2;
+    const int kKeys = 2000;
+    const int kRounds = 20;
+    std::atomic<bool> done(false);
+    std::atomic<int64_t> hits(0);
+
+    std::vector<std::thread> threads;
+    for (int w = 0; w < kWriters; ++w) {
+        threads.emplace_back([&map, w]() {
+            // 每个写者负责一半的键
+            for (int round = 0; round < kRounds; ++round) {
+                for (int i = w; i < kKeys; i += kWriters) {
+                    map.insertOrAssign(i, std::to_string(i));
+                }
+                for (int i = w; i < kKeys; i += 2 * kWriters) map.erase(i);
+            }
+        });
+    }
+    for (int r = 0; r < kReaders; ++r) {
+        threads.emplace_back([&]() {
+            while (!done.load(std::memory_order_relaxed)) {
+                for (int i = 0; i < kKeys; ++i) {
+                    std::string value;
+                    // 读到的值必须完整
+                    if (map.find(i, &value)) {
+                        assert(value == std::to_string(i));
+                        hits.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+        });
+    }
+    for (int w = 0; w < kWriters; ++w) threads[w].join();
+    done = true;
+    for (size_t i = kWriters; i < threads.size(); ++i) threads[i].join();
+
+    // 最后一轮删除了每个写者负责的一半
+    assert(map.size() == kKeys / 2);
+    size_t count = 0;
+    map.forEach([&count](const int& key, const std::string& value) {
+        assert(value == std::to_string(key));
+        ++count;
+    });
+    assert(count == kKeys / 2);
+    printf("concurrent: %lld hits\n", static_cast<long long>(hits.load()));
+}
+
+int main() {
+    testBasic();
+    testRehash();
+    testConcurrent();
+    printf("concurrentHashMap test passed\n");
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <Base/condition_variable.h>
+#include <Base/mutex.h>
+
+#include <cassert>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+
+using namespace Lute;
+
+MutexLock g_mutex;
+Condition g_cond(g_mutex);
+bool g_ready = false;
+
+double elapsedSince(Condition::Clock::time_point start) {
+    return std::chrono::duration<double>(Condition::Clock::now() - start)
+        .count();
+}
+
+void testTimeout() {
+    MutexLockGuard lock(g_mutex);
+    // 截止时间按 CLOCK_MONOTONIC 解释: 不会立即返回，也不会多等很久
+    auto start = Condition::Clock::now();
+    assert(g_cond.waitFor(20 * 1000 * 1000));
+    double elapsed = elapsedSince(start);
+    printf("waitFor(20ms) timed out after %.4fs\n", elapsed);
+    assert(elapsed >= 0.02 && elapsed < 1.0);
+
+    start = Condition::Clock::now();
+    assert(g_cond.waitForSeconds(0.01));
+    assert(elapsedSince(start) >= 0.01);
+
+    // 已经过去的截止时间立即超时
+    assert(g_cond.waitUntil(Condition::Clock::now() -
+                            std::chrono::milliseconds(1)));
+    assert(g_mutex.isLockedByThisThread());
+
+    // 谓词形式超时返回 false
+    assert(!g_cond.waitFor(1000 * 1000, []() { return g_ready; }));
+}
+
+void testNotify() {
+    std::thread t([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        MutexLockGuard lock(g_mutex);
+        g_ready = true;
+        g_cond.notifyAll();
+    });
+    {
+        MutexLockGuard lock(g_mutex);
+        auto deadline = Condition::Clock::now() + std::chrono::seconds(10);
+        assert(g_cond.waitUntil(deadline, []() { return g_ready; }));
+        assert(g_mutex.isLockedByThisThread());
+    }
+    t.join();
+
+    MutexLockGuard lock(g_mutex);
+    // 条件已满足时不等待
+    g_cond.wait([]() { return g_ready; });
+    assert(g_cond.waitFor(0, []() { return g_ready; }));
+}
+
+int main() {
+    testTimeout();
+    testNotify();
+    printf("condition_variable test passed\n");
+    return 0;
+}
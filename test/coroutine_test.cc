@@ -0,0 +1,186 @@
+#include <Base/coroutine.h>
+
+#ifdef LUTE_HAS_COROUTINE
+
+#include <Base/countDownLatch.h>
+#include <Base/thread.h>
+#include <Base/timestamp.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace Lute;
+
+Task<int> square(int x) { co_return x* x; }
+
+Task<int> sumOfSquares(int n) {
+    int sum = 0;
+    for (int i = 1; i <= n; ++i) sum += co_await square(i);
+    co_return sum;
+}
+
+Task<void> fail() {
+    throw std::runtime_error("boom");
+    co_return;
+}
+
+void testTask() {
+    assert(syncWait(sumOfSquares(10)) == 385);
+
+    assert(syncWait(sumOfSquares(1000)) == 333833500);
+
+    bool caught = false;
+    try {
+        syncWait(fail());
+    } catch (const std::runtime_error& e) {
+        caught = std::string(e.what()) == "boom";
+    }
+    assert(caught);
+
+    // 惰性启动
+    bool started = false;
+    auto lazy = [&]() -> Task<void> {
+        started = true;
+        co_return;
+    };
+    Task<void> task = lazy();
+    assert(!started && !task.done());
+    syncWait(std::move(task));
+    assert(started);
+}
+
+Task<pid_t> tidOnPool(ThreadPool& pool) {
+    co_await schedule(pool);
+    co_return CurrentThread::tid();
+}
+
+void testThreadPool() {
+    ThreadPool pool("CoroPool");
+    pool.start(2);
+    pid_t tid = syncWait(tidOnPool(pool));
+    assert(tid != CurrentThread::tid());
+
+    // 大量并发协程在 AsyncLatch 上汇合
+    const int kTasks = 10000;
+    AsyncLatch latch(kTasks);
+    std::atomic<int> done(0);
+    auto worker = [&]() -> Task<void> {
+        co_await schedule(pool);
+        done.fetch_add(1, std::memory_order_relaxed);
+        latch.countDown();
+    };
+    for (int i = 0; i < kTasks; ++i) spawn(worker());
+    auto join = [&]() -> Task<int> {
+        co_await latch;
+        co_return done.load();
+    };
+    assert(syncWait(join()) == kTasks);
+    pool.stop();
+}
+
+void testAsyncQueue() {
+    AsyncQueue<int> queue;
+    std::vector<int> received;
+    auto consumer = [&]() -> Task<void> {
+        for (int i = 0; i < 100; ++i) received.push_back(co_await queue.pop());
+    };
+    Task<void> task = consumer();
+    queue.push(0);  // 消费者尚未开始，先入队
+    spawn(std::move(task));
+    assert(received.size() == 1);
+    // 消费者挂起等待，push 直接交给它
+    for (int i = 1; i < 100; ++i) queue.push(i);
+    assert(received.size() == 100);
+    for (int i = 0; i < 100; ++i) assert(received[i] == i);
+    assert(queue.size() == 0);
+
+    // 跨线程生产
+    AsyncQueue<std::string> strings;
+    Thread producer([&]() {
+        for (int i = 0; i < 1000; ++i) strings.push(std::to_string(i));
+    });
+    auto drain = [&]() -> Task<int> {
+        int n = 0;
+        for (int i = 0; i < 1000; ++i) {
+            std::string s = co_await strings.pop();
+            if (s == std::to_string(i)) ++n;
+        }
+        co_return n;
+    };
+    producer.start();
+    assert(syncWait(drain()) == 1000);
+    producer.join();
+}
+
+void testEventLoop() {
+    EventLoopThreadPool loops("CoroLoop");
+    loops.start(1);
+    EventLoop& loop = *loops.getNextLoop();
+
+    int fds[2];
+    assert(::pipe2(fds, O_NONBLOCK | O_CLOEXEC) == 0);
+
+    auto reader = [&]() -> Task<std::string> {
+        co_await schedule(loop);
+        assert(loop.isInLoopThread());
+        Timestamp start(Timestamp::now());
+        co_await sleepFor(loop, 0.02);
+        assert(timeDifference(Timestamp::now(), start) >= 0.02);
+
+        uint32_t events = co_await waitReadable(loop, fds[0]);
+        assert(events & EPOLLIN);
+        assert(loop.isInLoopThread());
+        char buf[64];
+        ssize_t n = ::read(fds[0], buf, sizeof(buf));
+        co_return std::string(buf, n > 0 ? n : 0);
+    };
+
+    Thread writer([&]() {
+        CurrentThread::sleepUsec(50 * 1000);
+        assert(::write(fds[1], "hello", 5) == 5);
+    });
+    writer.start();
+    assert(syncWait(reader()) == "hello");
+    writer.join();
+
+    // TimerScheduler 上的睡眠
+    TimerScheduler scheduler;
+    scheduler.start();
+    auto nap = [&]() -> Task<double> {
+        Timestamp start(Timestamp::now());
+        co_await sleepFor(scheduler, 0.01);
+        co_return timeDifference(Timestamp::now(), start);
+    };
+    assert(syncWait(nap()) >= 0.01);
+    scheduler.stop();
+
+    loops.stop();
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+int main() {
+    testTask();
+    testThreadPool();
+    testAsyncQueue();
+    testEventLoop();
+    printf("All tests passed!\n");
+    return 0;
+}
+
+#else
+
+#include <cstdio>
+
+int main() {
+    printf("coroutines are not supported by this compiler\n");
+    return 0;
+}
+
+#endif
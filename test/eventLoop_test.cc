@@ -0,0 +1,161 @@
+#include <Base/countDownLatch.h>
+#include <Base/eventLoop.h>
+#include <Base/thread.h>
+#include <Base/timestamp.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <vector>
+
+using namespace Lute;
+
+void testIo() {
+    EventLoop loop;
+    assert(EventLoop::getEventLoopOfCurrentThread() == &loop);
+    int fds[2];
+    assert(::pipe2(fds, O_NONBLOCK | O_CLOEXEC) == 0);
+
+    const int kBytes = 1 << 20;
+    int received = 0;
+    int wakeups = 0;
+    loop.addFd(fds[0], EPOLLIN, [&](uint32_t events) {
+        assert(events & EPOLLIN);
+        ++wakeups;
+        // 边沿触发: 读到 EAGAIN 为止
+        char buf[4096];
+        ssize_t n;
+        while ((n = ::read(fds[0], buf, sizeof(buf))) > 0) received += n;
+        if (received == kBytes) {
+            loop.removeFd(fds[0]);  // 在回调中移除自己
+            loop.quit();
+        }
+    });
+    assert(loop.hasFd(fds[0]));
+
+    Thread writer([&]() {
+        char buf[1000] = {};
+        int sent = 0;
+        while (sent < kBytes) {
+            int len = std::min<int>(sizeof(buf), kBytes - sent);
+            ssize_t n = ::write(fds[1], buf, len);
+            if (n > 0) {
+                sent += n;
+            } else {
+                ::usleep(100);
+            }
+        }
+    });
+    writer.start();
+    loop.loop();
+    writer.join();
+
+    assert(received == kBytes);
+    assert(!loop.hasFd(fds[0]));
+    printf("received %d bytes in %d wakeups\n", received, wakeups);
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+void testRunInLoop() {
+    EventLoop loop;
+    const int kThreads = 4;
+    const int kTasks = 10000;
+    int count = 0;  // 只在循环线程中修改
+    std::atomic<int> done(0);
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back(new Thread([&]() {
+            for (int j = 0; j < kTasks; ++j) {
+                loop.runInLoop([&]() {
+                    assert(loop.isInLoopThread());
+                    ++count;
+                });
+            }
+            loop.queueInLoop([&]() {
+                if (++done == kThreads) loop.quit();
+            });
+        }));
+        threads.back()->start();
+    }
+    loop.loop();
+    for (auto& thr : threads) thr->join();
+    assert(count == kThreads * kTasks);
+
+    // 循环线程中 runInLoop 立即执行
+    bool ran = false;
+    loop.runInLoop([&]() { ran = true; });
+    assert(ran);
+}
+
+void testTimers() {
+    EventLoop loop;
+    std::vector<int> order;
+    Timestamp start(Timestamp::now());
+    loop.runAfter(0.03, [&]() { order.push_back(3); });
+    loop.runAfter(0.01, [&]() { order.push_back(1); });
+    loop.runAt(addTime(start, 0.02), [&]() { order.push_back(2); });
+    TimerId never = loop.runAfter(0.02, [&]() { assert(false); });
+    assert(loop.cancel(never));
+
+    int ticks = 0;
+    TimerId every;
+    every = loop.runEvery(0.005, [&]() {
+        if (++ticks == 5) loop.cancel(every);
+    });
+
+    double elapsed = 0;
+    loop.runAfter(0.05, [&]() {
+        elapsed = timeDifference(Timestamp::now(), start);
+        loop.quit();
+    });
+    loop.loop();
+    assert((order == std::vector<int>{1, 2, 3}));
+    assert(ticks == 5);
+    printf("runAfter(0.05) fired after %.4fs\n", elapsed);
+    assert(elapsed >= 0.05 && elapsed < 0.5);
+}
+
+void testThreadPool() {
+    EventLoopThreadPool pool("TestLoop");
+    std::atomic<int> inited(0);
+    pool.start(3, [&](EventLoop*) { ++inited; });
+    assert(inited == 3);
+    assert(pool.getAllLoops().size() == 3);
+
+    std::set<EventLoop*> loops;
+    for (int i = 0; i < 6; ++i) loops.insert(pool.getNextLoop());
+    assert(loops.size() == 3);
+    assert(pool.getLoopForHash(7) == pool.getLoopForHash(7));
+
+    // 各个循环在不同的线程中执行任务和定时器
+    CountDownLatch latch(6);
+    std::atomic<int> inLoop(0);
+    for (EventLoop* loop : pool.getAllLoops()) {
+        assert(!loop->isInLoopThread());
+        loop->runInLoop([&, loop]() {
+            if (loop->isInLoopThread()) ++inLoop;
+            latch.countDown();
+        });
+        loop->runAfter(0.01, [&, loop]() {
+            if (EventLoop::getEventLoopOfCurrentThread() == loop) ++inLoop;
+            latch.countDown();
+        });
+    }
+    latch.wait();
+    assert(inLoop == 6);
+    pool.stop();
+}
+
+int main() {
+    testIo();
+    testRunInLoop();
+    testTimers();
+    testThreadPool();
+    printf("All tests passed!\n");
+    return 0;
+}
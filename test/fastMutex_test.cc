@@ -0,0 +1,92 @@
+#include <Base/fastMutex.h>
+#include <Base/mutex.h>
+#include <Base/thread.h>
+#include <Base/utils.h>
+
+#include <cassert>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+using namespace Lute;
+
+const int kThreads = 4;
+const int kCount = 1000 * 1000;
+
+/// 多线程对同一计数器加一，结果必须精确
+template <typename Mutex, typename Guard>
+int64_t contend(const char* name) {
+    Mutex mutex;
+    int64_t counter = 0;
+    std::vector<std::unique_ptr<Thread>> threads;
+
+    Timestamp start = Timestamp::now();
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back(new Thread([&mutex, &counter]() {
+            for (int j = 0; j < kCount; ++j) {
+                Guard lock(mutex);
+                ++counter;
+            }
+        }));
+        threads.back()->start();
+    }
+    for (auto& thr : threads) thr->join();
+    printf("%-10s %d threads x %d: %.3fs\n", name, kThreads, kCount,
+           timeDifference(Timestamp::now(), start));
+    return counter;
+}
+
+void testFastMutex() {
+    FastMutex mutex;
+    assert(!mutex.isLocked());
+    assert(mutex.tryLock());
+    assert(mutex.isLocked() && mutex.isLockedByThisThread());
+    assert(!mutex.tryLock());
+    mutex.unlock();
+    assert(!mutex.isLocked());
+    {
+        FastMutexGuard lock(mutex);
+        mutex.assertLocked();
+
+        // 其他线程加锁失败，持有者检查只对本线程成立
+        Thread thr([&mutex]() {
+            assert(!mutex.tryLock() && mutex.isLocked());
+#ifndef NDEBUG
+            assert(!mutex.isLockedByThisThread());
+#endif
+        });
+        thr.start();
+        thr.join();
+    }
+    assert(mutex.tryLock());
+    mutex.unlock();
+
+    int64_t counter = contend<FastMutex, FastMutexGuard>("FastMutex");
+    assert(counter == int64_t(kThreads) * kCount);
+    (void)counter;
+}
+
+void testSpinLock() {
+    SpinLock lock;
+    assert(!lock.isLocked());
+    assert(lock.tryLock());
+    assert(lock.isLocked() && !lock.tryLock());
+    lock.unlock();
+
+    int64_t counter = contend<SpinLock, SpinLockGuard>("SpinLock");
+    assert(counter == int64_t(kThreads) * kCount);
+    (void)counter;
+}
+
+int main() {
+    printf("sizeof MutexLock: %zd\n", sizeof(MutexLock));
+    printf("sizeof FastMutex: %zd\n", sizeof(FastMutex));
+    printf("sizeof SpinLock: %zd\n", sizeof(SpinLock));
+
+    testFastMutex();
+    testSpinLock();
+    int64_t counter = contend<MutexLock, MutexLockGuard>("MutexLock");
+    assert(counter == int64_t(kThreads) * kCount);
+    (void)counter;
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <Base/hex.h>
+#include <Base/utils.h>
+
+#include <cassert>
+#include <iostream>
+#include <string>
+
+int main() {
+    assert(Lute::hexEncode("", 0).empty());
+    assert(Lute::hexEncode("Lute", 4) == "4c757465");
+
+    std::string raw;
+    assert(Lute::hexDecode("4C757465", &raw) && raw == "Lute");
+    assert(!Lute::hexDecode("4c7", &raw));
+    assert(!Lute::hexDecode("4g", &raw));
+
+    // 覆盖 SIMD 主循环与尾部处理
+    for (size_t len = 0; len < 200; ++len) {
+        std::string data;
+        for (size_t i = 0; i < len; ++i) data.push_back(static_cast<char>(rand()));
+
+        std::string hex = Lute::hexEncode(data.data(), data.size());
+        assert(hex.size() == 2 * len);
+        for (size_t i = 0; i < len; ++i) {
+            auto c = static_cast<unsigned char>(data[i]);
+            assert(hex[2 * i] == "0123456789abcdef"[c >> 4]);
+            assert(hex[2 * i + 1] == "0123456789abcdef"[c & 0x0F]);
+        }
+
+        std::string out;
+        assert(Lute::hexDecode(hex, &out) && out == data);
+        Lute::toUpper(hex);
+        assert(Lute::hexDecode(hex, &out) && out == data);
+
+        // 任意位置的非法字符都能被检测到
+        if (len > 0) {
+            for (char bad : {'g', 'G', '/', ':', '@', '`', ' ', '\xff'}) {
+                std::string broken = hex;
+                broken[rand() % broken.size()] = bad;
+                assert(!Lute::hexDecode(broken, &out));
+            }
+        }
+    }
+
+    std::string data(1 << 20, 'x');
+    std::string hex;
+    PING(hexEncode);
+    for (int i = 0; i < 100; ++i) hex = Lute::hexEncode(data.data(), data.size());
+    PONG(hexEncode);
+    PING(hexDecode);
+    for (int i = 0; i < 100; ++i) assert(Lute::hexDecode(hex, &data));
+    PONG(hexDecode);
+    return 0;
+}
@@ -0,0 +1,183 @@
+#include <Base/fsUtils.h>
+#include <Base/ioUring.h>
+#include <Base/logger.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace Lute;
+
+std::string tempFile(const char* name) {
+    std::string path = std::string("/tmp/lute_io_uring_") + name + "_" +
+                       std::to_string(::getpid());
+    ::unlink(path.c_str());
+    return path;
+}
+
+void testRing() {
+    IoUring ring(8);
+    assert(ring.valid());
+    assert(ring.entries() >= 8);
+
+    std::string path = tempFile("ring");
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    assert(fd >= 0);
+
+    // 固定缓冲区 + 普通缓冲区的链接写入
+    static char fixed[4096];
+    memset(fixed, 'a', sizeof(fixed));
+    struct iovec reg = {fixed, sizeof(fixed)};
+    int err = ring.registerBuffers(&reg, 1);
+    printf("registerBuffers: %s\n", err == 0 ? "ok" : strerror(err));
+    if (err == 0) assert(ring.findBuffer(fixed + 100, 100) == 0);
+    assert(ring.findBuffer("x", 1) == -1);
+
+    const char* tail = "tail";
+    assert(ring.prepareWrite(fd, fixed, sizeof(fixed), 0, 1, true));
+    assert(ring.prepareWrite(fd, tail, 4, sizeof(fixed), 2, true));
+    assert(ring.prepareFsync(fd, 3));
+    assert(ring.pending() == 3);
+    assert(ring.submit(3) == 3);
+    assert(ring.pending() == 0);
+    for (int i = 0; i < 3; ++i) {
+        uint64_t userData = 0;
+        int32_t res = 0;
+        assert(ring.waitCompletion(&userData, &res));
+        if (userData == 1) assert(res == sizeof(fixed));
+        if (userData == 2) assert(res == 4);
+        if (userData == 3) assert(res == 0);
+    }
+    assert(!ring.peekCompletion(nullptr, nullptr));
+
+    char buf[8] = {};
+    assert(ring.prepareRead(fd, buf, 4, sizeof(fixed), 7));
+    assert(ring.submit(1) == 1);
+    uint64_t userData = 0;
+    int32_t res = 0;
+    assert(ring.waitCompletion(&userData, &res));
+    assert(userData == 7 && res == 4 && strcmp(buf, "tail") == 0);
+
+    // 提交队列满
+    for (unsigned i = 0; i < ring.entries(); ++i) {
+        assert(ring.prepareRead(fd, buf, 1, 0, i));
+    }
+    assert(!ring.prepareRead(fd, buf, 1, 0, 0));
+    assert(ring.submit(ring.entries()) == static_cast<int>(ring.entries()));
+    while (ring.peekCompletion(nullptr, nullptr)) {
+    }
+
+    assert(ring.unregisterBuffers() == 0);
+    ::close(fd);
+    ::unlink(path.c_str());
+}
+
+void testAppendv(IoUring* ring) {
+    std::string path = tempFile("appendv");
+    std::string expected;
+    std::vector<std::string> pieces;
+    for (int i = 0; i < 200; ++i) {
+        pieces.push_back(std::string(static_cast<size_t>(i * 37 % 5000),
+                                     static_cast<char>('a' + i % 26)) +
+                         "\n");
+    }
+    {
+        AppendFile file(path);
+        file.append("head\n", 5);  // 仍在 stdio 缓冲中
+        expected += "head\n";
+        std::vector<struct iovec> iov;
+        for (auto& piece : pieces) {
+            iov.push_back({&piece[0], piece.size()});
+            expected += piece;
+        }
+        file.appendv(iov.data(), static_cast<int>(iov.size()), ring);
+        file.append("end\n", 4);
+        expected += "end\n";
+        file.flush();
+        assert(file.writtenBytes() == static_cast<off_t>(expected.size()));
+    }
+    std::string content;
+    assert(readFile(path, 1 << 24, &content) == 0);
+    assert(content == expected);
+    ::unlink(path.c_str());
+}
+
+void testReadFiles() {
+    std::vector<std::string> names;
+    std::vector<std::string> expected;
+    for (int i = 0; i < 100; ++i) {
+        names.push_back(tempFile(("read" + std::to_string(i)).c_str()));
+        expected.push_back(std::string(static_cast<size_t>(i * 100), 'x') +
+                           std::to_string(i));
+        AppendFile file(names.back());
+        file.append(expected.back().data(), expected.back().size());
+    }
+    names.push_back("/proc/self/stat");  // 大小未知，同步读取
+    names.push_back("/nonexistent/file");
+
+    std::vector<std::string> contents;
+    std::vector<int> errors = readFiles(names, 1 << 20, &contents);
+    assert(errors.size() == names.size() && contents.size() == names.size());
+    for (int i = 0; i < 100; ++i) {
+        assert(errors[i] == 0);
+        assert(contents[i] == expected[i]);
+    }
+    assert(errors[100] == 0 && !contents[100].empty());
+    assert(errors[101] == ENOENT);
+
+    // maxSize 截断
+    errors = readFiles(names, 10, &contents);
+    assert(contents[99] == expected[99].substr(0, 10));
+
+    for (int i = 0; i < 100; ++i) ::unlink(names[i].c_str());
+}
+
+void testAsyncLogger() {
+    const std::string basename = "ioUringLoggerTest";
+    const int kLines = 200000;
+    {
+        AsyncLogger logger(basename, 1 << 30, 1);
+        logger.setIoUring(true);
+        logger.start();
+        char line[64];
+        for (int i = 0; i < kLines; ++i) {
+            int n = snprintf(line, sizeof(line), "line %d\n", i);
+            logger.append(line, n);
+        }
+        logger.stop();
+    }
+
+    std::vector<std::string> files;
+    FSUtil::listAllFile(files, ".", ".log");
+    int lines = 0;
+    for (const auto& file : files) {
+        if (file.find(basename) == std::string::npos) continue;
+        std::string content;
+        readFile(file, 1 << 30, &content);
+        for (char c : content) lines += c == '\n';
+        ::unlink(file.c_str());
+    }
+    printf("AsyncLogger over io_uring wrote %d lines\n", lines);
+    assert(lines == kLines);
+}
+
+int main() {
+    if (!IoUring::supported()) {
+        printf("io_uring is not supported, testing fallbacks only\n");
+        testAppendv(nullptr);
+        testReadFiles();
+        return 0;
+    }
+    testRing();
+    IoUring ring(16);
+    testAppendv(&ring);
+    testAppendv(nullptr);
+    testReadFiles();
+    testAsyncLogger();
+    printf("All tests passed!\n");
+    return 0;
+}
@@ -0,0 +1,78 @@
+#include <Base/fastMutex.h>
+#include <Base/lockProfiler.h>
+#include <Base/mutex.h>
+
+#include <cassert>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Lute;
+
+const int kThreads = 4;
+const int kIterations = 100000;
+
+template <typename Mutex, typename Guard>
+void contend(Mutex& mutex, int64_t* counter) {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < kThreads; ++i) {
+        threads.emplace_back([&mutex, counter]() {
+            for (int j = 0; j < kIterations; ++j) {
+                Guard lock(mutex);
+                ++*counter;
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+}
+
+/// @brief 从报告中取出 name 所在行的加锁次数与竞争次数
+bool parse(const std::string& report, const char* name, uint64_t* acquisitions,
+           uint64_t* contended) {
+    size_t pos = report.find(std::string("\n") + name + " ");
+    if (pos == std::string::npos) return false;
+    return sscanf(report.c_str() + pos + 1 + strlen(name),
+                  "%" SCNu64 " %" SCNu64, acquisitions, contended) == 2;
+}
+
+int main() {
+    MutexLock mutex("test.MutexLock");
+    FastMutex fastMutex("test.FastMutex");
+    int64_t a = 0;
+    int64_t b = 0;
+    contend<MutexLock, MutexLockGuard>(mutex, &a);
+    contend<FastMutex, FastMutexGuard>(fastMutex, &b);
+    assert(a == kThreads * kIterations);
+    assert(b == kThreads * kIterations);
+
+    std::string report = LockProfiler::report();
+    printf("%s", report.c_str());
+    if (!LockProfiler::enabled()) {
+        assert(report.find("disabled") != std::string::npos);
+        return 0;
+    }
+
+    uint64_t acquisitions = 0;
+    uint64_t contended = 0;
+    assert(parse(report, "test.MutexLock", &acquisitions, &contended));
+    assert(acquisitions == static_cast<uint64_t>(kThreads * kIterations));
+    assert(contended <= acquisitions);
+    assert(parse(report, "test.FastMutex", &acquisitions, &contended));
+    assert(acquisitions == static_cast<uint64_t>(kThreads * kIterations));
+    assert(LockProfiler::cyclesPerNs() > 0);
+
+    LockProfiler::reset();
+    {
+        MutexLockGuard lock(mutex);
+    }
+    report = LockProfiler::report();
+    assert(parse(report, "test.MutexLock", &acquisitions, &contended));
+    assert(acquisitions == 1 && contended == 0);
+    // 没有加锁记录的互斥量不出现在报告中
+    assert(report.find("test.FastMutex") == std::string::npos);
+    LockProfiler::dump();
+    return 0;
+}
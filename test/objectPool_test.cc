@@ -0,0 +1,140 @@
+#include <Base/MPMCQueue.h>
+#include <Base/objectPool.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Lute;
+
+std::atomic<int> g_live(0);
+
+struct Item {
+    explicit Item(int v) : value(v), name(std::to_string(v)) { ++g_live; }
+    ~Item() { --g_live; }
+
+    int value;
+    std::string name;
+};
+
+void testBasic() {
+    ObjectPool<Item> pool(4);
+    Item* a = pool.acquire(1);
+    assert(a->value == 1 && a->name == "1");
+    assert(g_live == 1);
+    ObjectPool<Item>::Stats s = pool.stats();
+    assert(s.misses == 1 && s.hits == 0 && s.highWater == 1 && s.inUse == 1);
+
+    pool.release(a);
+    assert(g_live == 0);
+    Item* b = pool.acquire(2);
+    // 本地空闲链表是 LIFO，取回同一个块
+    assert(b == a && b->value == 2);
+    s = pool.stats();
+    assert(s.misses == 1 && s.hits == 1 && s.highWater == 1 && s.inUse == 1);
+    pool.release(b);
+
+    {
+        ObjectPool<Item>::Ptr ptr = pool.make(3);
+        assert(ptr->value == 3);
+        assert(pool.stats().inUse == 1);
+    }
+    assert(pool.stats().inUse == 0);
+    assert(g_live == 0);
+}
+
+void testSpill() {
+    // 超出本地上限的块进入溢出链表，之后仍被取回，不再向堆申请
+    ObjectPool<Item> pool(4);
+    std::vector<Item*> items;
+    for (int i = 0; i < 32; ++i) items.push_back(pool.acquire(i));
+    for (Item* item : items) pool.release(item);
+    assert(pool.stats().highWater == 32);
+
+    items.clear();
+    for (int i = 0; i < 32; ++i) items.push_back(pool.acquire(i));
+    ObjectPool<Item>::Stats s = pool.stats();
+    assert(s.highWater == 32 && s.misses == 32 && s.hits == 32);
+    for (Item* item : items) pool.release(item);
+
+    // 不缓存在本地
+    ObjectPool<Item> shared(0);
+    Item* x = shared.acquire(1);
+    shared.release(x);
+    Item* y = shared.acquire(2);
+    assert(x == y);
+    shared.release(y);
+    assert(shared.stats().highWater == 1);
+}
+
+void testThreadExit() {
+    // 线程退出时本地空闲块并入溢出链表，由其他线程复用
+    ObjectPool<Item> pool(64);
+    std::thread t([&pool]() {
+        std::vector<Item*> items;
+        for (int i = 0; i < 16; ++i) items.push_back(pool.acquire(i));
+        for (Item* item : items) pool.release(item);
+    });
+    t.join();
+    for (int i = 0; i < 16; ++i) pool.release(pool.acquire(i));
+    std::vector<Item*> items;
+    for (int i = 0; i < 16; ++i) items.push_back(pool.acquire(i));
+    assert(pool.stats().highWater == 16);
+    for (Item* item : items) pool.release(item);
+}
+
+void testProducerConsumer() {
+    // 生产者 acquire、消费者 release，块经溢出链表回到生产者
+    const int kProducers = 2;
+    const int kPerProducer = 100000;
+    ObjectPool<Item> pool(16);
+    MPMCQueue<Item*> queue(256);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < kProducers; ++p) {
+        threads.emplace_back([&pool, &queue]() {
+            for (int i = 0; i < kPerProducer; ++i) {
+                queue.push(pool.acquire(i));
+            }
+        });
+    }
+    std::atomic<long> sum(0);
+    for (int c = 0; c < 2; ++c) {
+        threads.emplace_back([&pool, &queue, &sum]() {
+            for (int i = 0; i < kPerProducer; ++i) {
+                Item* item = queue.pop();
+                assert(item->name == std::to_string(item->value));
+                sum += item->value;
+                pool.release(item);
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    long expected =
+        static_cast<long>(kPerProducer - 1) * kPerProducer / 2 * kProducers;
+    assert(sum == expected);
+    ObjectPool<Item>::Stats s = pool.stats();
+    assert(s.inUse == 0);
+    assert(s.hits + s.misses ==
+           static_cast<uint64_t>(kProducers) * kPerProducer);
+    // 队列容量加上各线程的本地缓存限制了池的大小
+    printf("hits %lu misses %lu highWater %lu\n",
+           static_cast<unsigned long>(s.hits),
+           static_cast<unsigned long>(s.misses),
+           static_cast<unsigned long>(s.highWater));
+    assert(s.highWater < 1024);
+    assert(g_live == 0);
+}
+
+int main() {
+    testBasic();
+    testSpill();
+    testThreadExit();
+    testProducerConsumer();
+    printf("objectPool test passed\n");
+    return 0;
+}
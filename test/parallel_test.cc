@@ -0,0 +1,147 @@
+#include <Base/parallel.h>
+#include <Base/utils.h>
+#include <time.h>  // clock_gettime
+
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+void testFor(Lute::ThreadPool& pool) {
+    const size_t kSize = 1000003;
+    std::vector<int> v(kSize, 0);
+    // 自动 grain
+    Lute::parallelFor(pool, size_t(0), kSize, size_t(0),
+                      [&v](size_t i) { v[i] += static_cast<int>(i % 7); });
+    for (size_t i = 0; i < kSize; ++i) assert(v[i] == static_cast<int>(i % 7));
+
+    // 指定 grain，负数下标
+    std::vector<int> w(200, 0);
+    Lute::parallelFor(pool, -100, 100, 3, [&w](int i) { w[i + 100] = i; });
+    for (int i = -100; i < 100; ++i) assert(w[i + 100] == i);
+
+    // 空区间
+    Lute::parallelFor(pool, 5, 5, 1, [](int) { assert(false); });
+
+    // 嵌套调用: 工作线程内等待时帮助执行，不会死锁
+    std::atomic_int count(0);
+    Lute::parallelFor(pool, 0, 64, 1, [&pool, &count](int) {
+        Lute::parallelFor(pool, 0, 1000, 10,
+                          [&count](int) { count.fetch_add(1); });
+    });
+    assert(count == 64 * 1000);
+
+    // 异常在调用线程中重新抛出
+    bool thrown = false;
+    try {
+        Lute::parallelFor(pool, 0, 10000, 1, [](int i) {
+            if (i == 4321) throw std::runtime_error("oops");
+        });
+    } catch (const std::runtime_error& e) {
+        thrown = std::strcmp(e.what(), "oops") == 0;
+    }
+    assert(thrown);
+    std::cout << "parallelFor ok" << std::endl;
+}
+
+void testReduce(Lute::ThreadPool& pool) {
+    const int64_t kSize = 1000000;
+    int64_t sum = Lute::parallelReduce(
+        pool, int64_t(0), kSize, int64_t(0), int64_t(0),
+        [](int64_t i) { return i; }, std::plus<int64_t>());
+    assert(sum == kSize * (kSize - 1) / 2);
+
+    // 不满足交换律的 combine: 结果保持从左到右的顺序
+    std::string s = Lute::parallelReduce(
+        pool, 0, 1000, 7, std::string(),
+        [](int i) { return std::string(1, static_cast<char>('a' + i % 26)); },
+        std::plus<std::string>());
+    assert(s.size() == 1000);
+    for (int i = 0; i < 1000; ++i) assert(s[i] == 'a' + i % 26);
+
+    assert(Lute::parallelReduce(pool, 3, 3, 1, 42, [](int i) { return i; },
+                                std::plus<int>()) == 42);
+    std::cout << "parallelReduce ok" << std::endl;
+}
+
+void testSort(Lute::ThreadPool& pool) {
+    std::mt19937 rng(12345);
+    for (size_t n : {0, 1, 100, 100000, 1000000}) {
+        std::vector<int> v(n);
+        for (auto& x : v) x = static_cast<int>(rng() % 1000);  // 大量重复值
+        std::vector<int> expect(v);
+        std::sort(expect.begin(), expect.end());
+        Lute::parallelSort(pool, v.begin(), v.end(), std::less<int>());
+        assert(v == expect);
+    }
+
+    // 已排序 / 逆序输入
+    std::vector<double> d(500000);
+    std::iota(d.begin(), d.end(), 0.0);
+    Lute::parallelSort(pool, d.begin(), d.end(), std::greater<double>());
+    for (size_t i = 1; i < d.size(); ++i) assert(d[i - 1] >= d[i]);
+    Lute::parallelSort(d.begin(), d.end());
+    for (size_t i = 1; i < d.size(); ++i) assert(d[i - 1] <= d[i]);
+    std::cout << "parallelSort ok" << std::endl;
+}
+
+static double threadCpuMs() {
+    struct timespec ts;
+    ::clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e3 +
+           static_cast<double>(ts.tv_nsec) / 1e6;
+}
+
+/// 非工作线程等待长时间运行的任务时休眠，而不是占满一个核
+void testWaiterParks(Lute::ThreadPool& pool) {
+    double cpuBegin = threadCpuMs();
+    Lute::parallelFor(pool, 0, 2, 1, [](int i) {
+        // 调用线程执行 i == 0，期间工作线程取走 i == 1
+        int ms = i == 0 ? 20 : 200;
+        std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+    });
+    double cpuMs = threadCpuMs() - cpuBegin;
+    std::cout << "parallelFor waiter cpu " << cpuMs << " ms" << std::endl;
+    assert(cpuMs < 100);
+}
+
+void benchmark() {
+    const size_t kSize = 4000000;
+    std::vector<uint32_t> v(kSize);
+    std::mt19937 rng(1);
+    for (auto& x : v) x = rng();
+    std::vector<uint32_t> w(v);
+
+    PING(std_sort);
+    std::sort(v.begin(), v.end());
+    PONG(std_sort);
+
+    PING(parallelSort);
+    Lute::parallelSort(w.begin(), w.end());
+    PONG(parallelSort);
+    assert(v == w);
+}
+
+int main() {
+    Lute::ThreadPool pool("ParallelTest");
+    pool.start(4);
+    testFor(pool);
+    testReduce(pool);
+    testSort(pool);
+    testWaiterParks(pool);
+    pool.stop();
+
+    // 未启动的线程池: 在调用线程中顺序执行
+    Lute::ThreadPool idle;
+    testFor(idle);
+    testReduce(idle);
+
+    benchmark();
+    return 0;
+}
@@ -0,0 +1,149 @@
+#include <Base/reclamation.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace Lute;
+
+std::atomic<int> g_live(0);
+
+struct Node {
+    explicit Node(int v) : value(v), twice(2 * v) { g_live.fetch_add(1); }
+    ~Node() {
+        value = -1;
+        g_live.fetch_sub(1);
+    }
+
+    int value;
+    int twice;
+};
+
+void testEpochSingleThread() {
+    EpochDomain domain;
+    {
+        EpochDomain::Guard guard(domain);
+        domain.retire(new Node(1));
+        // 自己仍在临界区中: 纪元最多推进一次，对象不能释放
+        assert(domain.reclaim() == 0);
+        assert(g_live.load() == 1);
+    }
+    assert(domain.reclaim() == 1);
+    assert(g_live.load() == 0);
+
+    // 嵌套临界区
+    domain.enter();
+    domain.enter();
+    domain.retire(new Node(2));
+    domain.leave();
+    assert(domain.reclaim() == 0);
+    domain.leave();
+    assert(domain.reclaim() == 1);
+    assert(domain.reclaimed() == 2);
+}
+
+void testHazardSingleThread() {
+    HazardPointerDomain domain;
+    std::atomic<Node*> head(new Node(3));
+    {
+        HazardPointer hp(domain);
+        Node* node = hp.protect(head);
+        assert(node->value == 3);
+        head.store(nullptr);
+        domain.retire(node);
+        // 被保护的对象不释放
+        assert(domain.reclaim() == 0);
+        assert(node->value == 3);
+        hp.reset();
+        assert(domain.reclaim() == 1);
+    }
+    assert(g_live.load() == 0);
+}
+
+void testThreadExit() {
+    EpochDomain domain;
+    // 线程退出时本地批次并入域，记录被之后的线程复用
+    for (int round = 0; round < 2; ++round) {
+        std::thread t([&domain]() {
+            for (int i = 0; i < 10; ++i) domain.retire(new Node(i));
+        });
+        t.join();
+        assert(domain.pending() == 10);
+        assert(domain.reclaim() == 10);
+    }
+    assert(g_live.load() == 0);
+
+    // 析构时释放全部对象
+    {
+        HazardPointerDomain hp;
+        hp.retire(new Node(4));
+    }
+    assert(g_live.load() == 0);
+}
+
+/// 读者不断读取共享节点，写者不断替换并退休旧节点
+template <typename Domain, typename Read>
+void stress(Domain& domain, Read read) {
+    const int kReaders = 3;
+    const int kWrites = 20000;
+    std::atomic<Node*> shared(new Node(0));
+    std::atomic<bool> done(false);
+    std::atomic<int64_t> reads(0);
+
+    std::vector<std::thread> readers;
+    for (int i = 0; i < kReaders; ++i) {
+        readers.emplace_back([&]() {
+            while (!done.load(std::memory_order_relaxed)) {
+                // 被释放的节点 value 为 -1
+                bool ok = read(shared);
+                assert(ok);
+                (void)ok;
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+    for (int i = 1; i <= kWrites; ++i) {
+        Node* old = shared.exchange(new Node(i));
+        domain.retire(old);
+    }
+    done = true;
+    for (auto& t : readers) t.join();
+    delete shared.load();
+    domain.reclaim();
+    printf("%d writes, %lld reads, %llu reclaimed\n", kWrites,
+           static_cast<long long>(reads.load()),
+           static_cast<unsigned long long>(domain.reclaimed()));
+}
+
+void testEpochStress() {
+    EpochDomain domain;
+    domain.startReclaimer(1);
+    stress(domain, [&domain](std::atomic<Node*>& shared) {
+        EpochDomain::Guard guard(domain);
+        Node* node = shared.load(std::memory_order_acquire);
+        return node->value >= 0 && node->twice == 2 * node->value;
+    });
+    domain.stopReclaimer();
+}
+
+void testHazardStress() {
+    HazardPointerDomain domain;
+    stress(domain, [&domain](std::atomic<Node*>& shared) {
+        HazardPointer hp(domain);
+        Node* node = hp.protect(shared);
+        return node->value >= 0 && node->twice == 2 * node->value;
+    });
+}
+
+int main() {
+    testEpochSingleThread();
+    testHazardSingleThread();
+    testThreadExit();
+    testEpochStress();
+    testHazardStress();
+    assert(g_live.load() == 0);
+    printf("reclamation test passed\n");
+    return 0;
+}
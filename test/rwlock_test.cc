@@ -0,0 +1,109 @@
+#include <Base/rwlock.h>
+#include <Base/thread.h>
+#include <Base/utils.h>
+
+#include <cassert>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace Lute;
+
+void testRWLock() {
+    RWLock lock;
+    // 读锁可以同时持有，写锁互斥
+    assert(lock.tryLockShared());
+    assert(lock.tryLockShared());
+    assert(!lock.tryLock());
+    lock.unlockShared();
+    lock.unlockShared();
+    assert(lock.tryLock());
+    assert(!lock.tryLockShared());
+    lock.unlock();
+
+    std::map<std::string, int> table;
+    const int kReaders = 4;
+    const int kWrites = 10000;
+    std::atomic<bool> done(false);
+    std::atomic<int64_t> reads(0);
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int i = 0; i < kReaders; ++i) {
+        threads.emplace_back(new Thread([&]() {
+            while (!done.load(std::memory_order_relaxed)) {
+                ReaderLockGuard guard(lock);
+                // 写者在同一临界区内同时修改两个键，读者看到的必须一致
+                auto a = table.find("a");
+                auto b = table.find("b");
+                assert((a == table.end()) == (b == table.end()));
+                if (a != table.end()) assert(a->second == -b->second);
+                reads.fetch_add(1, std::memory_order_relaxed);
+            }
+        }));
+        threads.back()->start();
+    }
+
+    for (int i = 0; i < kWrites; ++i) {
+        WriterLockGuard guard(lock);
+        table["a"] = i;
+        table["b"] = -i;
+    }
+    done = true;
+    for (auto& thr : threads) thr->join();
+    printf("RWLock: %d writes, %ld reads\n", kWrites,
+           static_cast<long>(reads.load()));
+}
+
+struct Route {
+    uint32_t ip;
+    uint16_t port;
+    uint16_t weight;
+    uint64_t checksum;  // ip ^ port ^ weight，用于检查读到的值是否一致
+};
+
+void testSeqLock() {
+    SeqLock<Route> route(Route{1, 2, 3, 1 ^ 2 ^ 3});
+    assert(route.version() == 0);
+    Route r = route.load();
+    assert(r.ip == 1 && r.port == 2 && r.weight == 3);
+
+    route.update([](Route& v) {
+        v.port = 80;
+        v.checksum = v.ip ^ v.port ^ v.weight;
+    });
+    assert(route.load().port == 80 && route.version() == 1);
+
+    const int kReaders = 3;
+    const int kWrites = 200000;
+    std::atomic<bool> done(false);
+    std::vector<std::unique_ptr<Thread>> threads;
+    for (int i = 0; i < kReaders; ++i) {
+        threads.emplace_back(new Thread([&]() {
+            while (!done.load(std::memory_order_relaxed)) {
+                Route v = route.load();
+                assert(v.checksum == (v.ip ^ v.port ^ v.weight));
+                (void)v;
+            }
+        }));
+        threads.back()->start();
+    }
+
+    PING(SeqLockWrite);
+    for (uint32_t i = 0; i < kWrites; ++i) {
+        auto port = static_cast<uint16_t>(i);
+        auto weight = static_cast<uint16_t>(i * 7);
+        route.store(Route{i, port, weight, i ^ port ^ weight});
+    }
+    PONG(SeqLockWrite);
+    done = true;
+    for (auto& thr : threads) thr->join();
+    assert(route.version() == kWrites + 1);
+    printf("SeqLock ok\n");
+}
+
+int main() {
+    testRWLock();
+    testSeqLock();
+    return 0;
+}
@@ -0,0 +1,127 @@
+#include <Base/serialize.h>
+
+#include <cassert>
+#include <iostream>
+
+namespace app {
+enum class Color : uint8_t { RED, GREEN, BLUE };
+
+struct Header {
+    uint32_t magic;
+    uint16_t version;
+    bool compressed;
+};
+LUTE_SERIALIZE(Header, magic, version, compressed)
+
+struct Message {
+    Header header;
+    int64_t id;
+    double score;
+    Color color;
+    std::string name;
+    std::vector<int32_t> values;
+    std::vector<std::string> tags;
+    std::vector<Header> history;
+};
+LUTE_SERIALIZE(Message, header, id, score, color, name, values, tags, history)
+}  // namespace app
+
+bool operator==(const app::Header& lhs, const app::Header& rhs) {
+    return lhs.magic == rhs.magic && lhs.version == rhs.version &&
+           lhs.compressed == rhs.compressed;
+}
+
+void check(bool littleEndian, size_t baseSize) {
+    app::Message msg;
+    msg.header = {0xCAFEBABE, 3, true};
+    msg.id = -1234567890123;
+    msg.score = 3.1415;
+    msg.color = app::Color::BLUE;
+    msg.name = "Lute";
+    for (int i = 0; i < 3000; ++i) msg.values.push_back(i * (i % 2 ? -7 : 7));
+    msg.tags = {"a", "", "Polaris"};
+    msg.history = {{1, 2, false}, {3, 4, true}};
+
+    // 定长前缀 header + id + score + color 合并为一次拷贝
+    static_assert(Lute::detail::FixedSize<app::Header>::value == 7, "");
+    static_assert(
+        Lute::detail::FixedPrefix<Lute::detail::FieldsOf<app::Message>>::
+                count() == 4,
+        "");
+
+    Lute::ByteArray ba(baseSize);
+    ba.setLittleEndian(littleEndian);
+    size_t size = Lute::serializedSize(msg);
+    Lute::serialize(ba, msg);
+    assert(ba.size() == size);
+
+    ba.setPosition(0);
+    auto out = Lute::deserialize<app::Message>(ba);
+    assert(ba.readableSize() == 0);
+    assert(out.header == msg.header);
+    assert(out.id == msg.id);
+    assert(out.score == msg.score);
+    assert(out.color == msg.color);
+    assert(out.name == msg.name);
+    assert(out.values == msg.values);
+    assert(out.tags == msg.tags);
+    assert(out.history.size() == 2 && out.history[1] == msg.history[1]);
+
+    // 与手写的逐字段编码保持一致
+    ba.setPosition(0);
+    assert(ba.readFuint32() == msg.header.magic);
+    assert(ba.readFuint16() == msg.header.version);
+    assert(ba.readFuint8() == 1);
+    assert(ba.readFint64() == msg.id);
+    assert(ba.readDouble() == msg.score);
+    assert(ba.readFuint8() == 2);
+    assert(ba.readStringVint() == msg.name);
+    assert(ba.readUint64() == msg.values.size());
+    for (auto v : msg.values) assert(ba.readFint32() == v);
+
+    std::cout << "serialize littleEndian=" << littleEndian
+              << " baseSize=" << baseSize << " size=" << size << std::endl;
+}
+
+void checkStaticEndian() {
+    app::Message msg;
+    msg.header = {1, 2, false};
+    msg.id = 42;
+    msg.name = "static";
+    msg.values = {1, -2, 3, -4, 5, -6, 7, -8, 9};
+
+    // 编译期字节序与运行时设置为大端的编码结果一致
+    Lute::BigEndianByteArray be(5);
+    Lute::ByteArray rt(5);
+    rt.setLittleEndian(false);
+    Lute::serialize(be, msg);
+    Lute::serialize(rt, msg);
+    be.setPosition(0);
+    rt.setPosition(0);
+    assert(be.toString() == rt.toString());
+
+    auto out = Lute::deserialize<app::Message>(be);
+    assert(out.header == msg.header);
+    assert(out.name == msg.name);
+    assert(out.values == msg.values);
+}
+
+int main() {
+    checkStaticEndian();
+    check(true, 4096);
+    check(false, 4096);
+    check(true, 3);
+    check(false, 7);
+
+    Lute::ByteArray ba;
+    ba.writeUint64(1ull << 40);  // 损坏的数组长度
+    ba.setPosition(0);
+    bool thrown = false;
+    try {
+        Lute::deserialize<std::vector<int64_t>>(ba);
+    } catch (const std::out_of_range&) {
+        thrown = true;
+    }
+    assert(thrown);
+    return 0;
+}
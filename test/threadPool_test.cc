@@ -0,0 +1,150 @@
+#include <Base/countDownLatch.h>
+#include <Base/currentThread.h>
+#include <Base/threadPool.h>
+#include <Base/utils.h>
+
+#include <cassert>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+/// 递归拆分的任务: 等待子任务时帮助执行其他任务，不会阻塞工作线程
+int64_t fib(Lute::ThreadPool& pool, int n) {
+    if (n < 12) return n < 2 ? n : fib(pool, n - 1) + fib(pool, n - 2);
+    auto left = pool.submit(fib, std::ref(pool), n - 1);
+    int64_t right = fib(pool, n - 2);
+    while (left.wait_for(std::chrono::seconds(0)) !=
+           std::future_status::ready) {
+        if (!pool.tryRunOne()) Lute::cpuRelax();
+    }
+    return left.get() + right;
+}
+
+void testDeque() {
+    Lute::detail::WorkStealingDeque<int*> deque(2);
+    int values[100];
+    for (auto& v : values) deque.push(&v);  // 扩容
+    assert(deque.sizeGuess() == 100);
+
+    int* item = nullptr;
+    assert(deque.steal(item) && item == &values[0]);  // 顶部 FIFO
+    assert(deque.take(item) && item == &values[99]);  // 底部 LIFO
+    while (deque.take(item)) {
+    }
+    assert(deque.empty() && !deque.steal(item));
+}
+
+void testBasic() {
+    Lute::ThreadPool pool("TestPool");
+    // 未启动时在调用线程中执行
+    int inline_ = 0;
+    pool.run([&inline_]() { inline_ = 1; });
+    assert(inline_ == 1);
+
+    std::atomic_int inits(0);
+    pool.setThreadInitCallback([&inits]() { inits.fetch_add(1); });
+    pool.setThreadAffinity(true);
+    pool.start(4);
+    assert(pool.numThreads() == 4);
+    assert(!pool.inWorkerThread());
+
+    auto f = pool.submit([](int x) { return x * 2; }, 21);
+    assert(f.get() == 42);
+
+    auto name = pool.submit(
+        []() { return std::string(Lute::CurrentThread::name()); });
+    assert(name.get().compare(0, 8, "TestPool") == 0);
+
+    // 只能移动的参数
+    auto moved = pool.submit([](std::unique_ptr<int> p) { return *p; },
+                             std::make_unique<int>(7));
+    assert(moved.get() == 7);
+
+    auto err = pool.submit([]() -> int { throw std::runtime_error("oops"); });
+    bool thrown = false;
+    try {
+        err.get();
+    } catch (const std::runtime_error& e) {
+        thrown = std::strcmp(e.what(), "oops") == 0;
+    }
+    assert(thrown);
+
+    assert(fib(pool, 25) == 75025);
+    assert(inits == 4);
+    pool.stop();
+    std::cout << "ThreadPool basic ok" << std::endl;
+}
+
+void testStopDrains() {
+    const int kTasks = 100000;
+    std::atomic_int count(0);
+    {
+        Lute::ThreadPool pool;
+        pool.setMaxQueueSize(128);  // 注入队列满时 run() 阻塞
+        pool.start(3);
+        for (int i = 0; i < kTasks; ++i) {
+            pool.run([&pool, &count, i]() {
+                count.fetch_add(1);
+                // 工作线程内提交的任务进入本线程的队列，可被其他线程窃取
+                if (i % 10 == 0) {
+                    pool.run([&count]() { count.fetch_add(1); });
+                }
+            });
+        }
+        // 析构时 stop()，等待全部任务执行完毕
+    }
+    assert(count == kTasks + kTasks / 10);
+    std::cout << "ThreadPool stop drains " << count << " tasks" << std::endl;
+}
+
+/// 外部线程提交与 stop() 并发: 每个任务要么进入队列被执行，要么在调用线程
+/// 中直接执行，不会丢失
+void testStopRace() {
+    for (int round = 0; round < 50; ++round) {
+        std::atomic_int count(0);
+        const int kSubmitters = 3;
+        const int kPerSubmitter = 2000;
+        Lute::ThreadPool pool;
+        pool.setMaxQueueSize(64);
+        pool.start(2);
+        std::vector<std::thread> submitters;
+        for (int s = 0; s < kSubmitters; ++s) {
+            submitters.emplace_back([&pool, &count]() {
+                for (int i = 0; i < kPerSubmitter; ++i) {
+                    auto f = pool.submit([&count]() { count.fetch_add(1); });
+                    f.get();
+                }
+            });
+        }
+        pool.stop();
+        for (auto& t : submitters) t.join();
+        assert(count == kSubmitters * kPerSubmitter);
+    }
+    std::cout << "ThreadPool stop race passed" << std::endl;
+}
+
+void benchmark() {
+    const int kTasks = 1000000;
+    Lute::ThreadPool pool("Bench");
+    pool.start(4);
+    Lute::CountDownLatch latch(kTasks);
+    PING(ThreadPool);
+    for (int i = 0; i < kTasks; ++i) {
+        pool.run([&latch]() { latch.countDown(); });
+    }
+    latch.wait();
+    PONG(ThreadPool);
+}
+
+int main() {
+    testDeque();
+    testBasic();
+    testStopDrains();
+    testStopRace();
+    benchmark();
+    return 0;
+}
@@ -1,9 +1,14 @@
 #include <Base/currentThread.h>
 #include <Base/utils.h>
 #include <Base/thread.h>
+#include <sys/resource.h>
 #include <unistd.h>
+#include <atomic>
+#include <cassert>
 #include <iostream>
+#include <memory>
 #include <thread>
+#include <vector>
 
 void mysleep(int seconds) {
     timespec t = {seconds, 0};
@@ -38,8 +43,117 @@ private:
     double x_;
 };
 
+void testOptions() {
+    using Lute::ThreadOptions;
+    assert(ThreadOptions::parseCpuList("").empty());
+    assert((ThreadOptions::parseCpuList("0-3,6, 8-9") ==
+            std::vector<int>{0, 1, 2, 3, 6, 8, 9}));
+    assert((ThreadOptions::parseCpuList("x,2,-1") == std::vector<int>{2}));
+
+    ThreadOptions options;
+    options.cpus = {0};
+    options.stackSize = 1024 * 1024;
+    options.nice = 5;
+    options.numaNode = 0;
+
+    int cpu = -1;
+    size_t stackSize = 0;
+    int nice = 0;
+    Lute::Thread t(
+        [&]() {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            pthread_getaffinity_np(pthread_self(), sizeof(set), &set);
+            if (CPU_COUNT(&set) == 1 && CPU_ISSET(0, &set)) cpu = 0;
+
+            pthread_attr_t attr;
+            pthread_getattr_np(pthread_self(), &attr);
+            pthread_attr_getstacksize(&attr, &stackSize);
+            pthread_attr_destroy(&attr);
+
+            nice = ::getpriority(PRIO_PROCESS,
+                                 static_cast<id_t>(Lute::CurrentThread::tid()));
+        },
+        "options", options);
+    t.start();
+    t.join();
+    assert(cpu == 0);
+    assert(stackSize == options.stackSize);
+    assert(nice == 5);
+    // nice 值只影响新线程
+    assert(::getpriority(PRIO_PROCESS, 0) == 0);
+    printf("ThreadOptions ok\n");
+}
+
+void testMove() {
+    std::atomic<int> sum(0);
+    std::vector<Lute::Thread> threads;
+    for (int i = 0; i < 8; ++i) {
+        // 扩容时 Thread 被移动，包括已启动的线程
+        threads.emplace_back([&sum, i]() { sum.fetch_add(i); });
+        threads.back().start(i % 2 == 0);
+    }
+    for (auto& thr : threads) {
+        assert(thr.started() && thr.tid() > 0);
+        thr.join();
+    }
+    assert(sum == 28);
+
+    // 移动赋值: 目标线程未 join 时被 detach
+    Lute::Thread a([]() {}, "a");
+    Lute::Thread b([]() { mysleep(0); }, "b");
+    a.start();
+    b.start(false);
+    pid_t tid = b.tid();
+    a = std::move(b);
+    assert(a.name() == "b" && a.tid() == tid && !b.started());
+    a.join();
+
+    // 线程函数被移动而不是复制
+    auto token = std::make_shared<int>(1);
+    Lute::Thread c([token]() {});
+    assert(token.use_count() == 2);
+    c.start();
+    c.join();
+    assert(token.use_count() == 1);
+
+    // 握手完成之前多个线程同时调用 tid()
+    Lute::Thread d([]() {});
+    d.start(false);
+    pid_t tids[2] = {0, 0};
+    std::thread r1([&d, &tids]() { tids[0] = d.tid(); });
+    std::thread r2([&d, &tids]() { tids[1] = d.tid(); });
+    r1.join();
+    r2.join();
+    assert(tids[0] > 0 && tids[0] == tids[1] && d.tid() == tids[0]);
+    d.join();
+    printf("Thread move ok\n");
+}
+
+void benchmarkSpawn() {
+    const int kThreads = 500;
+    PING(spawnAndWaitTid);
+    for (int i = 0; i < kThreads; ++i) {
+        Lute::Thread t([]() {});
+        t.start();
+        t.join();
+    }
+    PONG(spawnAndWaitTid);
+
+    PING(spawnNoWait);
+    for (int i = 0; i < kThreads; ++i) {
+        Lute::Thread t([]() {});
+        t.start(false);
+        t.join();
+    }
+    PONG(spawnNoWait);
+}
+
 int main() {
     printf("pid=%d, tid=%d\n", ::getpid(), Lute::CurrentThread::tid());
+    testOptions();
+    testMove();
+    benchmarkSpawn();
 
     Lute::Thread t1(threadFunc);
     t1.start();
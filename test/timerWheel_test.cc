@@ -0,0 +1,162 @@
+#include <Base/countDownLatch.h>
+#include <Base/timerWheel.h>
+#include <Base/timestamp.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <vector>
+
+using namespace Lute;
+
+void testWheel() {
+    TimerWheel wheel;
+    std::vector<int> fired;
+    // 跨越各层的到期时间，执行顺序与到期时间一致
+    const uint64_t delays[] = {1, 255, 256, 300, 16383, 16384, 70000, 5000000};
+    for (int i = 7; i >= 0; --i) {
+        wheel.add(delays[i], [&fired, i]() { fired.push_back(i); });
+    }
+    assert(wheel.size() == 8);
+    assert(wheel.ticksUntilNextExpiry() == 1);
+
+    for (int i = 0; i < 8; ++i) {
+        // 到期前一个 tick 不执行，到期时恰好执行
+        wheel.advance(delays[i] - 1);
+        assert(fired.size() == static_cast<size_t>(i));
+        wheel.advance(delays[i]);
+        assert(fired.size() == static_cast<size_t>(i + 1));
+        assert(fired.back() == i);
+    }
+    assert(wheel.empty());
+    assert(wheel.ticksUntilNextExpiry() == -1);
+
+    // 取消
+    int count = 0;
+    TimerId a = wheel.add(10, [&]() { ++count; });
+    TimerId b = wheel.add(10, [&]() { ++count; });
+    assert(wheel.cancel(a));
+    assert(!wheel.cancel(a));
+    wheel.advance(wheel.currentTick() + 10);
+    assert(count == 1);
+    assert(!wheel.cancel(b));  // 已到期
+}
+
+void testPeriodic() {
+    TimerWheel wheel;
+    int count = 0;
+    TimerId id;
+    id = wheel.add(
+        5,
+        [&]() {
+            // 在回调中取消自己
+            if (++count == 4) assert(wheel.cancel(id));
+        },
+        5);
+    wheel.advance(100);
+    assert(count == 4);
+    assert(wheel.empty());
+
+    // 回调中添加新的定时器
+    int chained = 0;
+    std::function<void()> chain = [&]() {
+        if (++chained < 1000) wheel.add(3, chain);
+    };
+    wheel.add(1, chain);
+    wheel.advance(wheel.currentTick() + 3000);
+    assert(chained == 1000);
+
+    // 周期向上取整到 tick，不足一个 tick 时为 1
+    const int64_t kMs = 1000000;
+    assert(TimerWheel::periodTicks(0, kMs) == 0);
+    assert(TimerWheel::periodTicks(1e-6, kMs) == 1);
+    assert(TimerWheel::periodTicks(0.0015, kMs) == 2);
+    assert(TimerWheel::periodTicks(0.0025, kMs) == 3);
+}
+
+void testFarTimer() {
+    TimerWheel wheel;
+    // 超出时间轮范围 (2^26 tick)
+    const uint64_t kFar = (uint64_t(1) << 28) + 12345;
+    bool fired = false;
+    wheel.add(kFar, [&]() { fired = true; });
+    wheel.advance(kFar - 1);
+    assert(!fired);
+    wheel.advance(kFar);
+    assert(fired);
+}
+
+void testMillionTimers() {
+    const int kTimers = 1000000;
+    TimerWheel wheel;
+    std::vector<TimerId> ids;
+    ids.reserve(kTimers);
+    int64_t count = 0;
+
+    Timestamp start(Timestamp::now());
+    for (int i = 0; i < kTimers; ++i) {
+        uint64_t delay = 1 + static_cast<uint64_t>(i) * 7919 % 100000;
+        ids.push_back(wheel.add(delay, [&count]() { ++count; }));
+    }
+    Timestamp added(Timestamp::now());
+    for (int i = 0; i < kTimers; i += 2) assert(wheel.cancel(ids[i]));
+    Timestamp cancelled(Timestamp::now());
+    size_t ran = wheel.advance(100000);
+    Timestamp done(Timestamp::now());
+
+    assert(ran == kTimers / 2);
+    assert(count == kTimers / 2);
+    assert(wheel.empty());
+    printf("%d timers: add %.3fs, cancel half %.3fs, expire %.3fs\n", kTimers,
+           timeDifference(added, start), timeDifference(cancelled, added),
+           timeDifference(done, cancelled));
+}
+
+void testScheduler() {
+    TimerScheduler scheduler("TimerTest", 1000);
+    scheduler.start();
+
+    CountDownLatch latch(1);
+    Timestamp start(Timestamp::now());
+    double elapsed = 0;
+    scheduler.runAfter(0.05, [&]() {
+        elapsed = timeDifference(Timestamp::now(), start);
+        latch.countDown();
+    });
+    latch.wait();
+    printf("runAfter(0.05) fired after %.4fs\n", elapsed);
+    assert(elapsed >= 0.05 && elapsed < 0.5);
+
+    std::atomic<int> ticks(0);
+    TimerId every = scheduler.runEvery(0.01, [&]() { ++ticks; });
+    TimerId never = scheduler.runAfter(10.0, []() { assert(false); });
+    CountDownLatch cancelled(1);
+    scheduler.runAfter(0.105, [&]() {
+        assert(scheduler.cancel(every));
+        cancelled.countDown();
+    });
+    cancelled.wait();
+    int n = ticks.load();
+    printf("runEvery(0.01) fired %d times in 0.105s\n", n);
+    assert(n >= 5 && n <= 11);
+    assert(scheduler.cancel(never));
+    assert(scheduler.size() == 0);
+
+    // 更早的定时器唤醒正在休眠的调度线程
+    CountDownLatch late(1);
+    scheduler.runAt(addTime(Timestamp::now(), 0.02), [&]() {
+        late.countDown();
+    });
+    late.wait();
+    scheduler.stop();
+}
+
+int main() {
+    testWheel();
+    testPeriodic();
+    testFarTimer();
+    testMillionTimers();
+    testScheduler();
+    printf("All tests passed!\n");
+    return 0;
+}